@@ -451,6 +451,20 @@ namespace af
        \ingroup set_func_intersect
     */
     AFAPI array setIntersect(const array &first, const array &second, const bool is_unique=false);
+
+#if AF_API_VERSION >= 37
+    /**
+       C++ Interface for checking the membership of elements in a set
+
+       \param[in] in is the input array
+       \param[in] set contains the values that are searched for
+       \return boolean array of the same size as \p in which is true where
+       the element of \p in is equal to an element of \p set
+
+       \ingroup set_func_isin
+    */
+    AFAPI array isIn(const array &in, const array &set);
+#endif
 }
 #endif
 
@@ -920,6 +934,21 @@ extern "C" {
     */
     AFAPI af_err af_set_intersect(af_array *out, const af_array first, const af_array second, const bool is_unique);
 
+#if AF_API_VERSION >= 37
+    /**
+       C Interface for checking the membership of elements in a set
+
+       \param[out] out (type b8) is true where the element of \p in is
+       equal to an element of \p set
+       \param[in] in is the input array
+       \param[in] set contains the values that are searched for
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup set_func_isin
+    */
+    AFAPI af_err af_isin(af_array *out, const af_array in, const af_array set);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -37,6 +37,11 @@ namespace af
               AF_MAT_TRANS, \ref AF_MAT_CTRANS \note This function is not supported
               in GFOR
 
+        \note <b> The following applies for integer matrix multiplication.</b>
+        \note \ref u8 products are returned as \ref u32, \ref s16 and \ref u16
+              products as \ref s64 and \ref u64. Other integer types keep their
+              type. Sums that do not fit in the output type wrap around.
+
         \note <b> The following applies for Sparse-Dense matrix multiplication.</b>
         \note This function can be used with one sparse input. The sparse input
               must always be the \p lhs and the dense matrix must be \p rhs.
@@ -46,6 +51,12 @@ namespace af
               \ref AF_MAT_CTRANS.
         \note \p optRhs can only be \ref AF_MAT_NONE.
 
+        \note <b> The following applies for Sparse-Sparse matrix multiplication.</b>
+        \note Both inputs must be of \ref AF_STORAGE_CSR format and the returned
+              array is sparse, in \ref AF_STORAGE_CSR format.
+        \note \p optLhs and \p optRhs can only be \ref AF_MAT_NONE.
+        \note This is only supported by the CPU backend.
+
         \ingroup blas_func_matmul
 
      */
@@ -53,6 +64,106 @@ namespace af
                        const matProp optLhs = AF_MAT_NONE,
                        const matProp optRhs = AF_MAT_NONE);
 
+#if AF_API_VERSION >= 37
+    /**
+        \brief Matrix multiply of two quantized arrays
+
+        Computes scale * (op(lhs) - lhsZero) * (op(rhs) - rhsZero), where the
+        products are summed exactly in 64 bit integers before they are scaled.
+
+        \code
+        // Dequantized scores of uint8 features and weights
+        array scores = matmulQuantized(features, weights, featureZero, weightZero,
+                                       featureScale * weightScale);
+        \endcode
+
+        \param[in] lhs The quantized array on the left hand side, of type
+                   \ref u8 or \ref s16
+        \param[in] rhs The quantized array on the right hand side, of the
+                   same type as \p lhs
+        \param[in] lhsZero The zero point of \p lhs
+        \param[in] rhsZero The zero point of \p rhs
+        \param[in] scale The scale of the result, usually the product of the
+                   scales of \p lhs and \p rhs
+        \param[in] optLhs Transpose left hand side before the function is performed
+        \param[in] optRhs Transpose right hand side before the function is performed
+        \return The \ref f32 result of the matrix multiplication
+
+        \note The zero points of \ref u8 arrays must be in [0, 255]
+        \note Batched multiplications are supported as in matmul
+
+        \ingroup blas_func_matmul
+     */
+    AFAPI array matmulQuantized(const array &lhs, const array &rhs,
+                                const int lhsZero, const int rhsZero,
+                                const double scale = 1.0,
+                                const matProp optLhs = AF_MAT_NONE,
+                                const matProp optRhs = AF_MAT_NONE);
+#endif
+
+#if AF_API_VERSION >= 37
+    /**
+        \brief Matrix multiply with a bias and an activation applied in a single pass
+
+        Computes act(alpha * op(lhs) * op(rhs) + bias). The bias and the
+        activation are applied together in a single pass over the result
+        instead of in separate passes.
+
+        \code
+        // Fully connected layer: samples along the rows, neurons along the columns
+        array hidden = matmulFused(input, weights, bias, AF_ACTIVATION_RELU);
+        \endcode
+
+        \param[in] lhs The array object on the left hand side
+        \param[in] rhs The array object on the right hand side
+        \param[in] bias An empty array, a vector of M elements added to every
+                   column, or a 1 x N vector added to every row of the output
+        \param[in] act The activation applied to every element of the output
+        \param[in] alpha The scale of the product
+        \param[in] optLhs Transpose left hand side before the function is performed
+        \param[in] optRhs Transpose right hand side before the function is performed
+        \return The result of the fused multiplication
+
+        \note Only \ref f32 and \ref f64 arrays are supported
+
+        \ingroup blas_func_matmul
+     */
+    AFAPI array matmulFused(const array &lhs, const array &rhs, const array &bias,
+                            const activation act = AF_ACTIVATION_NONE,
+                            const double alpha = 1.0,
+                            const matProp optLhs = AF_MAT_NONE,
+                            const matProp optRhs = AF_MAT_NONE);
+
+    /**
+        \brief Matrix multiply accumulated into an array, with a bias and an
+        activation applied in a single pass
+
+        Computes act(alpha * op(lhs) * op(rhs) + beta * c + bias).
+
+        \param[in] lhs The array object on the left hand side
+        \param[in] rhs The array object on the right hand side
+        \param[in] c The array accumulated into, of the size of the output
+        \param[in] beta The scale of \p c
+        \param[in] bias An empty array, a vector of M elements added to every
+                   column, or a 1 x N vector added to every row of the output
+        \param[in] act The activation applied to every element of the output
+        \param[in] alpha The scale of the product
+        \param[in] optLhs Transpose left hand side before the function is performed
+        \param[in] optRhs Transpose right hand side before the function is performed
+        \return The result of the fused multiplication
+
+        \note Only \ref f32 and \ref f64 arrays are supported
+
+        \ingroup blas_func_matmul
+     */
+    AFAPI array matmulFused(const array &lhs, const array &rhs,
+                            const array &c, const double beta, const array &bias,
+                            const activation act = AF_ACTIVATION_NONE,
+                            const double alpha = 1.0,
+                            const matProp optLhs = AF_MAT_NONE,
+                            const matProp optRhs = AF_MAT_NONE);
+#endif
+
     /**
        \brief Matrix multiply of two arrays
 
@@ -157,6 +268,11 @@ namespace af
         \note optLhs and optRhs can only be one of \ref AF_MAT_NONE or \ref AF_MAT_CONJ
         \note optLhs = AF_MAT_CONJ and optRhs = AF_MAT_NONE will run conjugate dot operation.
         \note This function is not supported in GFOR
+        \note When lhs and rhs have more than one column, the dot products of
+        matching columns are returned in an array of size 1 x N x P x Q. A side
+        with a single column, or a single matrix, is paired with all the
+        columns of the other side.
+        \note Row vectors are not supported and raise \ref AF_ERR_BATCH.
 
         \returns out = dot(lhs, rhs)
 
@@ -219,6 +335,12 @@ namespace af
         \param[in,out] in is the matrix to be transposed in place
         \param[in] conjugate If true a congugate transposition is performed
 
+        \note Rectangular matrices are supported, their first two dimensions
+        are swapped. The CPU backend permutes contiguous matrices of up to
+        2^20 elements in place, using one bit of scratch memory per element to
+        track the elements already moved. Larger matrices, and the matrices of
+        the other backends, are transposed through a temporary copy.
+
         \ingroup blas_func_transpose
     */
     AFAPI void transposeInPlace(array& in, const bool conjugate = false);
@@ -242,6 +364,11 @@ extern "C" {
 
         \return AF_SUCCESS if the process is successful.
 
+        \note <b> The following applies for integer matrix multiplication.</b>
+        \note \ref u8 products are returned as \ref u32, \ref s16 and \ref u16
+              products as \ref s64 and \ref u64. Other integer types keep their
+              type. Sums that do not fit in the output type wrap around.
+
         \note <b> The following applies for Sparse-Dense matrix multiplication.</b>
         \note This function can be used with one sparse input. The sparse input
               must always be the \p lhs and the dense matrix must be \p rhs.
@@ -251,12 +378,80 @@ extern "C" {
               \ref AF_MAT_CTRANS.
         \note \p optRhs can only be \ref AF_MAT_NONE.
 
+        \note <b> The following applies for Sparse-Sparse matrix multiplication.</b>
+        \note Both inputs must be of \ref AF_STORAGE_CSR format and the returned
+              array is sparse, in \ref AF_STORAGE_CSR format.
+        \note \p optLhs and \p optRhs can only be \ref AF_MAT_NONE.
+        \note This is only supported by the CPU backend.
+
         \ingroup blas_func_matmul
      */
     AFAPI af_err af_matmul( af_array *out ,
                             const af_array lhs, const af_array rhs,
                             const af_mat_prop optLhs, const af_mat_prop optRhs);
 
+#if AF_API_VERSION >= 37
+    /**
+        \brief Matrix multiply of two quantized \ref af_array
+
+        Computes scale * (op(lhs) - lhsZero) * (op(rhs) - rhsZero), where the
+        products are summed exactly in 64 bit integers before they are scaled.
+
+        \param[out] out Pointer to the \ref f32 output \ref af_array
+        \param[in] lhs The quantized array on the left hand side, of type
+                   \ref u8 or \ref s16
+        \param[in] rhs The quantized array on the right hand side, of the
+                   same type as \p lhs
+        \param[in] optLhs Transpose left hand side before the function is performed
+        \param[in] optRhs Transpose right hand side before the function is performed
+        \param[in] lhsZero The zero point of \p lhs
+        \param[in] rhsZero The zero point of \p rhs
+        \param[in] scale The scale of the result
+
+        \return AF_SUCCESS if the process is successful.
+
+        \note The zero points of \ref u8 arrays must be in [0, 255]
+
+        \ingroup blas_func_matmul
+     */
+    AFAPI af_err af_matmul_quantized(af_array *out,
+                                     const af_array lhs, const af_array rhs,
+                                     const af_mat_prop optLhs, const af_mat_prop optRhs,
+                                     const int lhsZero, const int rhsZero,
+                                     const double scale);
+#endif
+
+#if AF_API_VERSION >= 37
+    /**
+        \brief Matrix multiply with a bias and an activation applied in a single pass
+
+        Computes act(alpha * op(lhs) * op(rhs) + beta * c + bias).
+
+        \param[out] out Pointer to the output \ref af_array
+        \param[in] lhs A 2D matrix \ref af_array object
+        \param[in] rhs A 2D matrix \ref af_array object
+        \param[in] optLhs Transpose left hand side before the function is performed
+        \param[in] optRhs Transpose right hand side before the function is performed
+        \param[in] alpha The scale of the product
+        \param[in] c The array accumulated into, of the size of the output, or 0
+        \param[in] beta The scale of \p c
+        \param[in] bias 0, a vector of M elements added to every column, or
+                   a 1 x N vector added to every row of the output
+        \param[in] act The activation applied to every element of the output
+
+        \return AF_SUCCESS if the process is successful.
+
+        \note Only \ref f32 and \ref f64 arrays are supported
+
+        \ingroup blas_func_matmul
+     */
+    AFAPI af_err af_matmul_fused(af_array *out,
+                                 const af_array lhs, const af_array rhs,
+                                 const af_mat_prop optLhs, const af_mat_prop optRhs,
+                                 const double alpha, const af_array c, const double beta,
+                                 const af_array bias, const af_activation act);
+#endif
+
 
     /**
         Scalar dot product between two vectors.  Also referred to as the inner
@@ -276,6 +471,9 @@ extern "C" {
         \param[in] optRhs Options for rhs. Currently only \ref AF_MAT_NONE and AF_MAT_CONJ are supported
         \return AF_SUCCESS if the process is successful.
 
+        \note When lhs and rhs have more than one column, out holds the dot
+        products of matching columns, see \ref dot.
+
         \ingroup blas_func_dot
     */
     AFAPI af_err af_dot(af_array *out,
@@ -326,6 +524,12 @@ extern "C" {
         \param[in,out] in is the matrix to be transposed in place
         \param[in] conjugate If true a congugate transposition is performed
 
+        \note Rectangular matrices are supported, their first two dimensions
+        are swapped. The CPU backend permutes contiguous matrices of up to
+        2^20 elements in place, using one bit of scratch memory per element to
+        track the elements already moved. Larger matrices, and the matrices of
+        the other backends, are transposed through a temporary copy.
+
         \ingroup blas_func_transpose
     */
     AFAPI af_err af_transpose_inplace(af_array in, const bool conjugate);
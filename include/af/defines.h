@@ -337,6 +337,9 @@ typedef enum {
     AF_MAT_ORTHOG     = 2048, ///< Matrix is orthogonal
     AF_MAT_TRI_DIAG   = 4096, ///< Matrix is tri diagonal
     AF_MAT_BLOCK_DIAG = 8192  ///< Matrix is block diagonal
+#if AF_API_VERSION >= 37
+    , AF_MAT_MIXED_PRECISION = 16384 ///< Factorize in single precision and refine the solution to double precision
+#endif
 } af_mat_prop;
 
 typedef enum {
@@ -510,6 +513,23 @@ typedef enum {
     AF_INVERSE_DECONV_TIKHONOV       = 1,        ///< Tikhonov Inverse deconvolution
     AF_INVERSE_DECONV_DEFAULT        = 0         ///< Default is Tikhonov deconvolution
 } af_inverse_deconv_algo;
+
+typedef enum {
+    AF_STAT_MIN       = 1,   ///< Minimum value
+    AF_STAT_MAX       = 2,   ///< Maximum value
+    AF_STAT_SUM       = 4,   ///< Sum of the values
+    AF_STAT_MEAN      = 8,   ///< Mean of the values
+    AF_STAT_VAR       = 16,  ///< Variance of the values
+    AF_STAT_NAN_COUNT = 32,  ///< Number of NaN values
+    AF_STAT_ALL       = 63   ///< All of the above
+} af_stat_type;
+
+typedef enum {
+    AF_ACTIVATION_NONE    = 0,  ///< Identity
+    AF_ACTIVATION_RELU    = 1,  ///< max(x, 0)
+    AF_ACTIVATION_SIGMOID = 2,  ///< 1 / (1 + exp(-x))
+    AF_ACTIVATION_TANH    = 3   ///< tanh(x)
+} af_activation;
 #endif
 
 #ifdef __cplusplus
@@ -565,6 +585,8 @@ namespace af
     typedef af_var_bias varBias;
     typedef af_iterative_deconv_algo iterativeDeconvAlgo;
     typedef af_inverse_deconv_algo inverseDeconvAlgo;
+    typedef af_stat_type statType;
+    typedef af_activation activation;
 #endif
 }
 
@@ -325,6 +325,44 @@ AFAPI array histogram(const array &in, const unsigned nbins, const double minval
  */
 AFAPI array histogram(const array &in, const unsigned nbins);
 
+#if AF_API_VERSION >= 37
+/**
+   C++ Interface for joint histogram of two arrays
+
+   \param[in]  x is the input array whose values are binned along the first dimension
+   \param[in]  y is the input array whose values are binned along the second dimension
+   \param[in]  xbins Number of bins to populate between xmin and xmax
+   \param[in]  ybins Number of bins to populate between ymin and ymax
+   \param[in]  xmin minimum bin value of \p x (accumulates -inf to xmin)
+   \param[in]  xmax maximum bin value of \p x (accumulates xmax to +inf)
+   \param[in]  ymin minimum bin value of \p y (accumulates -inf to ymin)
+   \param[in]  ymax maximum bin value of \p y (accumulates ymax to +inf)
+   \return     xbins x ybins histogram array of type u32
+
+   \note \p x and \p y must have the same number of elements.
+
+   \ingroup image_func_histogram
+ */
+AFAPI array histogram2d(const array &x, const array &y,
+                        const unsigned xbins, const unsigned ybins,
+                        const double xmin, const double xmax,
+                        const double ymin, const double ymax);
+
+/**
+   C++ Interface for joint histogram of two arrays
+
+   \param[in]  x is the input array whose values are binned along the first dimension
+   \param[in]  y is the input array whose values are binned along the second dimension
+   \param[in]  xbins Number of bins to populate between min and max of \p x
+   \param[in]  ybins Number of bins to populate between min and max of \p y
+   \return     xbins x ybins histogram array of type u32
+
+   \ingroup image_func_histogram
+ */
+AFAPI array histogram2d(const array &x, const array &y,
+                        const unsigned xbins, const unsigned ybins);
+#endif
+
 /**
     C++ Interface for mean shift
 
@@ -1088,6 +1126,30 @@ extern "C" {
      */
     AFAPI af_err af_histogram(af_array *out, const af_array in, const unsigned nbins, const double minval, const double maxval);
 
+#if AF_API_VERSION >= 37
+    /**
+       C Interface for joint histogram of two arrays
+
+       \param[out] out (type u32) is the xbins x ybins histogram of x and y
+       \param[in]  x is the input array whose values are binned along the first dimension
+       \param[in]  y is the input array whose values are binned along the second dimension
+       \param[in]  xbins Number of bins to populate between xmin and xmax
+       \param[in]  ybins Number of bins to populate between ymin and ymax
+       \param[in]  xmin minimum bin value of \p x (accumulates -inf to xmin)
+       \param[in]  xmax maximum bin value of \p x (accumulates xmax to +inf)
+       \param[in]  ymin minimum bin value of \p y (accumulates -inf to ymin)
+       \param[in]  ymax maximum bin value of \p y (accumulates ymax to +inf)
+       \return     \ref AF_SUCCESS if the histogram is successfully created,
+       otherwise an appropriate error code is returned.
+
+       \ingroup image_func_histogram
+     */
+    AFAPI af_err af_histogram2d(af_array *out, const af_array x, const af_array y,
+                                const unsigned xbins, const unsigned ybins,
+                                const double xmin, const double xmax,
+                                const double ymin, const double ymax);
+#endif
+
     /**
         C Interface for image dilation (max filter)
 
@@ -168,6 +168,9 @@ namespace af
        \returns \p x, the matrix of unknown variables
 
        \note \p options needs to be one of \ref AF_MAT_NONE, \ref AF_MAT_LOWER or \ref AF_MAT_UPPER
+       \note \ref AF_MAT_MIXED_PRECISION can be passed for square double precision
+             systems larger than 16 x 16 and is ignored otherwise, see
+             \ref lapack_solve_func_gen
        \note This function is not supported in GFOR
 
        \ingroup lapack_solve_func_gen
@@ -401,6 +404,9 @@ extern "C" {
        \ingroup lapack_solve_func_gen
 
        \note \p options needs to be one of \ref AF_MAT_NONE, \ref AF_MAT_LOWER or \ref AF_MAT_UPPER
+       \note \ref AF_MAT_MIXED_PRECISION can be passed for square double precision
+             systems larger than 16 x 16 and is ignored otherwise, see
+             \ref lapack_solve_func_gen
     */
     AFAPI af_err af_solve(af_array *x, const af_array a, const af_array b,
                           const af_mat_prop options);
@@ -10,6 +10,11 @@
 #pragma once
 #include <af/defines.h>
 
+#if AF_API_VERSION >= 37
+typedef void * af_quantile_sketch;
+typedef void * af_distinct_sketch;
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -113,6 +118,39 @@ AFAPI array stdev(const array& in, const dim_t dim=-1);
 */
 AFAPI array cov(const array& X, const array& Y, const bool isbiased=false);
 
+#if AF_API_VERSION >= 37
+/**
+   C++ Interface for the covariance matrix
+
+   \param[in] X is an N x P matrix holding N observations of P variables
+   \param[in] bias is the type of bias used for the covariances
+   \param[in] pairwise specifies if every pair of variables only uses the
+              observations where both are not NaN
+   \return    the P x P covariance matrix of the columns of \p X
+
+   \ingroup stat_func_cov
+*/
+AFAPI array covMatrix(const array& X, const varBias bias=AF_VARIANCE_SAMPLE,
+                      const bool pairwise=false);
+
+/**
+   C++ Interface for the weighted covariance matrix
+
+   \param[in] X is an N x P matrix holding N observations of P variables
+   \param[in] weights is a vector of N non-negative frequency weights of the
+              observations
+   \param[in] bias is the type of bias used for the covariances
+   \param[in] pairwise specifies if every pair of variables only uses the
+              observations where both are not NaN
+   \return    the P x P covariance matrix of the columns of \p X
+
+   \ingroup stat_func_cov
+*/
+AFAPI array covMatrix(const array& X, const array& weights,
+                      const varBias bias=AF_VARIANCE_SAMPLE,
+                      const bool pairwise=false);
+#endif
+
 /**
    C++ Interface for median
 
@@ -126,6 +164,154 @@ AFAPI array cov(const array& X, const array& Y, const bool isbiased=false);
 */
 AFAPI array median(const array& in, const dim_t dim=-1);
 
+#if AF_API_VERSION >= 37
+/**
+   C++ Interface for quantiles
+
+   \param[in] in is the input array
+   \param[in] probs is a vector of probabilities in the range [0, 1]
+   \param[in] dim the dimension along which the quantiles are extracted
+   \return    the quantiles of the input array along dimension \p dim. The
+              output has as many elements along \p dim as \p probs.
+
+   \ingroup stat_func_quantile
+
+   \note \p dim is -1 by default. -1 denotes the first non-singleton dimension.
+   \note Quantiles are linearly interpolated between the closest order
+         statistics, so a probability of 0.5 returns the median.
+*/
+AFAPI array quantile(const array& in, const array& probs, const dim_t dim=-1);
+#endif
+
+#if AF_API_VERSION >= 37
+/**
+   C++ Interface for computing several statistics in a single pass
+
+   \param[in] in is the input array
+   \param[in] stats is a combination of \ref af_stat_type flags selecting the
+              statistics to compute
+   \param[in] bias is the type of bias used for the variance
+   \param[in] dim the dimension along which the statistics are computed
+   \return    the selected statistics of the input array along dimension
+              \p dim, one element along \p dim for every statistic in the
+              order of their flags
+
+   \ingroup stat_func_describe
+
+   \note \p dim is -1 by default. -1 denotes the first non-singleton dimension.
+   \note NaN values are skipped by all the statistics except
+         \ref AF_STAT_NAN_COUNT.
+*/
+AFAPI array describe(const array& in, const unsigned stats=AF_STAT_ALL,
+                     const varBias bias=AF_VARIANCE_POPULATION,
+                     const dim_t dim=-1);
+
+/**
+   C++ Interface for computing several statistics of all the elements in a
+   single pass
+
+   \param[out] out is a host array receiving the selected statistics in the
+               order of their flags. It must hold one element for every
+               selected statistic.
+   \param[in] in is the input array
+   \param[in] stats is a combination of \ref af_stat_type flags selecting the
+              statistics to compute
+   \param[in] bias is the type of bias used for the variance
+
+   \ingroup stat_func_describe
+
+   \note NaN values are skipped by all the statistics except
+         \ref AF_STAT_NAN_COUNT.
+*/
+AFAPI void describe(double *out, const array& in,
+                    const unsigned stats=AF_STAT_ALL,
+                    const varBias bias=AF_VARIANCE_POPULATION);
+#endif
+
+#if AF_API_VERSION >= 37
+/**
+   C++ Interface for the moving sum
+
+   \param[in] in is the input array
+   \param[in] window is the number of elements in every window
+   \param[in] stride is the distance between the starts of consecutive windows
+   \param[in] dim the dimension along which the windows are taken
+   \return    the sum of every window of \p in along dimension \p dim
+
+   \ingroup stat_func_moving
+
+   \note \p dim is -1 by default. -1 denotes the first non-singleton dimension.
+*/
+AFAPI array movingSum(const array& in, const dim_t window, const dim_t stride=1,
+                      const dim_t dim=-1);
+
+/**
+   C++ Interface for the moving mean
+
+   \param[in] in is the input array
+   \param[in] window is the number of elements in every window
+   \param[in] stride is the distance between the starts of consecutive windows
+   \param[in] dim the dimension along which the windows are taken
+   \return    the mean of every window of \p in along dimension \p dim
+
+   \ingroup stat_func_moving
+
+   \note \p dim is -1 by default. -1 denotes the first non-singleton dimension.
+*/
+AFAPI array movingMean(const array& in, const dim_t window, const dim_t stride=1,
+                       const dim_t dim=-1);
+
+/**
+   C++ Interface for the moving minimum
+
+   \param[in] in is the input array
+   \param[in] window is the number of elements in every window
+   \param[in] stride is the distance between the starts of consecutive windows
+   \param[in] dim the dimension along which the windows are taken
+   \return    the minimum of every window of \p in along dimension \p dim
+
+   \ingroup stat_func_moving
+
+   \note \p dim is -1 by default. -1 denotes the first non-singleton dimension.
+*/
+AFAPI array movingMin(const array& in, const dim_t window, const dim_t stride=1,
+                      const dim_t dim=-1);
+
+/**
+   C++ Interface for the moving maximum
+
+   \param[in] in is the input array
+   \param[in] window is the number of elements in every window
+   \param[in] stride is the distance between the starts of consecutive windows
+   \param[in] dim the dimension along which the windows are taken
+   \return    the maximum of every window of \p in along dimension \p dim
+
+   \ingroup stat_func_moving
+
+   \note \p dim is -1 by default. -1 denotes the first non-singleton dimension.
+*/
+AFAPI array movingMax(const array& in, const dim_t window, const dim_t stride=1,
+                      const dim_t dim=-1);
+
+/**
+   C++ Interface for the moving variance
+
+   \param[in] in is the input array
+   \param[in] window is the number of elements in every window
+   \param[in] stride is the distance between the starts of consecutive windows
+   \param[in] bias is the type of bias used for the variance
+   \param[in] dim the dimension along which the windows are taken
+   \return    the variance of every window of \p in along dimension \p dim
+
+   \ingroup stat_func_moving
+
+   \note \p dim is -1 by default. -1 denotes the first non-singleton dimension.
+*/
+AFAPI array movingVar(const array& in, const dim_t window, const dim_t stride=1,
+                      const varBias bias=AF_VARIANCE_POPULATION,
+                      const dim_t dim=-1);
+#endif
+
 /**
    C++ Interface for mean of all elements
 
@@ -209,6 +395,37 @@ AFAPI T median(const array& in);
 template<typename T>
 AFAPI T corrcoef(const array& X, const array& Y);
 
+#if AF_API_VERSION >= 37
+/**
+   C++ Interface for the correlation coefficient matrix
+
+   \param[in] X is an N x P matrix holding N observations of P variables
+   \param[in] pairwise specifies if every pair of variables only uses the
+              observations where both are not NaN
+   \return    the P x P matrix of the Pearson correlation coefficients of
+              the columns of \p X
+
+   \ingroup stat_func_corrcoef
+*/
+AFAPI array corrcoefMatrix(const array& X, const bool pairwise=false);
+
+/**
+   C++ Interface for the weighted correlation coefficient matrix
+
+   \param[in] X is an N x P matrix holding N observations of P variables
+   \param[in] weights is a vector of N non-negative frequency weights of the
+              observations
+   \param[in] pairwise specifies if every pair of variables only uses the
+              observations where both are not NaN
+   \return    the P x P matrix of the Pearson correlation coefficients of
+              the columns of \p X
+
+   \ingroup stat_func_corrcoef
+*/
+AFAPI array corrcoefMatrix(const array& X, const array& weights,
+                           const bool pairwise=false);
+#endif
+
 #if AF_API_VERSION >= 36
 /**
    C++ Interface for finding top k elements along a given dimension
@@ -232,6 +449,144 @@ AFAPI void topk(array &values, array &indices, const array& in, const int k,
                 const int dim = -1, const topkFunction order = AF_TOPK_MAX);
 #endif
 
+#if AF_API_VERSION >= 37
+///
+/// \brief A mergeable sketch of the quantiles of a stream of values
+///
+/// \ingroup stat_func_sketch
+///
+class AFAPI quantileSketch
+{
+    af_quantile_sketch sketch;
+
+public:
+    /**
+       Creates an empty quantile sketch
+
+       \param[in] k is the accuracy parameter of the sketch. The rank error
+                  of the quantiles is inversely proportional to \p k.
+    */
+    explicit quantileSketch(const unsigned k = 200);
+
+    /**
+       Creates a copy of a quantile sketch
+
+       \param[in] other is the sketch to copy
+    */
+    quantileSketch(const quantileSketch& other);
+
+    /**
+       Takes ownership of a \ref af_quantile_sketch handle
+
+       \param[in] sketch is the handle
+    */
+    quantileSketch(af_quantile_sketch sketch);
+
+    ~quantileSketch();
+
+    quantileSketch& operator= (const quantileSketch& other);
+
+    /**
+       Inserts all the elements of an array. NaN values are skipped.
+
+       \param[in] in is the input array
+    */
+    void update(const array& in);
+
+    /**
+       Adds the values summarized by another sketch to this one
+
+       \param[in] other is the sketch to merge
+    */
+    void merge(const quantileSketch& other);
+
+    /**
+       \return the number of values inserted in the sketch
+    */
+    unsigned long long count() const;
+
+    /**
+       \param[in] prob is the normalized rank of the quantile, in [0, 1]
+       \return    the estimated quantile
+    */
+    double quantile(const double prob) const;
+
+    /**
+       \param[out] out will contain the estimated quantiles
+       \param[in] probs are the normalized ranks of the quantiles, in [0, 1]
+       \param[in] nprobs is the number of quantiles
+    */
+    void quantiles(double *out, const double *probs, const unsigned nprobs) const;
+
+    /**
+       \return the handle of the sketch
+    */
+    af_quantile_sketch get() const;
+};
+
+///
+/// \brief A mergeable sketch of the number of distinct values in a stream
+///
+/// \ingroup stat_func_sketch
+///
+class AFAPI distinctSketch
+{
+    af_distinct_sketch sketch;
+
+public:
+    /**
+       Creates an empty distinct count sketch
+
+       \param[in] precision is the base 2 logarithm of the number of
+                  registers, between 4 and 18. The relative standard error of
+                  the estimate is 1.04 / sqrt(2^precision).
+    */
+    explicit distinctSketch(const unsigned precision = 14);
+
+    /**
+       Creates a copy of a distinct count sketch
+
+       \param[in] other is the sketch to copy
+    */
+    distinctSketch(const distinctSketch& other);
+
+    /**
+       Takes ownership of a \ref af_distinct_sketch handle
+
+       \param[in] sketch is the handle
+    */
+    distinctSketch(af_distinct_sketch sketch);
+
+    ~distinctSketch();
+
+    distinctSketch& operator= (const distinctSketch& other);
+
+    /**
+       Inserts all the elements of an array. NaN values are skipped.
+
+       \param[in] in is the input array
+    */
+    void update(const array& in);
+
+    /**
+       Adds the values summarized by another sketch to this one
+
+       \param[in] other is the sketch to merge. It must have the same precision.
+    */
+    void merge(const distinctSketch& other);
+
+    /**
+       \return the estimated number of distinct values inserted in the sketch
+    */
+    double estimate() const;
+
+    /**
+       \return the handle of the sketch
+    */
+    af_distinct_sketch get() const;
+};
+#endif
+
 }
 #endif
 
@@ -341,6 +696,27 @@ AFAPI af_err af_stdev(af_array *out, const af_array in, const dim_t dim);
 */
 AFAPI af_err af_cov(af_array* out, const af_array X, const af_array Y, const bool isbiased);
 
+#if AF_API_VERSION >= 37
+/**
+   C Interface for the covariance matrix
+
+   \param[out] out will contain the P x P covariance matrix of the columns of
+               \p X
+   \param[in] X is an N x P matrix holding N observations of P variables
+   \param[in] weights is a vector of N non-negative frequency weights of the
+              observations, or 0 for equal weights
+   \param[in] bias is the type of bias used for the covariances
+   \param[in] pairwise specifies if every pair of variables only uses the
+              observations where both are not NaN
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_cov
+*/
+AFAPI af_err af_cov_matrix(af_array *out, const af_array X, const af_array weights,
+                           const af_var_bias bias, const bool pairwise);
+#endif
+
 /**
    C Interface for median
 
@@ -354,6 +730,153 @@ AFAPI af_err af_cov(af_array* out, const af_array X, const af_array Y, const boo
 */
 AFAPI af_err af_median(af_array* out, const af_array in, const dim_t dim);
 
+#if AF_API_VERSION >= 37
+/**
+   C Interface for quantiles
+
+   \param[out] out will contain the quantiles of the input array along
+               dimension \p dim, one for every element of \p probs
+   \param[in] in is the input array
+   \param[in] probs is a floating point vector of probabilities in the range
+              [0, 1]
+   \param[in] dim the dimension along which the quantiles are extracted
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_quantile
+*/
+AFAPI af_err af_quantile(af_array* out, const af_array in, const af_array probs,
+                         const dim_t dim);
+#endif
+
+#if AF_API_VERSION >= 37
+/**
+   C Interface for computing several statistics in a single pass
+
+   \param[out] out will contain the selected statistics of the input array
+               along dimension \p dim, one element along \p dim for every
+               statistic in the order of their flags
+   \param[in] in is the input array
+   \param[in] stats is a combination of \ref af_stat_type flags selecting the
+              statistics to compute
+   \param[in] bias is the type of bias used for the variance
+   \param[in] dim the dimension along which the statistics are computed
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_describe
+*/
+AFAPI af_err af_describe(af_array *out, const af_array in, const unsigned stats,
+                         const af_var_bias bias, const dim_t dim);
+
+/**
+   C Interface for computing several statistics of all the elements in a
+   single pass
+
+   \param[out] out is a host array receiving the selected statistics in the
+               order of their flags. It must hold one element for every
+               selected statistic.
+   \param[in] in is the input array
+   \param[in] stats is a combination of \ref af_stat_type flags selecting the
+              statistics to compute
+   \param[in] bias is the type of bias used for the variance
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_describe
+*/
+AFAPI af_err af_describe_all(double *out, const af_array in, const unsigned stats,
+                             const af_var_bias bias);
+#endif
+
+#if AF_API_VERSION >= 37
+/**
+   C Interface for the moving sum
+
+   \param[out] out will contain the sum of every window of \p in along
+               dimension \p dim
+   \param[in] in is the input array
+   \param[in] window is the number of elements in every window
+   \param[in] stride is the distance between the starts of consecutive windows
+   \param[in] dim the dimension along which the windows are taken
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_moving
+*/
+AFAPI af_err af_moving_sum(af_array *out, const af_array in, const dim_t window,
+                           const dim_t stride, const dim_t dim);
+
+/**
+   C Interface for the moving mean
+
+   \param[out] out will contain the mean of every window of \p in along
+               dimension \p dim
+   \param[in] in is the input array
+   \param[in] window is the number of elements in every window
+   \param[in] stride is the distance between the starts of consecutive windows
+   \param[in] dim the dimension along which the windows are taken
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_moving
+*/
+AFAPI af_err af_moving_mean(af_array *out, const af_array in, const dim_t window,
+                            const dim_t stride, const dim_t dim);
+
+/**
+   C Interface for the moving minimum
+
+   \param[out] out will contain the minimum of every window of \p in along
+               dimension \p dim
+   \param[in] in is the input array
+   \param[in] window is the number of elements in every window
+   \param[in] stride is the distance between the starts of consecutive windows
+   \param[in] dim the dimension along which the windows are taken
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_moving
+*/
+AFAPI af_err af_moving_min(af_array *out, const af_array in, const dim_t window,
+                           const dim_t stride, const dim_t dim);
+
+/**
+   C Interface for the moving maximum
+
+   \param[out] out will contain the maximum of every window of \p in along
+               dimension \p dim
+   \param[in] in is the input array
+   \param[in] window is the number of elements in every window
+   \param[in] stride is the distance between the starts of consecutive windows
+   \param[in] dim the dimension along which the windows are taken
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_moving
+*/
+AFAPI af_err af_moving_max(af_array *out, const af_array in, const dim_t window,
+                           const dim_t stride, const dim_t dim);
+
+/**
+   C Interface for the moving variance
+
+   \param[out] out will contain the variance of every window of \p in along
+               dimension \p dim
+   \param[in] in is the input array
+   \param[in] window is the number of elements in every window
+   \param[in] stride is the distance between the starts of consecutive windows
+   \param[in] bias is the type of bias used for the variance
+   \param[in] dim the dimension along which the windows are taken
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_moving
+*/
+AFAPI af_err af_moving_var(af_array *out, const af_array in, const dim_t window,
+                           const dim_t stride, const af_var_bias bias, const dim_t dim);
+#endif
+
 /**
    C Interface for mean of all elements
 
@@ -452,6 +975,26 @@ AFAPI af_err af_median_all(double *realVal, double *imagVal, const af_array in);
 */
 AFAPI af_err af_corrcoef(double *realVal, double *imagVal, const af_array X, const af_array Y);
 
+#if AF_API_VERSION >= 37
+/**
+   C Interface for the correlation coefficient matrix
+
+   \param[out] out will contain the P x P matrix of the Pearson correlation
+               coefficients of the columns of \p X
+   \param[in] X is an N x P matrix holding N observations of P variables
+   \param[in] weights is a vector of N non-negative frequency weights of the
+              observations, or 0 for equal weights
+   \param[in] pairwise specifies if every pair of variables only uses the
+              observations where both are not NaN
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_corrcoef
+*/
+AFAPI af_err af_corrcoef_matrix(af_array *out, const af_array X, const af_array weights,
+                                const bool pairwise);
+#endif
+
 #if AF_API_VERSION >= 36
 /**
    C Interface for finding top k elements along a given dimension
@@ -475,6 +1018,174 @@ AFAPI af_err af_topk(af_array *values, af_array *indices, const af_array in,
                      const int k, const int dim, const af_topk_function order);
 #endif
 
+#if AF_API_VERSION >= 37
+/**
+   C Interface to create an empty quantile sketch
+
+   \param[out] sketch will contain the handle of the new sketch
+   \param[in] k is the accuracy parameter of the sketch. The rank error of
+              the quantiles is inversely proportional to \p k.
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_create_quantile_sketch(af_quantile_sketch *sketch, const unsigned k);
+
+/**
+   C Interface to copy a quantile sketch
+
+   \param[out] out will contain the handle of the copy
+   \param[in] sketch is the sketch to copy
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_retain_quantile_sketch(af_quantile_sketch *out,
+                                       const af_quantile_sketch sketch);
+
+/**
+   C Interface to insert all the elements of an array in a quantile sketch
+
+   \param[in] sketch is the sketch to update
+   \param[in] in is the input array. NaN values are skipped.
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_quantile_sketch_update(af_quantile_sketch sketch, const af_array in);
+
+/**
+   C Interface to merge a quantile sketch into another
+
+   \param[in] sketch is the sketch to update
+   \param[in] other is the sketch whose values are added to \p sketch
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_quantile_sketch_merge(af_quantile_sketch sketch,
+                                      const af_quantile_sketch other);
+
+/**
+   C Interface for the number of values inserted in a quantile sketch
+
+   \param[out] count will contain the number of values
+   \param[in] sketch is the sketch
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_quantile_sketch_get_count(unsigned long long *count,
+                                          const af_quantile_sketch sketch);
+
+/**
+   C Interface for the quantiles estimated by a quantile sketch
+
+   \param[out] out will contain the \p nprobs quantiles. The quantiles of an
+               empty sketch are NaN.
+   \param[in] sketch is the sketch
+   \param[in] probs are the normalized ranks of the quantiles, in [0, 1]
+   \param[in] nprobs is the number of quantiles
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_quantile_sketch_get_quantiles(double *out, const af_quantile_sketch sketch,
+                                              const double *probs, const unsigned nprobs);
+
+/**
+   C Interface to release a quantile sketch
+
+   \param[in] sketch is the sketch to release
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_release_quantile_sketch(af_quantile_sketch sketch);
+
+/**
+   C Interface to create an empty distinct count sketch
+
+   \param[out] sketch will contain the handle of the new sketch
+   \param[in] precision is the base 2 logarithm of the number of registers,
+              between 4 and 18
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_create_distinct_sketch(af_distinct_sketch *sketch, const unsigned precision);
+
+/**
+   C Interface to copy a distinct count sketch
+
+   \param[out] out will contain the handle of the copy
+   \param[in] sketch is the sketch to copy
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_retain_distinct_sketch(af_distinct_sketch *out,
+                                       const af_distinct_sketch sketch);
+
+/**
+   C Interface to insert all the elements of an array in a distinct count sketch
+
+   \param[in] sketch is the sketch to update
+   \param[in] in is the input array. NaN values are skipped.
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_distinct_sketch_update(af_distinct_sketch sketch, const af_array in);
+
+/**
+   C Interface to merge a distinct count sketch into another
+
+   \param[in] sketch is the sketch to update
+   \param[in] other is the sketch whose values are added to \p sketch. It
+              must have the same precision.
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_distinct_sketch_merge(af_distinct_sketch sketch,
+                                      const af_distinct_sketch other);
+
+/**
+   C Interface for the number of distinct values estimated by a sketch
+
+   \param[out] out will contain the estimate
+   \param[in] sketch is the sketch
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_distinct_sketch_get_estimate(double *out, const af_distinct_sketch sketch);
+
+/**
+   C Interface to release a distinct count sketch
+
+   \param[in] sketch is the sketch to release
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_sketch
+*/
+AFAPI af_err af_release_distinct_sketch(af_distinct_sketch sketch);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,6 +18,10 @@
 #include <sparse_blas.hpp>
 #include <common/err_common.hpp>
 #include <backend.hpp>
+#include <arith.hpp>
+#include <cast.hpp>
+#include <copy.hpp>
+#include <math.hpp>
 
 template<typename T>
 static inline af_array sparseMatmul(const af_array lhs, const af_array rhs,
@@ -27,6 +31,14 @@ static inline af_array sparseMatmul(const af_array lhs, const af_array rhs,
                      optLhs, optRhs));
 }
 
+template<typename T>
+static inline af_array sparseSparseMatmul(const af_array lhs, const af_array rhs,
+                                          af_mat_prop optLhs, af_mat_prop optRhs)
+{
+    return getHandle(detail::matmul<T>(getSparseArray<T>(lhs), getSparseArray<T>(rhs),
+                     optLhs, optRhs));
+}
+
 template<typename T>
 static inline af_array matmul(const af_array lhs, const af_array rhs,
                     af_mat_prop optLhs, af_mat_prop optRhs)
@@ -34,6 +46,52 @@ static inline af_array matmul(const af_array lhs, const af_array rhs,
     return getHandle(detail::matmul<T>(getArray<T>(lhs), getArray<T>(rhs), optLhs, optRhs));
 }
 
+template<typename Ti, typename To>
+static inline af_array integerMatmul(const af_array lhs, const af_array rhs,
+                                     af_mat_prop optLhs, af_mat_prop optRhs,
+                                     const int lhsZero, const int rhsZero)
+{
+    return getHandle(detail::integerMatmul<Ti, To>(getArray<Ti>(lhs), getArray<Ti>(rhs),
+                                                   optLhs, optRhs, lhsZero, rhsZero));
+}
+
+template<typename Ti>
+static inline af_array quantizedMatmul(const af_array lhs, const af_array rhs,
+                                       af_mat_prop optLhs, af_mat_prop optRhs,
+                                       const int lhsZero, const int rhsZero,
+                                       const double scale)
+{
+    using namespace detail;
+    // Accumulated in 64 bits, as the products of s16 values minus their zero
+    // points overflow 32 bits
+    Array<float> acc = cast<float>(integerMatmul<Ti, intl>(getArray<Ti>(lhs), getArray<Ti>(rhs),
+                                                           optLhs, optRhs, lhsZero, rhsZero));
+    Array<float> scl = createValueArray<float>(acc.dims(), scalar<float>(scale));
+    return getHandle(arithOp<float, af_mul_t>(acc, scl, acc.dims()));
+}
+
+template<typename T>
+static inline af_array fusedMatmul(const af_array lhs, const af_array rhs,
+                                   af_mat_prop optLhs, af_mat_prop optRhs,
+                                   const double alpha, const af_array c, const double beta,
+                                   const af_array bias, const af_activation act,
+                                   const af::dim4 &oDims)
+{
+    using namespace detail;
+    // The output is initialized with c when it is accumulated into
+    Array<T> out = (c != 0 && beta != 0) ? copyArray<T>(getArray<T>(c))
+                                         : createEmptyArray<T>(oDims);
+    // The backends read the bias with unit stride
+    Array<T> b = createEmptyArray<T>(dim4(0));
+    if (bias != 0) {
+        b = getArray<T>(bias);
+        if (!b.isLinear()) b = copyArray<T>(b);
+    }
+    gemm<T>(out, optLhs, optRhs, scalar<T>(alpha), getArray<T>(lhs), getArray<T>(rhs),
+            (c != 0) ? scalar<T>(beta) : scalar<T>(0), b, act);
+    return getHandle(out);
+}
+
 template<typename T>
 static inline af_array dot(const af_array lhs, const af_array rhs,
                     af_mat_prop optLhs, af_mat_prop optRhs)
@@ -41,6 +99,41 @@ static inline af_array dot(const af_array lhs, const af_array rhs,
     return getHandle(detail::dot<T>(getArray<T>(lhs), getArray<T>(rhs), optLhs, optRhs));
 }
 
+// Checks the options and sizes of a dense matrix multiply
+static void checkMatmul(const ArrayInfo &lhsInfo, const ArrayInfo &rhsInfo,
+                        const af_mat_prop optLhs, const af_mat_prop optRhs)
+{
+    if (!(optLhs == AF_MAT_NONE ||
+          optLhs == AF_MAT_TRANS ||
+          optLhs == AF_MAT_CTRANS)) {
+        AF_ERROR("Using this property is not yet supported in matmul", AF_ERR_NOT_SUPPORTED);
+    }
+
+    if (!(optRhs == AF_MAT_NONE ||
+          optRhs == AF_MAT_TRANS ||
+          optRhs == AF_MAT_CTRANS)) {
+        AF_ERROR("Using this property is not yet supported in matmul", AF_ERR_NOT_SUPPORTED);
+    }
+
+    af::dim4 lDims = lhsInfo.dims();
+    af::dim4 rDims = rhsInfo.dims();
+
+    if (lDims.ndims() > 2 && rDims.ndims() > 2) {
+        DIM_ASSERT(1, lDims.ndims() == rDims.ndims());
+        if (lDims[2] != rDims[2] && lDims[2] != 1 && rDims[2] != 1) {
+            AF_ERROR("Batch size mismatch along dimension 2", AF_ERR_BATCH);
+        }
+        if (lDims[3] != rDims[3] && lDims[3] != 1 && rDims[3] != 1) {
+            AF_ERROR("Batch size mismatch along dimension 3", AF_ERR_BATCH);
+        }
+    }
+
+    int aColDim = (optLhs == AF_MAT_NONE) ? 1 : 0;
+    int bRowDim = (optRhs == AF_MAT_NONE) ? 0 : 1;
+
+    DIM_ASSERT(1, lhsInfo.dims()[aColDim] == rhsInfo.dims()[bRowDim]);
+}
+
 af_err af_sparse_matmul(af_array *out,
                         const af_array lhs, const af_array rhs,
                         const af_mat_prop optLhs, const af_mat_prop optRhs)
@@ -49,6 +142,34 @@ af_err af_sparse_matmul(af_array *out,
 
     try {
         common::SparseArrayBase lhsBase = getSparseArrayBase(lhs);
+
+        if (getInfo(rhs, false).isSparse()) {
+            common::SparseArrayBase rhsBase = getSparseArrayBase(rhs);
+
+            ARG_ASSERT(1, lhsBase.getStorage() == AF_STORAGE_CSR);
+            ARG_ASSERT(2, rhsBase.getStorage() == AF_STORAGE_CSR);
+
+            if (optLhs != AF_MAT_NONE || optRhs != AF_MAT_NONE) {
+                AF_ERROR("Using this property is not yet supported in sparse-sparse matmul",
+                         AF_ERR_NOT_SUPPORTED);
+            }
+
+            af_dtype lhs_type = lhsBase.getType();
+            TYPE_ASSERT(lhs_type == rhsBase.getType());
+            DIM_ASSERT(1, lhsBase.dims()[1] == rhsBase.dims()[0]);
+
+            af_array output = 0;
+            switch(lhs_type) {
+                case f32: output = sparseSparseMatmul<float  >(lhs, rhs, optLhs, optRhs); break;
+                case c32: output = sparseSparseMatmul<cfloat >(lhs, rhs, optLhs, optRhs); break;
+                case f64: output = sparseSparseMatmul<double >(lhs, rhs, optLhs, optRhs); break;
+                case c64: output = sparseSparseMatmul<cdouble>(lhs, rhs, optLhs, optRhs); break;
+                default:  TYPE_ERROR(1, lhs_type);
+            }
+            std::swap(*out, output);
+            return AF_SUCCESS;
+        }
+
         const ArrayInfo& rhsInfo = getInfo(rhs);
 
         ARG_ASSERT(2, lhsBase.isSparse() == true && rhsInfo.isSparse() == false);
@@ -104,52 +225,32 @@ af_err af_matmul(af_array *out,
 
     try {
         const ArrayInfo& lhsInfo = getInfo(lhs, false, true);
-        const ArrayInfo& rhsInfo = getInfo(rhs, true, true);
 
         if(lhsInfo.isSparse())
             return af_sparse_matmul(out, lhs, rhs, optLhs, optRhs);
 
+        const ArrayInfo& rhsInfo = getInfo(rhs, true, true);
+
         af_dtype lhs_type = lhsInfo.getType();
         af_dtype rhs_type = rhsInfo.getType();
 
-        if (!(optLhs == AF_MAT_NONE ||
-              optLhs == AF_MAT_TRANS ||
-              optLhs == AF_MAT_CTRANS)) {
-            AF_ERROR("Using this property is not yet supported in matmul", AF_ERR_NOT_SUPPORTED);
-        }
-
-        if (!(optRhs == AF_MAT_NONE ||
-              optRhs == AF_MAT_TRANS ||
-              optRhs == AF_MAT_CTRANS)) {
-            AF_ERROR("Using this property is not yet supported in matmul", AF_ERR_NOT_SUPPORTED);
-        }
-
-        dim4 lDims = lhsInfo.dims();
-        dim4 rDims = rhsInfo.dims();
-
-        if (lDims.ndims() > 2 && rDims.ndims() > 2) {
-            DIM_ASSERT(1, lDims.ndims() == rDims.ndims());
-            if (lDims[2] != rDims[2] && lDims[2] != 1 && rDims[2] != 1) {
-                AF_ERROR("Batch size mismatch along dimension 2", AF_ERR_BATCH);
-            }
-            if (lDims[3] != rDims[3] && lDims[3] != 1 && rDims[3] != 1) {
-                AF_ERROR("Batch size mismatch along dimension 3", AF_ERR_BATCH);
-            }
-        }
+        checkMatmul(lhsInfo, rhsInfo, optLhs, optRhs);
 
         TYPE_ASSERT(lhs_type == rhs_type);
         af_array output = 0;
 
-        int aColDim = (optLhs == AF_MAT_NONE) ? 1 : 0;
-        int bRowDim = (optRhs == AF_MAT_NONE) ? 0 : 1;
-
-        DIM_ASSERT(1, lhsInfo.dims()[aColDim] == rhsInfo.dims()[bRowDim]);
-
         switch(lhs_type) {
             case f32: output = matmul<float  >(lhs, rhs, optLhs, optRhs);   break;
             case c32: output = matmul<cfloat >(lhs, rhs, optLhs, optRhs);   break;
             case f64: output = matmul<double >(lhs, rhs, optLhs, optRhs);   break;
             case c64: output = matmul<cdouble>(lhs, rhs, optLhs, optRhs);   break;
+            case s32: output = integerMatmul<int   , int  >(lhs, rhs, optLhs, optRhs, 0, 0); break;
+            case u32: output = integerMatmul<uint  , uint >(lhs, rhs, optLhs, optRhs, 0, 0); break;
+            case s64: output = integerMatmul<intl  , intl >(lhs, rhs, optLhs, optRhs, 0, 0); break;
+            case u64: output = integerMatmul<uintl , uintl>(lhs, rhs, optLhs, optRhs, 0, 0); break;
+            case s16: output = integerMatmul<short , intl >(lhs, rhs, optLhs, optRhs, 0, 0); break;
+            case u16: output = integerMatmul<ushort, uintl>(lhs, rhs, optLhs, optRhs, 0, 0); break;
+            case  u8: output = integerMatmul<uchar , uint >(lhs, rhs, optLhs, optRhs, 0, 0); break;
             default:  TYPE_ERROR(1, lhs_type);
         }
         std::swap(*out, output);
@@ -158,6 +259,103 @@ af_err af_matmul(af_array *out,
     return AF_SUCCESS;
 }
 
+af_err af_matmul_quantized(af_array *out,
+                           const af_array lhs, const af_array rhs,
+                           const af_mat_prop optLhs, const af_mat_prop optRhs,
+                           const int lhsZero, const int rhsZero, const double scale)
+{
+    using namespace detail;
+
+    try {
+        const ArrayInfo& lhsInfo = getInfo(lhs);
+        const ArrayInfo& rhsInfo = getInfo(rhs);
+
+        af_dtype lhs_type = lhsInfo.getType();
+        af_dtype rhs_type = rhsInfo.getType();
+
+        checkMatmul(lhsInfo, rhsInfo, optLhs, optRhs);
+
+        TYPE_ASSERT(lhs_type == rhs_type);
+        if (lhs_type != u8 && lhs_type != s16) TYPE_ERROR(1, lhs_type);
+
+        // The differences from the zero points must fit in 16 bits
+        if (lhs_type == u8) {
+            ARG_ASSERT(5, (lhsZero >= 0 && lhsZero <= 255));
+            ARG_ASSERT(6, (rhsZero >= 0 && rhsZero <= 255));
+        } else {
+            ARG_ASSERT(5, (lhsZero >= -32768 && lhsZero <= 32767));
+            ARG_ASSERT(6, (rhsZero >= -32768 && rhsZero <= 32767));
+        }
+
+        af_array output = 0;
+        switch(lhs_type) {
+            case  u8: output = quantizedMatmul<uchar>(lhs, rhs, optLhs, optRhs, lhsZero, rhsZero, scale); break;
+            case s16: output = quantizedMatmul<short>(lhs, rhs, optLhs, optRhs, lhsZero, rhsZero, scale); break;
+            default:  TYPE_ERROR(1, lhs_type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
+af_err af_matmul_fused(af_array *out,
+                       const af_array lhs, const af_array rhs,
+                       const af_mat_prop optLhs, const af_mat_prop optRhs,
+                       const double alpha, const af_array c, const double beta,
+                       const af_array bias, const af_activation act)
+{
+    using namespace detail;
+
+    try {
+        const ArrayInfo& lhsInfo = getInfo(lhs);
+        const ArrayInfo& rhsInfo = getInfo(rhs);
+
+        af_dtype type = lhsInfo.getType();
+
+        checkMatmul(lhsInfo, rhsInfo, optLhs, optRhs);
+
+        TYPE_ASSERT(type == rhsInfo.getType());
+        ARG_ASSERT(9, (act >= AF_ACTIVATION_NONE && act <= AF_ACTIVATION_TANH));
+
+        dim4 lDims = lhsInfo.dims();
+        dim4 rDims = rhsInfo.dims();
+        dim4 oDims(lDims[optLhs == AF_MAT_NONE ? 0 : 1], rDims[optRhs == AF_MAT_NONE ? 1 : 0],
+                   std::max(lDims[2], rDims[2]), std::max(lDims[3], rDims[3]));
+
+        if (c != 0) {
+            const ArrayInfo& cInfo = getInfo(c);
+            TYPE_ASSERT(type == cInfo.getType());
+            DIM_ASSERT(5, cInfo.dims() == oDims);
+        }
+
+        // A vector of M elements is added to every column, and a 1 x N row
+        // vector to every row, of every output matrix
+        if (bias != 0) {
+            const ArrayInfo& bInfo = getInfo(bias);
+            const dim4 bDims = bInfo.dims();
+            TYPE_ASSERT(type == bInfo.getType());
+            DIM_ASSERT(8, ((bDims[0] == oDims[0] && bInfo.elements() == oDims[0]) ||
+                           (bDims[0] == 1 && bDims[1] == oDims[1] &&
+                            bInfo.elements() == oDims[1])));
+        }
+
+        af_array output = 0;
+        if (oDims.elements() == 0) {
+            output = createHandle(oDims, type);
+        } else {
+            switch(type) {
+                case f32: output = fusedMatmul<float >(lhs, rhs, optLhs, optRhs, alpha, c, beta, bias, act, oDims); break;
+                case f64: output = fusedMatmul<double>(lhs, rhs, optLhs, optRhs, alpha, c, beta, bias, act, oDims); break;
+                default:  TYPE_ERROR(1, type);
+            }
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
 af_err af_dot(af_array *out,
               const af_array lhs, const af_array rhs,
               const af_mat_prop optLhs, const af_mat_prop optRhs)
@@ -183,9 +381,18 @@ af_err af_dot(af_array *out,
         if(lhsInfo.ndims() == 0) {
             return af_retain_array(out, lhs);
         }
-        if (lhsInfo.ndims() > 1 ||
-            rhsInfo.ndims() > 1) {
-            AF_ERROR("dot can not be used in batch mode", AF_ERR_BATCH);
+
+        // Row vectors are not a batch of single element columns
+        if (lhsInfo.dims()[0] == 1 &&
+            (lhsInfo.ndims() > 1 || rhsInfo.ndims() > 1)) {
+            AF_ERROR("dot can not be used on row vectors", AF_ERR_BATCH);
+        }
+
+        // Columns are paired up, a side with a single one is broadcast
+        for (int d = 1; d < 4; d++) {
+            const dim_t lDim = lhsInfo.dims()[d];
+            const dim_t rDim = rhsInfo.dims()[d];
+            DIM_ASSERT(1, lDim == rDim || lDim == 1 || rDim == 1);
         }
 
         TYPE_ASSERT(lhs_type == rhs_type);
@@ -225,6 +432,11 @@ af_err af_dot_all(double *rval, double *ival,
                   *rval = 0;
         if (ival) *ival = 0;
 
+        if (getInfo(lhs).ndims() > 1 ||
+            getInfo(rhs).ndims() > 1) {
+            AF_ERROR("dot_all can not be used in batch mode", AF_ERR_BATCH);
+        }
+
         af_array out = 0;
         AF_CHECK(af_dot(&out, lhs, rhs, optLhs, optRhs));
 
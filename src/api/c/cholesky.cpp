@@ -36,10 +36,6 @@ af_err af_cholesky(af_array *out, int *info, const af_array in, const bool is_up
     try {
         const ArrayInfo& i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
-            AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
-        }
-
         af_dtype type = i_info.getType();
 
         if(i_info.ndims() == 0) {
@@ -68,10 +64,6 @@ af_err af_cholesky_inplace(int *info, af_array in, const bool is_upper)
     try {
         const ArrayInfo& i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
-            AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
-        }
-
         af_dtype type = i_info.getType();
         if(i_info.ndims() == 0) {
             return AF_SUCCESS;
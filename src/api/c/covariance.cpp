@@ -19,6 +19,10 @@
 #include <math.hpp>
 #include <cast.hpp>
 #include <tile.hpp>
+#include <blas.hpp>
+#include <diagonal.hpp>
+#include <select.hpp>
+#include <transpose.hpp>
 
 #include "stats.h"
 
@@ -51,6 +55,161 @@ static af_array cov(const af_array& X, const af_array& Y, const bool isbiased)
     return getHandle<cType>(result);
 }
 
+// Covariance or correlation matrix of the columns of the N x P matrix X.
+//
+// The columns are centered and scaled by the square root of the weights in
+// a single elementwise pass, and the products of all the pairs of columns
+// come from one A^T * A product, which the CPU backend computes with a
+// symmetric rank-k update.
+//
+// With pairwise set, every pair of columns only uses the rows where both are
+// not NaN. With a mask M of the valid values and the centered data Z having
+// zeros in place of NaNs, the sums over those rows are all products of the
+// form A^T * B:
+//
+//   n_ij  = sum(w m_i m_j)      s_ij = sum(w z_i m_j)
+//   p_ij  = sum(w z_i z_j)      q_ij = sum(w z_i^2 m_j)
+//
+// cov_ij  = (p_ij - s_ij s_ji / n_ij) / (n_ij - ddof)
+// corr_ij = (p_ij - s_ij s_ji / n_ij) /
+//           sqrt((q_ij - s_ij^2 / n_ij) * (q_ji - s_ji^2 / n_ij))
+template<typename Ti, typename To>
+static af_array covMatrix(const af_array X, const af_array weights,
+                          const af_var_bias bias, const bool pairwise,
+                          const bool corr)
+{
+    Array<To> x = cast<To>(getArray<Ti>(X));
+    const dim4 dims = x.dims();
+    const dim_t N = dims[0];
+    const dim_t P = dims[1];
+    const dim4 rdims(1, P);
+    const dim4 odims(P, P);
+    const dim4 rowTile(N, 1);
+    const dim4 colTile(1, P);
+    const double ddof = (bias == AF_VARIANCE_SAMPLE) ? 1 : 0;
+
+    const bool weighted = weights != 0;
+    Array<To> w     = weighted ? flat<To>(castArray<To>(weights)) : createEmptyArray<To>(dim4(0));
+    Array<To> sqrtW = createEmptyArray<To>(dim4(0));
+    if (weighted) {
+        sqrtW = tile<To>(unaryOp<To, af_sqrt_t>(w), colTile);
+    }
+
+    if (!pairwise) {
+        Array<To> mean = createEmptyArray<To>(dim4(0));
+        To count = scalar<To>(N);
+        if (weighted) {
+            count = reduce_all<af_add_t, To, To>(w);
+            mean  = arithOp<To, af_div_t>(matmul<To>(w, x, AF_MAT_TRANS, AF_MAT_NONE),
+                                          createValueArray<To>(rdims, count), rdims);
+        } else {
+            mean  = arithOp<To, af_div_t>(reduce<af_add_t, To, To>(x, 0),
+                                          createValueArray<To>(rdims, count), rdims);
+        }
+
+        Array<To> xc = arithOp<To, af_sub_t>(x, tile<To>(mean, rowTile), dims);
+        if (weighted) xc = arithOp<To, af_mul_t>(xc, sqrtW, dims);
+        Array<To> res = matmul<To>(xc, xc, AF_MAT_TRANS, AF_MAT_NONE);
+
+        if (corr) {
+            Array<To> scale = unaryOp<To, af_sqrt_t>(diagExtract<To>(res, 0));
+            scale = arithOp<To, af_div_t>(createValueArray<To>(dim4(P), scalar<To>(1)),
+                                          scale, dim4(P));
+            Array<To> outer = matmul<To>(scale, scale, AF_MAT_NONE, AF_MAT_TRANS);
+            return getHandle<To>(arithOp<To, af_mul_t>(res, outer, odims));
+        }
+
+        Array<To> denom = createValueArray<To>(odims, scalar<To>(count - ddof));
+        return getHandle<To>(arithOp<To, af_div_t>(res, denom, odims));
+    }
+
+    Array<char> nans = checkOp<To, af_isnan_t>(x);
+    Array<To> mask   = createSelectNode<To, true>(nans, createValueArray<To>(dims, scalar<To>(1)),
+                                                  0.0, dims);
+    Array<To> z      = createSelectNode<To, true>(nans, x, 0.0, dims);
+
+    // Column means over the valid rows, only used to reduce cancellation
+    Array<To> wmask = weighted ? arithOp<To, af_mul_t>(mask, tile<To>(w, colTile), dims) : mask;
+    Array<To> wz    = weighted ? arithOp<To, af_mul_t>(z,    tile<To>(w, colTile), dims) : z;
+    Array<To> mean  = arithOp<To, af_div_t>(reduce<af_add_t, To, To>(wz, 0),
+                                            reduce<af_add_t, To, To>(wmask, 0), rdims);
+
+    Array<To> zc = arithOp<To, af_sub_t>(z, tile<To>(mean, rowTile), dims);
+    zc = createSelectNode<To, true>(nans, zc, 0.0, dims);
+
+    Array<To> zs = weighted ? arithOp<To, af_mul_t>(zc,   sqrtW, dims) : zc;
+    Array<To> ms = weighted ? arithOp<To, af_mul_t>(mask, sqrtW, dims) : mask;
+    zs.eval();
+    ms.eval();
+
+    Array<To> n   = matmul<To>(ms, ms, AF_MAT_TRANS, AF_MAT_NONE);
+    Array<To> sm  = matmul<To>(zs, ms, AF_MAT_TRANS, AF_MAT_NONE);
+    Array<To> p   = matmul<To>(zs, zs, AF_MAT_TRANS, AF_MAT_NONE);
+    Array<To> smT = transpose<To>(sm, false);
+
+    Array<To> cross = arithOp<To, af_div_t>(arithOp<To, af_mul_t>(sm, smT, odims), n, odims);
+    Array<To> num   = arithOp<To, af_sub_t>(p, cross, odims);
+
+    if (corr) {
+        Array<To> q   = matmul<To>(arithOp<To, af_mul_t>(zs, zs, dims), mask,
+                                   AF_MAT_TRANS, AF_MAT_NONE);
+        Array<To> sq  = arithOp<To, af_div_t>(arithOp<To, af_mul_t>(sm, sm, odims), n, odims);
+        Array<To> v   = arithOp<To, af_sub_t>(q, sq, odims);
+        Array<To> vvT = arithOp<To, af_mul_t>(v, transpose<To>(v, false), odims);
+        return getHandle<To>(arithOp<To, af_div_t>(num, unaryOp<To, af_sqrt_t>(vvT), odims));
+    }
+
+    Array<To> denom = arithOp<To, af_sub_t>(n, createValueArray<To>(odims, scalar<To>(ddof)),
+                                            odims);
+    return getHandle<To>(arithOp<To, af_div_t>(num, denom, odims));
+}
+
+static af_err covMatrix(af_array *out, const af_array X, const af_array weights,
+                        const af_var_bias bias, const bool pairwise, const bool corr)
+{
+    try {
+        const ArrayInfo& xInfo = getInfo(X);
+        const dim4 xDims = xInfo.dims();
+        af_dtype xType   = xInfo.getType();
+
+        ARG_ASSERT(1, (xDims.ndims() <= 2 && xDims[0] > 0));
+        if (weights != 0) {
+            const ArrayInfo& wInfo = getInfo(weights);
+            ARG_ASSERT(2, (wInfo.isVector() && wInfo.elements() == xDims[0]));
+            ARG_ASSERT(2, !wInfo.isComplex());
+        }
+
+        af_array output = 0;
+        switch(xType) {
+            case f64: output = covMatrix<double, double>(X, weights, bias, pairwise, corr); break;
+            case f32: output = covMatrix<float , float >(X, weights, bias, pairwise, corr); break;
+            case s32: output = covMatrix<int   , float >(X, weights, bias, pairwise, corr); break;
+            case u32: output = covMatrix<uint  , float >(X, weights, bias, pairwise, corr); break;
+            case s64: output = covMatrix<intl  , double>(X, weights, bias, pairwise, corr); break;
+            case u64: output = covMatrix<uintl , double>(X, weights, bias, pairwise, corr); break;
+            case s16: output = covMatrix<short , float >(X, weights, bias, pairwise, corr); break;
+            case u16: output = covMatrix<ushort, float >(X, weights, bias, pairwise, corr); break;
+            case  u8: output = covMatrix<uchar , float >(X, weights, bias, pairwise, corr); break;
+            default : TYPE_ERROR(1, xType);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_cov_matrix(af_array *out, const af_array X, const af_array weights,
+                     const af_var_bias bias, const bool pairwise)
+{
+    return covMatrix(out, X, weights, bias, pairwise, false);
+}
+
+af_err af_corrcoef_matrix(af_array *out, const af_array X, const af_array weights,
+                          const bool pairwise)
+{
+    return covMatrix(out, X, weights, AF_VARIANCE_POPULATION, pairwise, true);
+}
+
 af_err af_cov(af_array* out, const af_array X, const af_array Y, const bool isbiased)
 {
     try {
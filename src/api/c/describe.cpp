@@ -0,0 +1,105 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/dim4.hpp>
+#include <af/defines.h>
+#include <af/statistics.h>
+#include <af/data.h>
+#include <handle.hpp>
+#include <common/err_common.hpp>
+#include <backend.hpp>
+#include <describe.hpp>
+#include <copy.hpp>
+
+#include <vector>
+
+using namespace detail;
+using af::dim4;
+using std::vector;
+
+template<typename Ti, typename To>
+static af_array describe(const af_array in, const unsigned stats,
+                         const af_var_bias bias, const dim_t dim)
+{
+    return getHandle<To>(describe<Ti, To>(getArray<Ti>(in), stats, bias, dim));
+}
+
+template<typename Ti, typename To>
+static void describeAll(double *out, const af_array in, const unsigned stats,
+                        const af_var_bias bias)
+{
+    af_array flat = 0;
+    AF_CHECK(af_flat(&flat, in));
+    Array<To> res = describe<Ti, To>(getArray<Ti>(flat), stats, bias, 0);
+    AF_CHECK(af_release_array(flat));
+
+    vector<To> vals(res.elements());
+    copyData(vals.data(), res);
+    for (size_t i = 0; i < vals.size(); i++) out[i] = vals[i];
+}
+
+af_err af_describe(af_array *out, const af_array in, const unsigned stats,
+                   const af_var_bias bias, const dim_t dim)
+{
+    try {
+        ARG_ASSERT(4, (dim >= 0 && dim < 4));
+        ARG_ASSERT(2, (stats != 0 && (stats & ~AF_STAT_ALL) == 0));
+
+        const ArrayInfo& info = getInfo(in);
+        af_dtype type = info.getType();
+        ARG_ASSERT(1, info.ndims() > 0);
+
+        af_array output = 0;
+        switch(type) {
+            case f32: output = describe<float , float >(in, stats, bias, dim); break;
+            case f64: output = describe<double, double>(in, stats, bias, dim); break;
+            case s32: output = describe<int   , float >(in, stats, bias, dim); break;
+            case u32: output = describe<uint  , float >(in, stats, bias, dim); break;
+            case s64: output = describe<intl  , double>(in, stats, bias, dim); break;
+            case u64: output = describe<uintl , double>(in, stats, bias, dim); break;
+            case s16: output = describe<short , float >(in, stats, bias, dim); break;
+            case u16: output = describe<ushort, float >(in, stats, bias, dim); break;
+            case  u8: output = describe<uchar , float >(in, stats, bias, dim); break;
+            case  b8: output = describe<char  , float >(in, stats, bias, dim); break;
+            default : TYPE_ERROR(1, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_describe_all(double *out, const af_array in, const unsigned stats,
+                       const af_var_bias bias)
+{
+    try {
+        ARG_ASSERT(0, out != 0);
+        ARG_ASSERT(2, (stats != 0 && (stats & ~AF_STAT_ALL) == 0));
+
+        const ArrayInfo& info = getInfo(in);
+        af_dtype type = info.getType();
+        ARG_ASSERT(1, info.ndims() > 0);
+
+        switch(type) {
+            case f32: describeAll<float , float >(out, in, stats, bias); break;
+            case f64: describeAll<double, double>(out, in, stats, bias); break;
+            case s32: describeAll<int   , float >(out, in, stats, bias); break;
+            case u32: describeAll<uint  , float >(out, in, stats, bias); break;
+            case s64: describeAll<intl  , double>(out, in, stats, bias); break;
+            case u64: describeAll<uintl , double>(out, in, stats, bias); break;
+            case s16: describeAll<short , float >(out, in, stats, bias); break;
+            case u16: describeAll<ushort, float >(out, in, stats, bias); break;
+            case  u8: describeAll<uchar , float >(out, in, stats, bias); break;
+            case  b8: describeAll<char  , float >(out, in, stats, bias); break;
+            default : TYPE_ERROR(1, type);
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
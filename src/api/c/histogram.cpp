@@ -9,6 +9,8 @@
 
 #include <af/dim4.hpp>
 #include <af/image.h>
+#include <af/arith.h>
+#include <af/data.h>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <backend.hpp>
@@ -59,3 +61,89 @@ af_err af_histogram(af_array *out, const af_array in,
 
     return AF_SUCCESS;
 }
+
+// Returns the bin of every element of in as a flat f64 array. The bins are
+// computed exactly like af_histogram does.
+static af_array histogramBins(const af_array in, const unsigned nbins,
+                              const double minval, const double maxval)
+{
+    const ArrayInfo& info = getInfo(in);
+    const dim4 dims = info.dims();
+    const double step = (float)((maxval - minval) / (float)nbins);
+
+    af_array vals = 0, minArr = 0, stepArr = 0, loArr = 0, hiArr = 0;
+    af_array offset = 0, scaled = 0, floored = 0, clamped = 0, bins = 0;
+    AF_CHECK(af_cast(&vals, in, f64));
+    AF_CHECK(af_constant(&minArr , minval   , dims.ndims(), dims.get(), f64));
+    AF_CHECK(af_constant(&stepArr, step     , dims.ndims(), dims.get(), f64));
+    AF_CHECK(af_constant(&loArr  , 0        , dims.ndims(), dims.get(), f64));
+    AF_CHECK(af_constant(&hiArr  , nbins - 1, dims.ndims(), dims.get(), f64));
+
+    AF_CHECK(af_sub(&offset, vals, minArr, false));
+    AF_CHECK(af_div(&scaled, offset, stepArr, false));
+    AF_CHECK(af_floor(&floored, scaled));
+    AF_CHECK(af_clamp(&clamped, floored, loArr, hiArr, false));
+    AF_CHECK(af_flat(&bins, clamped));
+
+    AF_CHECK(af_release_array(vals));
+    AF_CHECK(af_release_array(minArr));
+    AF_CHECK(af_release_array(stepArr));
+    AF_CHECK(af_release_array(loArr));
+    AF_CHECK(af_release_array(hiArr));
+    AF_CHECK(af_release_array(offset));
+    AF_CHECK(af_release_array(scaled));
+    AF_CHECK(af_release_array(floored));
+    AF_CHECK(af_release_array(clamped));
+    return bins;
+}
+
+af_err af_histogram2d(af_array *out, const af_array x, const af_array y,
+                      const unsigned xbins, const unsigned ybins,
+                      const double xmin, const double xmax,
+                      const double ymin, const double ymax)
+{
+    try {
+        const ArrayInfo& xinfo = getInfo(x);
+        const ArrayInfo& yinfo = getInfo(y);
+
+        ARG_ASSERT(1, xinfo.isReal());
+        ARG_ASSERT(2, yinfo.isReal());
+        ARG_ASSERT(2, xinfo.elements() == yinfo.elements());
+        ARG_ASSERT(3, xbins > 0);
+        ARG_ASSERT(4, ybins > 0);
+
+        const dim_t nbins = (dim_t)xbins * ybins;
+        // The combined bin index has to be exact in single precision
+        ARG_ASSERT(4, nbins <= (1 << 24));
+
+        dim4 odims(xbins, ybins, 1, 1);
+        if (xinfo.elements() == 0) {
+            AF_CHECK(af_constant(out, 0, odims.ndims(), odims.get(), u32));
+            return AF_SUCCESS;
+        }
+
+        // The joint bin is x_bin + xbins * y_bin, which is counted with a
+        // regular histogram of unit width bins
+        af_array xb = histogramBins(x, xbins, xmin, xmax);
+        af_array yb = histogramBins(y, ybins, ymin, ymax);
+        dim4 fdims(xinfo.elements());
+
+        af_array xbinsArr = 0, yoffset = 0, joint = 0, hist = 0, output = 0;
+        AF_CHECK(af_constant(&xbinsArr, xbins, fdims.ndims(), fdims.get(), f64));
+        AF_CHECK(af_mul(&yoffset, yb, xbinsArr, false));
+        AF_CHECK(af_add(&joint, xb, yoffset, false));
+        AF_CHECK(af_histogram(&hist, joint, (unsigned)nbins, 0.0, (double)nbins));
+        AF_CHECK(af_moddims(&output, hist, odims.ndims(), odims.get()));
+
+        AF_CHECK(af_release_array(xb));
+        AF_CHECK(af_release_array(yb));
+        AF_CHECK(af_release_array(xbinsArr));
+        AF_CHECK(af_release_array(yoffset));
+        AF_CHECK(af_release_array(joint));
+        AF_CHECK(af_release_array(hist));
+        std::swap(*out, output);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -45,10 +45,6 @@ af_err af_lu(af_array *lower, af_array *upper, af_array *pivot, const af_array i
     try {
         const ArrayInfo& i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
-            AF_ERROR("lu can not be used in batch mode", AF_ERR_BATCH);
-        }
-
         af_dtype type = i_info.getType();
 
         ARG_ASSERT(3, i_info.isFloating());                       // Only floating and complex types
@@ -80,10 +76,6 @@ af_err af_lu_inplace(af_array *pivot, af_array in, const bool is_lapack_piv)
         const ArrayInfo& i_info = getInfo(in);
         af_dtype type = i_info.getType();
 
-        if (i_info.ndims() > 2) {
-            AF_ERROR("lu can not be used in batch mode", AF_ERR_BATCH);
-        }
-
         ARG_ASSERT(1, i_info.isFloating()); // Only floating and complex types
 
         if(i_info.ndims() == 0) {
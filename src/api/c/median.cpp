@@ -16,10 +16,13 @@
 #include <handle.hpp>
 #include <common/err_common.hpp>
 #include <backend.hpp>
-#include <sort.hpp>
+#include <nth_element.hpp>
+#include <copy.hpp>
 #include <math.hpp>
 #include <cast.hpp>
 
+#include <vector>
+
 using namespace detail;
 using af::dim4;
 
@@ -34,38 +37,16 @@ static double median(const af_array& in)
     AF_CHECK(af_moddims(&temp, in, 1, dims.get()));
     const Array<T> input  = getArray<T>(temp);
 
-    // Shortcut cases for 1 or 2 elements
-    if(nElems == 1) {
-        T result;
-        AF_CHECK(af_get_data_ptr((void*)&result, in));
-        return result;
-    } else if(nElems == 2) {
-        T result[2];
-        AF_CHECK(af_get_data_ptr((void*)&result, in));
-        if (input.isFloating()) {
-            return division(result[0] + result[1], 2.0);
-        } else {
-            return division((float)result[0] + (float)result[1], 2.0);
-        }
-    }
-
-    double mid      = (nElems + 1) / 2;
-    af_seq mdSpan[1]= {af_make_seq(mid-1, mid, 1)};
-
-    Array<T> sortedArr = sort<T>(input, 0, true);
-
-    af_array sarrHandle = getHandle<T>(sortedArr);
+    // Select the middle element(s) instead of sorting the whole array
+    std::vector<dim_t> ranks;
+    ranks.push_back((nElems - 1) / 2);
+    if (nElems % 2 == 0) ranks.push_back(nElems / 2);
 
-    double result;
     T resPtr[2];
-    af_array res = 0;
-    AF_CHECK(af_index(&res, sarrHandle, 1, mdSpan));
-    AF_CHECK(af_get_data_ptr((void*)&resPtr, res));
-
-    AF_CHECK(af_release_array(res));
-    AF_CHECK(af_release_array(sarrHandle));
+    copyData(resPtr, nthElement<T>(input, 0, ranks));
     AF_CHECK(af_release_array(temp));
 
+    double result;
     if (nElems % 2 == 1) {
         result = resPtr[0];
     } else {
@@ -90,22 +71,27 @@ static af_array median(const af_array& in, const dim_t dim)
         return getHandle<T>(result);
     }
 
-    Array<T> sortedIn   = sort<T>(input, dim, true);
-
     int dimLength = input.dims()[dim];
-    double mid    = (dimLength + 1) / 2;
-    af_array left = 0;
 
+    // Select the middle element(s) of every slice instead of sorting them.
+    // The selected values are stored along dim in the order of the ranks.
+    std::vector<dim_t> ranks;
+    ranks.push_back((dimLength - 1) / 2);
+    if (dimLength % 2 == 0) ranks.push_back(dimLength / 2);
+
+    Array<T> selected = nthElement<T>(input, dim, ranks);
+
+    af_array left = 0;
     af_seq slices[4] = {af_span, af_span, af_span, af_span};
-    slices[dim] = af_make_seq(mid-1.0, mid-1.0, 1.0);
+    slices[dim] = af_make_seq(0.0, 0.0, 1.0);
 
-    af_array sortedIn_handle = getHandle<T>(sortedIn);
-    AF_CHECK(af_index(&left, sortedIn_handle, input.ndims(), slices));
+    af_array selected_handle = getHandle<T>(selected);
+    AF_CHECK(af_index(&left, selected_handle, input.ndims(), slices));
 
     if (dimLength % 2 == 1) {
         // mid-1 is our guy
         if (input.isFloating()) {
-            AF_CHECK(af_release_array(sortedIn_handle));
+            AF_CHECK(af_release_array(selected_handle));
             return left;
         }
 
@@ -113,15 +99,15 @@ static af_array median(const af_array& in, const dim_t dim)
         af_array out;
         AF_CHECK(af_cast(&out, left, f32));
         AF_CHECK(af_release_array(left));
-        AF_CHECK(af_release_array(sortedIn_handle));
+        AF_CHECK(af_release_array(selected_handle));
         return out;
     } else {
         // ((mid-1)+mid)/2 is our guy
         dim4 dims = input.dims();
         af_array right = 0;
-        slices[dim] = af_make_seq(mid, mid, 1.0);
+        slices[dim] = af_make_seq(1.0, 1.0, 1.0);
 
-        AF_CHECK(af_index(&right, sortedIn_handle, dims.ndims(), slices));
+        AF_CHECK(af_index(&right, selected_handle, dims.ndims(), slices));
 
         af_array sumarr = 0;
         af_array carr   = 0;
@@ -148,7 +134,7 @@ static af_array median(const af_array& in, const dim_t dim)
         AF_CHECK(af_release_array(right));
         AF_CHECK(af_release_array(sumarr));
         AF_CHECK(af_release_array(carr));
-        AF_CHECK(af_release_array(sortedIn_handle));
+        AF_CHECK(af_release_array(selected_handle));
         return result;
     }
 }
@@ -0,0 +1,98 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/dim4.hpp>
+#include <af/defines.h>
+#include <af/statistics.h>
+#include <handle.hpp>
+#include <common/err_common.hpp>
+#include <backend.hpp>
+#include <moving.hpp>
+
+using namespace detail;
+using af::dim4;
+
+template<typename Ti, typename To>
+static af_array moving(const af_array in, const af_stat_type stat, const dim_t window,
+                       const dim_t stride, const af_var_bias bias, const dim_t dim)
+{
+    return getHandle<To>(moving<Ti, To>(getArray<Ti>(in), stat, window, stride, bias, dim));
+}
+
+static af_err moving(af_array *out, const af_array in, const af_stat_type stat,
+                     const dim_t window, const dim_t stride,
+                     const af_var_bias bias, const dim_t dim, const int dimArg)
+{
+    try {
+        ARG_ASSERT(dimArg, (dim >= 0 && dim < 4));
+
+        const ArrayInfo& info = getInfo(in);
+        af_dtype type = info.getType();
+        ARG_ASSERT(1, info.ndims() > 0);
+        ARG_ASSERT(2, (window > 0 && window <= info.dims()[dim]));
+        ARG_ASSERT(3, stride > 0);
+
+        // The minimum and maximum keep the type of the input
+        const bool keepType = (stat == AF_STAT_MIN || stat == AF_STAT_MAX);
+
+        af_array output = 0;
+        switch(type) {
+            case f32: output = moving<float , float >(in, stat, window, stride, bias, dim); break;
+            case f64: output = moving<double, double>(in, stat, window, stride, bias, dim); break;
+            case s32: output = keepType ? moving<int   , int   >(in, stat, window, stride, bias, dim)
+                                        : moving<int   , float >(in, stat, window, stride, bias, dim); break;
+            case u32: output = keepType ? moving<uint  , uint  >(in, stat, window, stride, bias, dim)
+                                        : moving<uint  , float >(in, stat, window, stride, bias, dim); break;
+            case s64: output = keepType ? moving<intl  , intl  >(in, stat, window, stride, bias, dim)
+                                        : moving<intl  , double>(in, stat, window, stride, bias, dim); break;
+            case u64: output = keepType ? moving<uintl , uintl >(in, stat, window, stride, bias, dim)
+                                        : moving<uintl , double>(in, stat, window, stride, bias, dim); break;
+            case s16: output = keepType ? moving<short , short >(in, stat, window, stride, bias, dim)
+                                        : moving<short , float >(in, stat, window, stride, bias, dim); break;
+            case u16: output = keepType ? moving<ushort, ushort>(in, stat, window, stride, bias, dim)
+                                        : moving<ushort, float >(in, stat, window, stride, bias, dim); break;
+            case  u8: output = keepType ? moving<uchar , uchar >(in, stat, window, stride, bias, dim)
+                                        : moving<uchar , float >(in, stat, window, stride, bias, dim); break;
+            default : TYPE_ERROR(1, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_moving_sum(af_array *out, const af_array in, const dim_t window,
+                     const dim_t stride, const dim_t dim)
+{
+    return moving(out, in, AF_STAT_SUM, window, stride, AF_VARIANCE_POPULATION, dim, 4);
+}
+
+af_err af_moving_mean(af_array *out, const af_array in, const dim_t window,
+                      const dim_t stride, const dim_t dim)
+{
+    return moving(out, in, AF_STAT_MEAN, window, stride, AF_VARIANCE_POPULATION, dim, 4);
+}
+
+af_err af_moving_min(af_array *out, const af_array in, const dim_t window,
+                     const dim_t stride, const dim_t dim)
+{
+    return moving(out, in, AF_STAT_MIN, window, stride, AF_VARIANCE_POPULATION, dim, 4);
+}
+
+af_err af_moving_max(af_array *out, const af_array in, const dim_t window,
+                     const dim_t stride, const dim_t dim)
+{
+    return moving(out, in, AF_STAT_MAX, window, stride, AF_VARIANCE_POPULATION, dim, 4);
+}
+
+af_err af_moving_var(af_array *out, const af_array in, const dim_t window,
+                     const dim_t stride, const af_var_bias bias, const dim_t dim)
+{
+    return moving(out, in, AF_STAT_VAR, window, stride, bias, dim, 5);
+}
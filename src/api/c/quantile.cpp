@@ -0,0 +1,130 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/dim4.hpp>
+#include <af/defines.h>
+#include <af/statistics.h>
+#include <af/arith.h>
+#include <af/data.h>
+#include <handle.hpp>
+#include <common/err_common.hpp>
+#include <backend.hpp>
+#include <nth_element.hpp>
+#include <lookup.hpp>
+#include <arith.hpp>
+#include <cast.hpp>
+#include <copy.hpp>
+#include <tile.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace detail;
+using af::dim4;
+using std::vector;
+
+template<typename T, typename To>
+static af_array quantile(const af_array in, const vector<double> &probs,
+                         const dim_t dim)
+{
+    const Array<T> input = getArray<T>(in);
+    const dim4 idims     = input.dims();
+    const dim_t len      = idims[dim];
+    const dim_t nprobs   = probs.size();
+
+    // Every quantile is linearly interpolated between the two closest order
+    // statistics. Select all of them from the input in a single pass.
+    vector<dim_t> lower(nprobs), upper(nprobs);
+    vector<To> frac(nprobs);
+    for (dim_t i = 0; i < nprobs; i++) {
+        double h = (len - 1) * probs[i];
+        lower[i] = std::min((dim_t)std::floor(h), len - 1);
+        upper[i] = std::min(lower[i] + 1, len - 1);
+        frac[i]  = (To)(h - lower[i]);
+    }
+
+    vector<dim_t> ranks(lower);
+    ranks.insert(ranks.end(), upper.begin(), upper.end());
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+
+    // Positions of the order statistics in the selected array
+    vector<uint> lidx(nprobs), uidx(nprobs);
+    for (dim_t i = 0; i < nprobs; i++) {
+        lidx[i] = std::lower_bound(ranks.begin(), ranks.end(), lower[i]) - ranks.begin();
+        uidx[i] = std::lower_bound(ranks.begin(), ranks.end(), upper[i]) - ranks.begin();
+    }
+
+    Array<To> selected = cast<To, T>(nthElement<T>(input, dim, ranks));
+
+    Array<uint> lidxArr = createHostDataArray<uint>(dim4(nprobs), lidx.data());
+    Array<uint> uidxArr = createHostDataArray<uint>(dim4(nprobs), uidx.data());
+    Array<To> lo = lookup<To, uint>(selected, lidxArr, dim);
+    Array<To> hi = lookup<To, uint>(selected, uidxArr, dim);
+
+    dim4 odims = idims;
+    odims[dim] = nprobs;
+
+    dim4 fdims(1, 1, 1, 1);
+    fdims[dim] = nprobs;
+    dim4 tdims = odims;
+    tdims[dim] = 1;
+    Array<To> weights = tile<To>(createHostDataArray<To>(fdims, frac.data()), tdims);
+
+    // lo + (hi - lo) * weights
+    Array<To> diff   = arithOp<To, af_sub_t>(hi, lo, odims);
+    Array<To> scaled = arithOp<To, af_mul_t>(diff, weights, odims);
+    Array<To> out    = arithOp<To, af_add_t>(lo, scaled, odims);
+
+    return getHandle<To>(out);
+}
+
+af_err af_quantile(af_array *out, const af_array in, const af_array probs,
+                   const dim_t dim)
+{
+    try {
+        ARG_ASSERT(3, (dim >= 0 && dim < 4));
+
+        const ArrayInfo& info  = getInfo(in);
+        const ArrayInfo& pinfo = getInfo(probs);
+        af_dtype type = info.getType();
+
+        ARG_ASSERT(1, info.ndims() > 0);
+        ARG_ASSERT(2, pinfo.isFloating() && pinfo.isReal());
+        ARG_ASSERT(2, pinfo.isVector() || pinfo.isScalar());
+
+        // The probabilities are needed on the host to pick the ranks
+        vector<double> p(pinfo.elements());
+        af_array pd = 0;
+        AF_CHECK(af_cast(&pd, probs, f64));
+        AF_CHECK(af_get_data_ptr(p.data(), pd));
+        AF_CHECK(af_release_array(pd));
+        for (double val : p) {
+            ARG_ASSERT(2, (val >= 0.0 && val <= 1.0));
+        }
+
+        af_array output = 0;
+        switch(type) {
+            case f64: output = quantile<double, double>(in, p, dim); break;
+            case f32: output = quantile<float , float >(in, p, dim); break;
+            case s32: output = quantile<int   , float >(in, p, dim); break;
+            case u32: output = quantile<uint  , float >(in, p, dim); break;
+            case s64: output = quantile<intl  , double>(in, p, dim); break;
+            case u64: output = quantile<uintl , double>(in, p, dim); break;
+            case s16: output = quantile<short , float >(in, p, dim); break;
+            case u16: output = quantile<ushort, float >(in, p, dim); break;
+            case  u8: output = quantile<uchar , float >(in, p, dim); break;
+            default : TYPE_ERROR(1, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -160,3 +160,48 @@ af_err af_set_intersect(af_array *out, const af_array first, const af_array seco
 
     return AF_SUCCESS;
 }
+
+template<typename T>
+static inline af_array isIn(const af_array in, const af_array set)
+{
+    return getHandle(isIn(getArray<T>(in), getArray<T>(set)));
+}
+
+af_err af_isin(af_array *out, const af_array in, const af_array set)
+{
+    try {
+
+        const ArrayInfo& in_info = getInfo(in);
+        const ArrayInfo& set_info = getInfo(set);
+
+        af_dtype in_type = in_info.getType();
+        af_dtype set_type = set_info.getType();
+
+        ARG_ASSERT(2, in_type == set_type);
+
+        af_array res;
+        if (in_info.isEmpty()) {
+            res = getHandle(createEmptyArray<char>(af::dim4(0)));
+        } else if (set_info.isEmpty()) {
+            res = getHandle(createValueArray<char>(in_info.dims(), 0));
+        } else {
+            switch(in_type) {
+                case f32: res = isIn<float  >(in, set); break;
+                case f64: res = isIn<double >(in, set); break;
+                case s32: res = isIn<int    >(in, set); break;
+                case u32: res = isIn<uint   >(in, set); break;
+                case s16: res = isIn<short  >(in, set); break;
+                case u16: res = isIn<ushort >(in, set); break;
+                case s64: res = isIn<intl   >(in, set); break;
+                case u64: res = isIn<uintl  >(in, set); break;
+                case b8:  res = isIn<char   >(in, set); break;
+                case u8:  res = isIn<uchar  >(in, set); break;
+                default: TYPE_ERROR(1, in_type);
+            }
+        }
+
+        std::swap(*out, res);
+    } CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/defines.h>
+#include <af/statistics.h>
+#include <handle.hpp>
+#include <common/err_common.hpp>
+#include <common/sketch.hpp>
+#include <backend.hpp>
+#include <sketch.hpp>
+
+using namespace detail;
+using common::quantile_sketch;
+using common::distinct_sketch;
+
+static quantile_sketch *getQuantileSketch(const af_quantile_sketch handle)
+{
+    if (handle == 0) {
+        AF_ERROR("Uninitialized quantile sketch", AF_ERR_ARG);
+    }
+    return (quantile_sketch *)handle;
+}
+
+static distinct_sketch *getDistinctSketch(const af_distinct_sketch handle)
+{
+    if (handle == 0) {
+        AF_ERROR("Uninitialized distinct sketch", AF_ERR_ARG);
+    }
+    return (distinct_sketch *)handle;
+}
+
+template<typename Sketch>
+static void update(Sketch &sketch, const af_array in)
+{
+    const ArrayInfo& info = getInfo(in);
+    af_dtype type = info.getType();
+    if (info.elements() == 0) return;
+
+    switch(type) {
+        case f32: sketchUpdate(sketch, getArray<float >(in)); break;
+        case f64: sketchUpdate(sketch, getArray<double>(in)); break;
+        case s32: sketchUpdate(sketch, getArray<int   >(in)); break;
+        case u32: sketchUpdate(sketch, getArray<uint  >(in)); break;
+        case s64: sketchUpdate(sketch, getArray<intl  >(in)); break;
+        case u64: sketchUpdate(sketch, getArray<uintl >(in)); break;
+        case s16: sketchUpdate(sketch, getArray<short >(in)); break;
+        case u16: sketchUpdate(sketch, getArray<ushort>(in)); break;
+        case  u8: sketchUpdate(sketch, getArray<uchar >(in)); break;
+        case  b8: sketchUpdate(sketch, getArray<char  >(in)); break;
+        default : TYPE_ERROR(1, type);
+    }
+}
+
+af_err af_create_quantile_sketch(af_quantile_sketch *sketch, const unsigned k)
+{
+    try {
+        ARG_ASSERT(1, k >= common::SKETCH_QUANTILE_MIN_K);
+        *sketch = static_cast<af_quantile_sketch>(new quantile_sketch(k));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_retain_quantile_sketch(af_quantile_sketch *out, const af_quantile_sketch sketch)
+{
+    try {
+        quantile_sketch *in = getQuantileSketch(sketch);
+        *out = static_cast<af_quantile_sketch>(new quantile_sketch(*in));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_quantile_sketch_update(af_quantile_sketch sketch, const af_array in)
+{
+    try {
+        update(*getQuantileSketch(sketch), in);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_quantile_sketch_merge(af_quantile_sketch sketch, const af_quantile_sketch other)
+{
+    try {
+        quantile_sketch *dst = getQuantileSketch(sketch);
+        quantile_sketch *src = getQuantileSketch(other);
+        if (dst != src) {
+            dst->merge(*src);
+        } else {
+            dst->merge(quantile_sketch(*src));
+        }
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_quantile_sketch_get_count(unsigned long long *count,
+                                    const af_quantile_sketch sketch)
+{
+    try {
+        ARG_ASSERT(0, count != 0);
+        *count = getQuantileSketch(sketch)->count();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_quantile_sketch_get_quantiles(double *out, const af_quantile_sketch sketch,
+                                        const double *probs, const unsigned nprobs)
+{
+    try {
+        ARG_ASSERT(0, out != 0);
+        ARG_ASSERT(2, probs != 0);
+        for (unsigned i = 0; i < nprobs; i++) {
+            ARG_ASSERT(2, (probs[i] >= 0 && probs[i] <= 1));
+        }
+        getQuantileSketch(sketch)->quantiles(out, probs, nprobs);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_release_quantile_sketch(af_quantile_sketch sketch)
+{
+    try {
+        delete getQuantileSketch(sketch);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_create_distinct_sketch(af_distinct_sketch *sketch, const unsigned precision)
+{
+    try {
+        ARG_ASSERT(1, (precision >= common::SKETCH_DISTINCT_MIN_PRECISION &&
+                       precision <= common::SKETCH_DISTINCT_MAX_PRECISION));
+        *sketch = static_cast<af_distinct_sketch>(new distinct_sketch(precision));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_retain_distinct_sketch(af_distinct_sketch *out, const af_distinct_sketch sketch)
+{
+    try {
+        distinct_sketch *in = getDistinctSketch(sketch);
+        *out = static_cast<af_distinct_sketch>(new distinct_sketch(*in));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_distinct_sketch_update(af_distinct_sketch sketch, const af_array in)
+{
+    try {
+        update(*getDistinctSketch(sketch), in);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_distinct_sketch_merge(af_distinct_sketch sketch, const af_distinct_sketch other)
+{
+    try {
+        distinct_sketch *dst = getDistinctSketch(sketch);
+        distinct_sketch *src = getDistinctSketch(other);
+        ARG_ASSERT(1, dst->precision() == src->precision());
+        dst->merge(*src);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_distinct_sketch_get_estimate(double *out, const af_distinct_sketch sketch)
+{
+    try {
+        ARG_ASSERT(0, out != 0);
+        *out = getDistinctSketch(sketch)->estimate();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_release_distinct_sketch(af_distinct_sketch sketch)
+{
+    try {
+        delete getDistinctSketch(sketch);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -31,11 +31,6 @@ af_err af_solve(af_array *out, const af_array a, const af_array b, const af_mat_
         const ArrayInfo& a_info = getInfo(a);
         const ArrayInfo& b_info = getInfo(b);
 
-        if (a_info.ndims() > 2 ||
-            b_info.ndims() > 2) {
-            AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
-        }
-
         af_dtype a_type = a_info.getType();
         af_dtype b_type = b_info.getType();
 
@@ -57,7 +52,11 @@ af_err af_solve(af_array *out, const af_array a, const af_array b, const af_mat_
 
         bool is_triangle_solve = (options & AF_MAT_LOWER) || (options & AF_MAT_UPPER);
 
-        if (options != AF_MAT_NONE && !is_triangle_solve) {
+        // Mixed precision only changes how the backend computes the solution,
+        // and is ignored where it does not apply, so it is not validated
+        af_mat_prop props = (af_mat_prop)(options & ~AF_MAT_MIXED_PRECISION);
+
+        if (props != AF_MAT_NONE && !is_triangle_solve) {
             AF_ERROR("Using this property is not yet supported in solve", AF_ERR_NOT_SUPPORTED);
         }
 
@@ -89,11 +89,8 @@ af_err af_transpose_inplace(af_array in, const bool conjugate)
         af_dtype type = info.getType();
         af::dim4 dims = info.dims();
 
-        // InPlace only works on square matrices
-        DIM_ASSERT(0, dims[0] == dims[1]);
-
-        // If singleton element
-        if(dims[0] == 1)
+        // Nothing to move
+        if(dims[0] == 1 && dims[1] == 1 && !conjugate)
             return AF_SUCCESS;
 
         switch(type) {
@@ -21,6 +21,39 @@ namespace af
         return array(out);
     }
 
+    array matmulQuantized(const array &lhs, const array &rhs,
+                          const int lhsZero, const int rhsZero, const double scale,
+                          const matProp optLhs, const matProp optRhs)
+    {
+        af_array out = 0;
+        AF_THROW(af_matmul_quantized(&out, lhs.get(), rhs.get(), optLhs, optRhs,
+                                     lhsZero, rhsZero, scale));
+        return array(out);
+    }
+
+    array matmulFused(const array &lhs, const array &rhs, const array &bias,
+                      const activation act, const double alpha,
+                      const matProp optLhs, const matProp optRhs)
+    {
+        af_array out = 0;
+        AF_THROW(af_matmul_fused(&out, lhs.get(), rhs.get(), optLhs, optRhs,
+                                 alpha, 0, 0.0,
+                                 bias.isempty() ? 0 : bias.get(), act));
+        return array(out);
+    }
+
+    array matmulFused(const array &lhs, const array &rhs,
+                      const array &c, const double beta, const array &bias,
+                      const activation act, const double alpha,
+                      const matProp optLhs, const matProp optRhs)
+    {
+        af_array out = 0;
+        AF_THROW(af_matmul_fused(&out, lhs.get(), rhs.get(), optLhs, optRhs,
+                                 alpha, c.isempty() ? 0 : c.get(), beta,
+                                 bias.isempty() ? 0 : bias.get(), act));
+        return array(out);
+    }
+
     array matmulNT(const array &lhs, const array &rhs)
     {
         af_array out = 0;
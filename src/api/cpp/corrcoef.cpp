@@ -35,4 +35,18 @@ INSTANTIATE_CORRCOEF(unsigned short);
 
 #undef INSTANTIATE_CORRCOEF
 
+array corrcoefMatrix(const array& X, const bool pairwise)
+{
+    af_array temp = 0;
+    AF_THROW(af_corrcoef_matrix(&temp, X.get(), 0, pairwise));
+    return array(temp);
+}
+
+array corrcoefMatrix(const array& X, const array& weights, const bool pairwise)
+{
+    af_array temp = 0;
+    AF_THROW(af_corrcoef_matrix(&temp, X.get(), weights.get(), pairwise));
+    return array(temp);
+}
+
 }
@@ -21,4 +21,19 @@ array cov(const array& X, const array& Y, const bool isbiased)
     return array(temp);
 }
 
+array covMatrix(const array& X, const varBias bias, const bool pairwise)
+{
+    af_array temp = 0;
+    AF_THROW(af_cov_matrix(&temp, X.get(), 0, bias, pairwise));
+    return array(temp);
+}
+
+array covMatrix(const array& X, const array& weights, const varBias bias,
+                const bool pairwise)
+{
+    af_array temp = 0;
+    AF_THROW(af_cov_matrix(&temp, X.get(), weights.get(), bias, pairwise));
+    return array(temp);
+}
+
 }
@@ -33,6 +33,27 @@ array histogram(const array &in, const unsigned nbins)
     return array(out);
 }
 
+array histogram2d(const array &x, const array &y,
+                  const unsigned xbins, const unsigned ybins,
+                  const double xmin, const double xmax,
+                  const double ymin, const double ymax)
+{
+    af_array out = 0;
+    AF_THROW(af_histogram2d(&out, x.get(), y.get(), xbins, ybins,
+                            xmin, xmax, ymin, ymax));
+    return array(out);
+}
+
+array histogram2d(const array &x, const array &y,
+                  const unsigned xbins, const unsigned ybins)
+{
+    af_array out = 0;
+    AF_THROW(af_histogram2d(&out, x.get(), y.get(), xbins, ybins,
+                            min<double>(x), max<double>(x),
+                            min<double>(y), max<double>(y)));
+    return array(out);
+}
+
 array histequal(const array& in, const array& hist) { return histEqual(in, hist); }
 array histEqual(const array& in, const array& hist)
 {
@@ -51,4 +51,11 @@ array setIntersect(const array &first, const array &second, const bool is_unique
     return array(out);
 }
 
+array isIn(const array &in, const array &set)
+{
+    af_array out = 0;
+    AF_THROW(af_isin(&out, in.get(), set.get()));
+    return array(out);
+}
+
 }
@@ -0,0 +1,136 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/statistics.h>
+#include <af/array.h>
+#include "error.hpp"
+
+namespace af
+{
+    quantileSketch::quantileSketch(const unsigned k) : sketch(0)
+    {
+        AF_THROW(af_create_quantile_sketch(&sketch, k));
+    }
+
+    quantileSketch::quantileSketch(const quantileSketch& other) : sketch(0)
+    {
+        if (this != &other) {
+            AF_THROW(af_retain_quantile_sketch(&sketch, other.get()));
+        }
+    }
+
+    quantileSketch::quantileSketch(af_quantile_sketch handle) : sketch(handle)
+    {
+    }
+
+    quantileSketch::~quantileSketch()
+    {
+        if (sketch) {
+            af_release_quantile_sketch(sketch);
+        }
+    }
+
+    quantileSketch& quantileSketch::operator= (const quantileSketch& other)
+    {
+        if (this != &other) {
+            AF_THROW(af_release_quantile_sketch(sketch));
+            AF_THROW(af_retain_quantile_sketch(&sketch, other.get()));
+        }
+        return *this;
+    }
+
+    void quantileSketch::update(const array& in)
+    {
+        AF_THROW(af_quantile_sketch_update(sketch, in.get()));
+    }
+
+    void quantileSketch::merge(const quantileSketch& other)
+    {
+        AF_THROW(af_quantile_sketch_merge(sketch, other.get()));
+    }
+
+    unsigned long long quantileSketch::count() const
+    {
+        unsigned long long n;
+        AF_THROW(af_quantile_sketch_get_count(&n, sketch));
+        return n;
+    }
+
+    double quantileSketch::quantile(const double prob) const
+    {
+        double out;
+        AF_THROW(af_quantile_sketch_get_quantiles(&out, sketch, &prob, 1));
+        return out;
+    }
+
+    void quantileSketch::quantiles(double *out, const double *probs,
+                                   const unsigned nprobs) const
+    {
+        AF_THROW(af_quantile_sketch_get_quantiles(out, sketch, probs, nprobs));
+    }
+
+    af_quantile_sketch quantileSketch::get() const
+    {
+        return sketch;
+    }
+
+    distinctSketch::distinctSketch(const unsigned precision) : sketch(0)
+    {
+        AF_THROW(af_create_distinct_sketch(&sketch, precision));
+    }
+
+    distinctSketch::distinctSketch(const distinctSketch& other) : sketch(0)
+    {
+        if (this != &other) {
+            AF_THROW(af_retain_distinct_sketch(&sketch, other.get()));
+        }
+    }
+
+    distinctSketch::distinctSketch(af_distinct_sketch handle) : sketch(handle)
+    {
+    }
+
+    distinctSketch::~distinctSketch()
+    {
+        if (sketch) {
+            af_release_distinct_sketch(sketch);
+        }
+    }
+
+    distinctSketch& distinctSketch::operator= (const distinctSketch& other)
+    {
+        if (this != &other) {
+            AF_THROW(af_release_distinct_sketch(sketch));
+            AF_THROW(af_retain_distinct_sketch(&sketch, other.get()));
+        }
+        return *this;
+    }
+
+    void distinctSketch::update(const array& in)
+    {
+        AF_THROW(af_distinct_sketch_update(sketch, in.get()));
+    }
+
+    void distinctSketch::merge(const distinctSketch& other)
+    {
+        AF_THROW(af_distinct_sketch_merge(sketch, other.get()));
+    }
+
+    double distinctSketch::estimate() const
+    {
+        double out;
+        AF_THROW(af_distinct_sketch_get_estimate(&out, sketch));
+        return out;
+    }
+
+    af_distinct_sketch distinctSketch::get() const
+    {
+        return sketch;
+    }
+}
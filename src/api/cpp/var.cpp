@@ -30,6 +30,46 @@ array var(const array& in, const array &weights, const dim_t dim)
     return array(temp);
 }
 
+array describe(const array& in, const unsigned stats, const varBias bias,
+               const dim_t dim)
+{
+    af_array temp = 0;
+    AF_THROW(af_describe(&temp, in.get(), stats, bias, getFNSD(dim, in.dims())));
+    return array(temp);
+}
+
+void describe(double *out, const array& in, const unsigned stats,
+              const varBias bias)
+{
+    AF_THROW(af_describe_all(out, in.get(), stats, bias));
+}
+
+#define MOVING(FN, CFN)                                                     \
+    array FN(const array& in, const dim_t window, const dim_t stride,      \
+             const dim_t dim)                                              \
+    {                                                                      \
+        af_array temp = 0;                                                 \
+        AF_THROW(CFN(&temp, in.get(), window, stride,                      \
+                     getFNSD(dim, in.dims())));                            \
+        return array(temp);                                                \
+    }
+
+MOVING(movingSum , af_moving_sum)
+MOVING(movingMean, af_moving_mean)
+MOVING(movingMin , af_moving_min)
+MOVING(movingMax , af_moving_max)
+
+#undef MOVING
+
+array movingVar(const array& in, const dim_t window, const dim_t stride,
+                const varBias bias, const dim_t dim)
+{
+    af_array temp = 0;
+    AF_THROW(af_moving_var(&temp, in.get(), window, stride, bias,
+                           getFNSD(dim, in.dims())));
+    return array(temp);
+}
+
 #define INSTANTIATE_VAR(T)                                          \
     template<> AFAPI T var(const array& in, const bool isbiased)    \
     {                                                               \
@@ -158,3 +158,9 @@ af_err af_set_intersect(af_array *out,
     CHECK_ARRAYS(first, second);
     return CALL(out, first, second, is_unique);
 }
+
+af_err af_isin(af_array *out, const af_array in, const af_array set)
+{
+    CHECK_ARRAYS(in, set);
+    return CALL(out, in, set);
+}
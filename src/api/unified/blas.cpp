@@ -18,6 +18,25 @@ af_err af_matmul( af_array *out ,
     return CALL(out, lhs, rhs, optLhs, optRhs);
 }
 
+af_err af_matmul_quantized(af_array *out,
+        const af_array lhs, const af_array rhs,
+        const af_mat_prop optLhs, const af_mat_prop optRhs,
+        const int lhsZero, const int rhsZero, const double scale)
+{
+    CHECK_ARRAYS(lhs, rhs);
+    return CALL(out, lhs, rhs, optLhs, optRhs, lhsZero, rhsZero, scale);
+}
+
+af_err af_matmul_fused(af_array *out,
+        const af_array lhs, const af_array rhs,
+        const af_mat_prop optLhs, const af_mat_prop optRhs,
+        const double alpha, const af_array c, const double beta,
+        const af_array bias, const af_activation act)
+{
+    CHECK_ARRAYS(lhs, rhs, c, bias);
+    return CALL(out, lhs, rhs, optLhs, optRhs, alpha, c, beta, bias, act);
+}
+
 
 af_err af_dot(af_array *out,
         const af_array lhs, const af_array rhs,
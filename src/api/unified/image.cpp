@@ -117,6 +117,15 @@ af_err af_histogram(af_array *out, const af_array in, const unsigned nbins, cons
     return CALL(out, in, nbins, minval, maxval);
 }
 
+af_err af_histogram2d(af_array *out, const af_array x, const af_array y,
+                      const unsigned xbins, const unsigned ybins,
+                      const double xmin, const double xmax,
+                      const double ymin, const double ymax)
+{
+    CHECK_ARRAYS(x, y);
+    return CALL(out, x, y, xbins, ybins, xmin, xmax, ymin, ymax);
+}
+
 af_err af_dilate(af_array *out, const af_array in, const af_array mask)
 {
     CHECK_ARRAYS(in, mask);
@@ -54,12 +54,74 @@ af_err af_cov(af_array* out, const af_array X, const af_array Y, const bool isbi
     return CALL(out, X, Y, isbiased);
 }
 
+af_err af_cov_matrix(af_array *out, const af_array X, const af_array weights,
+                     const af_var_bias bias, const bool pairwise)
+{
+    CHECK_ARRAYS(X, weights);
+    return CALL(out, X, weights, bias, pairwise);
+}
+
 af_err af_median(af_array* out, const af_array in, const dim_t dim)
 {
     CHECK_ARRAYS(in);
     return CALL(out, in, dim);
 }
 
+af_err af_quantile(af_array* out, const af_array in, const af_array probs, const dim_t dim)
+{
+    CHECK_ARRAYS(in, probs);
+    return CALL(out, in, probs, dim);
+}
+
+af_err af_describe(af_array *out, const af_array in, const unsigned stats,
+                   const af_var_bias bias, const dim_t dim)
+{
+    CHECK_ARRAYS(in);
+    return CALL(out, in, stats, bias, dim);
+}
+
+af_err af_describe_all(double *out, const af_array in, const unsigned stats,
+                       const af_var_bias bias)
+{
+    CHECK_ARRAYS(in);
+    return CALL(out, in, stats, bias);
+}
+
+af_err af_moving_sum(af_array *out, const af_array in, const dim_t window,
+                     const dim_t stride, const dim_t dim)
+{
+    CHECK_ARRAYS(in);
+    return CALL(out, in, window, stride, dim);
+}
+
+af_err af_moving_mean(af_array *out, const af_array in, const dim_t window,
+                      const dim_t stride, const dim_t dim)
+{
+    CHECK_ARRAYS(in);
+    return CALL(out, in, window, stride, dim);
+}
+
+af_err af_moving_min(af_array *out, const af_array in, const dim_t window,
+                     const dim_t stride, const dim_t dim)
+{
+    CHECK_ARRAYS(in);
+    return CALL(out, in, window, stride, dim);
+}
+
+af_err af_moving_max(af_array *out, const af_array in, const dim_t window,
+                     const dim_t stride, const dim_t dim)
+{
+    CHECK_ARRAYS(in);
+    return CALL(out, in, window, stride, dim);
+}
+
+af_err af_moving_var(af_array *out, const af_array in, const dim_t window,
+                     const dim_t stride, const af_var_bias bias, const dim_t dim)
+{
+    CHECK_ARRAYS(in);
+    return CALL(out, in, window, stride, bias, dim);
+}
+
 af_err af_mean_all(double *real, double *imag, const af_array in)
 {
     CHECK_ARRAYS(in);
@@ -102,9 +164,85 @@ af_err af_corrcoef(double *realVal, double *imagVal, const af_array X, const af_
     return CALL(realVal, imagVal, X, Y);
 }
 
+af_err af_corrcoef_matrix(af_array *out, const af_array X, const af_array weights,
+                          const bool pairwise)
+{
+    CHECK_ARRAYS(X, weights);
+    return CALL(out, X, weights, pairwise);
+}
+
 af_err af_topk(af_array *values, af_array *indices, const af_array in,
                const int k, const int dim, const af_topk_function order)
 {
     CHECK_ARRAYS(in);
     return CALL(values, indices, in, k, dim, order);
 }
+
+af_err af_create_quantile_sketch(af_quantile_sketch *sketch, const unsigned k)
+{
+    return CALL(sketch, k);
+}
+
+af_err af_retain_quantile_sketch(af_quantile_sketch *out, const af_quantile_sketch sketch)
+{
+    return CALL(out, sketch);
+}
+
+af_err af_quantile_sketch_update(af_quantile_sketch sketch, const af_array in)
+{
+    CHECK_ARRAYS(in);
+    return CALL(sketch, in);
+}
+
+af_err af_quantile_sketch_merge(af_quantile_sketch sketch, const af_quantile_sketch other)
+{
+    return CALL(sketch, other);
+}
+
+af_err af_quantile_sketch_get_count(unsigned long long *count,
+                                    const af_quantile_sketch sketch)
+{
+    return CALL(count, sketch);
+}
+
+af_err af_quantile_sketch_get_quantiles(double *out, const af_quantile_sketch sketch,
+                                        const double *probs, const unsigned nprobs)
+{
+    return CALL(out, sketch, probs, nprobs);
+}
+
+af_err af_release_quantile_sketch(af_quantile_sketch sketch)
+{
+    return CALL(sketch);
+}
+
+af_err af_create_distinct_sketch(af_distinct_sketch *sketch, const unsigned precision)
+{
+    return CALL(sketch, precision);
+}
+
+af_err af_retain_distinct_sketch(af_distinct_sketch *out, const af_distinct_sketch sketch)
+{
+    return CALL(out, sketch);
+}
+
+af_err af_distinct_sketch_update(af_distinct_sketch sketch, const af_array in)
+{
+    CHECK_ARRAYS(in);
+    return CALL(sketch, in);
+}
+
+af_err af_distinct_sketch_merge(af_distinct_sketch sketch, const af_distinct_sketch other)
+{
+    return CALL(sketch, other);
+}
+
+af_err af_distinct_sketch_get_estimate(double *out, const af_distinct_sketch sketch)
+{
+    return CALL(out, sketch);
+}
+
+af_err af_release_distinct_sketch(af_distinct_sketch sketch)
+{
+    return CALL(sketch);
+}
@@ -0,0 +1,228 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+// Host implementation of the integer matrix multiply, shared by all the
+// backends as none of the BLAS libraries provide one
+
+namespace common
+{
+
+// Rows of op(lhs), columns of op(rhs) and depth of the blocks packed at a time
+static const dim_t IGEMM_MC = 64;
+static const dim_t IGEMM_NC = 64;
+static const dim_t IGEMM_KC = 512;
+
+// Bytes are widened to 16 bits when packed, so that, after subtracting a zero
+// point, pairs of them are multiplied and added into 32 bit accumulators
+// (pmaddwd on x86, smlal on ARM) by the vectorized inner loops
+template<typename Ti, typename To>
+using igemm_pack_t = typename std::conditional<sizeof(Ti) == 1, short, To>::type;
+
+// Accumulator of the dot products of a block. Bytes minus their zero points
+// are at most 255 in magnitude, so IGEMM_KC of their products cannot overflow
+// 32 bits. Wider types are accumulated modulo 2^64, which avoids signed
+// overflow and is exact whenever the result fits in the output type.
+template<typename Ti>
+using igemm_acc_t = typename std::conditional<sizeof(Ti) == 1, int,
+                                              unsigned long long>::type;
+
+// Adds a block of dot products to an output element, modulo the size of To
+template<typename To, typename A>
+static inline To igemmAdd(const To out, const A sum)
+{
+    return (To)((unsigned long long)out + (unsigned long long)sum);
+}
+
+// Copies rows [r0, r0 + rows) and columns [k0, k0 + depth) of op(X) to dst,
+// one row after the other, minus zero
+template<typename Ti, typename P>
+static void igemmPack(P *dst, const Ti *src, const dim_t ld, const bool trans,
+                      const dim_t r0, const dim_t rows,
+                      const dim_t k0, const dim_t depth, const int zero)
+{
+    for (dim_t r = 0; r < rows; r++) {
+        P *row = dst + r * depth;
+        if (trans) {
+            const Ti *col = src + (r0 + r) * ld + k0;
+            for (dim_t k = 0; k < depth; k++) row[k] = (P)col[k] - (P)zero;
+        } else {
+            const Ti *ptr = src + (r0 + r) + k0 * ld;
+            for (dim_t k = 0; k < depth; k++) row[k] = (P)ptr[k * ld] - (P)zero;
+        }
+    }
+}
+
+// Adds the products of the packed rows of op(lhs) and op(rhs)^T to the mc x nc
+// block at out. Four columns are computed at a time so that every row of
+// op(lhs) is read once for four dot products.
+template<typename A, typename P, typename To>
+static void igemmBlock(To *out, const dim_t ldo, const P *lpack, const P *rpack,
+                       const dim_t mc, const dim_t nc, const dim_t kc, const bool first)
+{
+    dim_t j = 0;
+    for (; j + 4 <= nc; j += 4) {
+        const P *b0 = rpack + (j + 0) * kc;
+        const P *b1 = rpack + (j + 1) * kc;
+        const P *b2 = rpack + (j + 2) * kc;
+        const P *b3 = rpack + (j + 3) * kc;
+        for (dim_t i = 0; i < mc; i++) {
+            const P *a = lpack + i * kc;
+            A s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            for (dim_t k = 0; k < kc; k++) {
+                const A av = (A)a[k];
+                s0 += av * (A)b0[k];
+                s1 += av * (A)b1[k];
+                s2 += av * (A)b2[k];
+                s3 += av * (A)b3[k];
+            }
+            To *o = out + i;
+            const To z = 0;
+            o[(j + 0) * ldo] = igemmAdd(first ? z : o[(j + 0) * ldo], s0);
+            o[(j + 1) * ldo] = igemmAdd(first ? z : o[(j + 1) * ldo], s1);
+            o[(j + 2) * ldo] = igemmAdd(first ? z : o[(j + 2) * ldo], s2);
+            o[(j + 3) * ldo] = igemmAdd(first ? z : o[(j + 3) * ldo], s3);
+        }
+    }
+    for (; j < nc; j++) {
+        const P *b = rpack + j * kc;
+        for (dim_t i = 0; i < mc; i++) {
+            const P *a = lpack + i * kc;
+            A s = 0;
+            for (dim_t k = 0; k < kc; k++) s += (A)a[k] * (A)b[k];
+            out[i + j * ldo] = igemmAdd(first ? To(0) : out[i + j * ldo], s);
+        }
+    }
+}
+
+// Number of independent tasks igemmPackLhs splits the packing of op(lhs)
+// into: every batch of lhs is split into blocks of IGEMM_MC rows
+static inline dim_t igemmLhsTasks(const af::dim4 &lDims, const dim_t M)
+{
+    const dim_t rowBlocks = (M + IGEMM_MC - 1) / IGEMM_MC;
+    return lDims[2] * lDims[3] * rowBlocks;
+}
+
+// Packs the blocks of rows of op(lhs) - lZero of the tasks [begin, end) to
+// lpack, which holds M * K elements per batch of lhs. The block of rows i0
+// and depth k0 of a batch starts at k0 * M + i0 * kc, where kc is the depth of
+// the block, so that every block is packed only once for all the output
+// columns.
+template<typename Ti, typename P>
+void igemmPackLhs(P *lpack, const dim_t M, const dim_t K,
+                  const Ti *lhs, const af::dim4 &lDims, const af::dim4 &lStrides,
+                  const bool lTrans, const int lZero,
+                  const dim_t begin, const dim_t end)
+{
+    const dim_t rowBlocks = (M + IGEMM_MC - 1) / IGEMM_MC;
+
+    for (dim_t t = begin; t < end; t++) {
+        const dim_t batch = t / rowBlocks;
+        const dim_t i0    = (t - batch * rowBlocks) * IGEMM_MC;
+        const dim_t mc    = std::min(IGEMM_MC, M - i0);
+        const dim_t w     = batch / lDims[2];
+        const dim_t z     = batch - w * lDims[2];
+
+        const Ti *lptr = lhs + z * lStrides[2] + w * lStrides[3];
+        P *dst = lpack + batch * M * K;
+        for (dim_t k0 = 0; k0 < K; k0 += IGEMM_KC) {
+            const dim_t kc = std::min(IGEMM_KC, K - k0);
+            igemmPack(dst + k0 * M + i0 * kc, lptr, lStrides[1], lTrans,
+                      i0, mc, k0, kc, lZero);
+        }
+    }
+}
+
+// Number of independent tasks igemmPacked splits a batched product into:
+// every batch is split into blocks of IGEMM_NC output columns
+static inline dim_t igemmTasks(const af::dim4 &oDims)
+{
+    const dim_t colBlocks = (oDims[1] + IGEMM_NC - 1) / IGEMM_NC;
+    return oDims[2] * oDims[3] * colBlocks;
+}
+
+// Computes the output columns of the tasks [begin, end) of
+// out = (op(lhs) - lZero) * (op(rhs) - rZero), where lpack holds op(lhs) -
+// lZero as packed by igemmPackLhs. Matrices of size 1 along the batch
+// dimensions are broadcast, as in matmul.
+template<typename Ti, typename P, typename To>
+void igemmPacked(To *out, const af::dim4 &oDims, const af::dim4 &oStrides,
+                 const P *lpack, const af::dim4 &lDims, const dim_t K,
+                 const Ti *rhs, const af::dim4 &rDims, const af::dim4 &rStrides,
+                 const bool rTrans, const int rZero,
+                 const dim_t begin, const dim_t end)
+{
+    const dim_t M = oDims[0];
+    const dim_t N = oDims[1];
+    const dim_t colBlocks = (N + IGEMM_NC - 1) / IGEMM_NC;
+
+    std::vector<P> rpack(IGEMM_NC * IGEMM_KC);
+
+    for (dim_t t = begin; t < end; t++) {
+        const dim_t batch = t / colBlocks;
+        const dim_t j0    = (t - batch * colBlocks) * IGEMM_NC;
+        const dim_t nc    = std::min(IGEMM_NC, N - j0);
+        const dim_t w     = batch / oDims[2];
+        const dim_t z     = batch - w * oDims[2];
+
+        const dim_t lz = z * (lDims[2] == oDims[2]);
+        const dim_t lw = w * (lDims[3] == oDims[3]);
+        const P *lptr  = lpack + (lw * lDims[2] + lz) * M * K;
+        const Ti *rptr = rhs + z * (rDims[2] == oDims[2]) * rStrides[2]
+                             + w * (rDims[3] == oDims[3]) * rStrides[3];
+        To *optr = out + z * oStrides[2] + w * oStrides[3] + j0 * oStrides[1];
+
+        if (K == 0) {
+            for (dim_t j = 0; j < nc; j++) {
+                std::fill(optr + j * oStrides[1], optr + j * oStrides[1] + M, To(0));
+            }
+            continue;
+        }
+
+        for (dim_t k0 = 0; k0 < K; k0 += IGEMM_KC) {
+            const dim_t kc = std::min(IGEMM_KC, K - k0);
+            // Rows of op(rhs)^T are columns of op(rhs)
+            igemmPack(rpack.data(), rptr, rStrides[1], !rTrans, j0, nc, k0, kc, rZero);
+            for (dim_t i0 = 0; i0 < M; i0 += IGEMM_MC) {
+                const dim_t mc = std::min(IGEMM_MC, M - i0);
+                igemmBlock<igemm_acc_t<Ti> >(optr + i0, oStrides[1],
+                                             lptr + k0 * M + i0 * kc, rpack.data(),
+                                             mc, nc, kc, k0 == 0);
+            }
+        }
+    }
+}
+
+// Computes out = (op(lhs) - lZero) * (op(rhs) - rZero) on the calling thread
+template<typename Ti, typename To>
+void igemm(To *out, const af::dim4 &oDims, const af::dim4 &oStrides,
+           const Ti *lhs, const af::dim4 &lDims, const af::dim4 &lStrides,
+           const bool lTrans, const int lZero,
+           const Ti *rhs, const af::dim4 &rDims, const af::dim4 &rStrides,
+           const bool rTrans, const int rZero)
+{
+    typedef igemm_pack_t<Ti, To> P;
+
+    const dim_t M = oDims[0];
+    const dim_t K = lTrans ? lDims[0] : lDims[1];
+
+    std::vector<P> lpack(lDims[2] * lDims[3] * M * K);
+    igemmPackLhs(lpack.data(), M, K, lhs, lDims, lStrides, lTrans, lZero,
+                 0, igemmLhsTasks(lDims, M));
+    igemmPacked(out, oDims, oStrides, lpack.data(), lDims, K,
+                rhs, rDims, rStrides, rTrans, rZero, 0, igemmTasks(oDims));
+}
+
+}
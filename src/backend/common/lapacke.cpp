@@ -135,6 +135,33 @@ LAPACK_FUNC(d, double, double*)
 LAPACK_FUNC(c, cfloat, __CLPK_complex*)
 LAPACK_FUNC(z, cdouble, __CLPK_doublecomplex*)
 
+int LAPACKE_dsgesv(int layout, int N, int nrhs, double *A, int lda, int *pivot,
+                   double *B, int ldb, double *X, int ldx, int *iter)
+{
+    UNUSED(layout);
+    std::vector<double> work(N * nrhs);
+    std::vector<float> swork(N * (N + nrhs));
+    int info = 0;
+    dsgesv_(&N, &nrhs, A, &lda, pivot, B, &ldb, X, &ldx,
+            &work[0], &swork[0], iter, &info);
+    return info;
+}
+
+int LAPACKE_zcgesv(int layout, int N, int nrhs, cdouble *A, int lda, int *pivot,
+                   cdouble *B, int ldb, cdouble *X, int ldx, int *iter)
+{
+    UNUSED(layout);
+    std::vector<cdouble> work(N * nrhs);
+    std::vector<cfloat> swork(N * (N + nrhs));
+    std::vector<double> rwork(N);
+    int info = 0;
+    zcgesv_(&N, &nrhs, (__CLPK_doublecomplex*)A, &lda, pivot,
+            (__CLPK_doublecomplex*)B, &ldb, (__CLPK_doublecomplex*)X, &ldx,
+            (__CLPK_doublecomplex*)&work[0], (__CLPK_complex*)&swork[0],
+            &rwork[0], iter, &info);
+    return info;
+}
+
 #define LAPACK_GQR(P, X, T, TO)                                                     \
 int LAPACKE_##X##P(int layout, int M, int N, int K, T *A, int lda, const T *tau)    \
 {                                                                                   \
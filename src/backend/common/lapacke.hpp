@@ -40,6 +40,11 @@ LAPACK_FUNC(d, double)
 LAPACK_FUNC(c, cfloat)
 LAPACK_FUNC(z, cdouble)
 
+int LAPACKE_dsgesv(int layout, int N, int nrhs, double *A, int lda, int *pivot,
+                   double *B, int ldb, double *X, int ldx, int *iter);
+int LAPACKE_zcgesv(int layout, int N, int nrhs, cdouble *A, int lda, int *pivot,
+                   cdouble *B, int ldb, cdouble *X, int ldx, int *iter);
+
 #define LAPACK_GQR(P, X, T)                                                         \
 int LAPACKE_##X##P(int layout, int M, int N, int K, T *A, int lda, const T *tau);   \
 
@@ -0,0 +1,231 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Host implementation of the moving window statistics of a single series,
+// shared by all the backends
+
+namespace common
+{
+
+// Running sum of the values in a window. Values enter and leave the sum
+// with Neumaier's compensated addition so that the error does not grow with
+// the number of slides. Non-finite values are only counted.
+class moving_sum
+{
+    double sum;
+    double comp;
+    dim_t nans;
+    dim_t pinf;
+    dim_t ninf;
+
+    void accumulate(double val)
+    {
+        double t = sum + val;
+        if (std::fabs(sum) >= std::fabs(val)) comp += (sum - t) + val;
+        else                                  comp += (val - t) + sum;
+        sum = t;
+    }
+
+    void count(double val, dim_t inc)
+    {
+        if (val != val) nans += inc;
+        else if (val > 0) pinf += inc;
+        else ninf += inc;
+    }
+
+public:
+    moving_sum() { reset(); }
+
+    void reset() { sum = comp = 0; nans = pinf = ninf = 0; }
+
+    void add(double val)
+    {
+        if (std::isfinite(val)) accumulate(val);
+        else count(val, 1);
+    }
+
+    void remove(double val)
+    {
+        if (std::isfinite(val)) accumulate(-val);
+        else count(val, -1);
+    }
+
+    double value() const
+    {
+        if (nans || (pinf && ninf)) return std::numeric_limits<double>::quiet_NaN();
+        if (pinf) return  std::numeric_limits<double>::infinity();
+        if (ninf) return -std::numeric_limits<double>::infinity();
+        return sum + comp;
+    }
+};
+
+// Running mean and sum of squared differences from the mean of the values in
+// a window, updated with Welford's algorithm as values enter and leave.
+// Windows containing non-finite values have a NaN variance.
+class moving_var
+{
+    double count;
+    double mean;
+    double m2;
+    dim_t nonfinite;
+
+public:
+    moving_var() { reset(); }
+
+    void reset() { count = mean = m2 = 0; nonfinite = 0; }
+
+    void add(double val)
+    {
+        if (!std::isfinite(val)) { nonfinite++; return; }
+        count++;
+        double delta = val - mean;
+        mean += delta / count;
+        m2   += delta * (val - mean);
+    }
+
+    void remove(double val)
+    {
+        if (!std::isfinite(val)) { nonfinite--; return; }
+        if (count <= 1) { count = mean = m2 = 0; return; }
+        count--;
+        double delta = val - mean;
+        mean -= delta / count;
+        m2   -= delta * (val - mean);
+        m2    = std::max(m2, 0.0);
+    }
+
+    double value(const af_var_bias bias) const
+    {
+        double denom = (bias == AF_VARIANCE_SAMPLE) ? count - 1 : count;
+        if (nonfinite || denom <= 0) return std::numeric_limits<double>::quiet_NaN();
+        return m2 / denom;
+    }
+};
+
+// Computes the windows [k * step, k * step + window), k in [kbegin, kend), of
+// the series in[i * istride] using a running accumulator. Elements between
+// consecutive windows are removed and the new ones added, restarting when
+// the windows do not overlap. The accumulator is also restarted after every
+// window worth of removals, which bounds the drift of the updates at an
+// amortized cost of one extra addition per element.
+template<typename Ti, typename To, typename Acc, typename Value>
+void movingRunning(To *out, const dim_t ostride, const Ti *in, const dim_t istride,
+                   const dim_t window, const dim_t step,
+                   const dim_t kbegin, const dim_t kend, Value value)
+{
+    Acc acc;
+    dim_t lo = kbegin * step, hi = lo, removed = 0;
+    for (dim_t k = kbegin; k < kend; k++) {
+        const dim_t begin = k * step;
+        const dim_t end   = begin + window;
+
+        if (begin >= hi || removed >= window) {
+            acc.reset();
+            lo = hi = begin;
+            removed = 0;
+        }
+        for (; lo < begin; lo++, removed++) acc.remove((double)in[lo * istride]);
+        for (; hi < end; hi++) acc.add((double)in[hi * istride]);
+
+        out[k * ostride] = (To)value(acc);
+    }
+}
+
+// Computes the minimum (isMin) or maximum of the windows [k * step,
+// k * step + window), k in [kbegin, kend), of the series in[i * istride].
+// The indices of the candidates are kept in a monotonic queue, so every
+// element is pushed and popped at most once. NaNs are skipped, and windows
+// of NaNs only are NaN.
+template<typename Ti, typename To, bool isMin>
+void movingExtrema(To *out, const dim_t ostride, const Ti *in, const dim_t istride,
+                   const dim_t window, const dim_t step,
+                   const dim_t kbegin, const dim_t kend, std::vector<dim_t> &queue)
+{
+    // Circular buffer holding the indices of the candidates of the window
+    queue.resize(window);
+    dim_t head = 0, size = 0;
+    dim_t next = kbegin * step;
+
+    auto beats = [](Ti a, Ti b) { return isMin ? (a <= b) : (a >= b); };
+
+    for (dim_t k = kbegin; k < kend; k++) {
+        const dim_t begin = k * step;
+        const dim_t end   = begin + window;
+
+        while (size && queue[head] < begin) {
+            head = (head + 1) % window;
+            size--;
+        }
+
+        for (dim_t i = std::max(next, begin); i < end; i++) {
+            Ti val = in[i * istride];
+            if (val != val) continue;
+            while (size && beats(val, in[queue[(head + size - 1) % window] * istride])) {
+                size--;
+            }
+            queue[(head + size) % window] = i;
+            size++;
+        }
+        next = end;
+
+        out[k * ostride] = size ? (To)in[queue[head] * istride]
+                                : std::numeric_limits<To>::quiet_NaN();
+    }
+}
+
+// Computes the statistic stat of the windows [k * step, k * step + window),
+// k in [kbegin, kend), of the series in[i * istride] and writes them to
+// out[k * ostride]. queue is scratch space for the minimum and maximum.
+template<typename Ti, typename To>
+void movingSeries(To *out, const dim_t ostride, const Ti *in, const dim_t istride,
+                  const af_stat_type stat, const dim_t window, const dim_t step,
+                  const af_var_bias bias, const dim_t kbegin, const dim_t kend,
+                  std::vector<dim_t> &queue)
+{
+    switch (stat) {
+    case AF_STAT_MIN:
+        movingExtrema<Ti, To, true>(out, ostride, in, istride, window, step,
+                                    kbegin, kend, queue);
+        break;
+    case AF_STAT_MAX:
+        movingExtrema<Ti, To, false>(out, ostride, in, istride, window, step,
+                                     kbegin, kend, queue);
+        break;
+    case AF_STAT_SUM:
+        movingRunning<Ti, To, moving_sum>(out, ostride, in, istride, window, step,
+                                          kbegin, kend,
+                                          [](const moving_sum &acc) {
+                                              return acc.value();
+                                          });
+        break;
+    case AF_STAT_MEAN:
+        movingRunning<Ti, To, moving_sum>(out, ostride, in, istride, window, step,
+                                          kbegin, kend,
+                                          [window](const moving_sum &acc) {
+                                              return acc.value() / window;
+                                          });
+        break;
+    default:
+        movingRunning<Ti, To, moving_var>(out, ostride, in, istride, window, step,
+                                          kbegin, kend,
+                                          [bias](const moving_var &acc) {
+                                              return acc.value(bias);
+                                          });
+        break;
+    }
+}
+
+}
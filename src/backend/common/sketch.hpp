@@ -0,0 +1,293 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Host implementation of the mergeable streaming sketches behind the
+// af_quantile_sketch and af_distinct_sketch handles, shared by all the
+// backends
+
+namespace common
+{
+
+// Default and smallest accuracy parameter of a quantile sketch
+static const unsigned SKETCH_QUANTILE_K     = 200;
+static const unsigned SKETCH_QUANTILE_MIN_K = 8;
+
+// Default and valid range of the precision of a distinct count sketch
+static const unsigned SKETCH_DISTINCT_PRECISION     = 14;
+static const unsigned SKETCH_DISTINCT_MIN_PRECISION = 4;
+static const unsigned SKETCH_DISTINCT_MAX_PRECISION = 18;
+
+// KLL quantile sketch. Values are kept in a stack of compactors, the items of
+// level h standing for 2^h inserted values. When the sketch is full, the
+// lowest level over its capacity is sorted and every other item, starting
+// from a random offset, is promoted to the level above. The capacities shrink
+// by 2/3 from the top level down, so the sketch holds O(k) items and the rank
+// error is O(1/k) regardless of the number of values inserted.
+class quantile_sketch
+{
+    unsigned k;
+    unsigned long long n;
+    double minVal;
+    double maxVal;
+    unsigned long long state;
+    std::vector<std::vector<double> > levels;
+    size_t size;
+    size_t capacity;
+
+    size_t levelCapacity(size_t h) const
+    {
+        const double depth = (double)(levels.size() - 1 - h);
+        const double cap   = std::ceil(k * std::pow(2.0 / 3.0, depth));
+        return std::max((size_t)cap, (size_t)2);
+    }
+
+    void updateSize()
+    {
+        size = capacity = 0;
+        for (size_t h = 0; h < levels.size(); h++) {
+            size     += levels[h].size();
+            capacity += levelCapacity(h);
+        }
+    }
+
+    // xorshift64*
+    unsigned long long random()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+
+    void compress()
+    {
+        for (size_t h = 0; h < levels.size(); h++) {
+            if (levels[h].size() < levelCapacity(h)) continue;
+            if (h + 1 == levels.size()) levels.emplace_back();
+
+            std::vector<double> &level = levels[h];
+            std::vector<double> &next  = levels[h + 1];
+
+            // An odd item out stays on this level
+            const size_t keep = level.size() % 2;
+            std::sort(level.begin() + keep, level.end());
+            for (size_t i = keep + (random() >> 63); i < level.size(); i += 2) {
+                next.push_back(level[i]);
+            }
+            level.resize(keep);
+            break;
+        }
+        updateSize();
+    }
+
+public:
+    explicit quantile_sketch(unsigned k = SKETCH_QUANTILE_K,
+                             unsigned long long seed = 0)
+        : k(std::max(k, SKETCH_QUANTILE_MIN_K)), n(0),
+          minVal( std::numeric_limits<double>::infinity()),
+          maxVal(-std::numeric_limits<double>::infinity()),
+          state(seed * 0x9E3779B97F4A7C15ULL + 0x2545F4914F6CDD1DULL),
+          levels(1), size(0), capacity(0)
+    {
+        updateSize();
+    }
+
+    unsigned accuracy() const { return k; }
+
+    unsigned long long count() const { return n; }
+
+    // Seed for a sketch whose values will be merged into this one
+    unsigned long long split() { return random(); }
+
+    // NaNs are skipped
+    void insert(double val)
+    {
+        if (val != val) return;
+        n++;
+        minVal = std::min(minVal, val);
+        maxVal = std::max(maxVal, val);
+        levels[0].push_back(val);
+        if (++size >= capacity) compress();
+    }
+
+    void merge(const quantile_sketch &other)
+    {
+        if (other.n == 0) return;
+        if (levels.size() < other.levels.size()) levels.resize(other.levels.size());
+        for (size_t h = 0; h < other.levels.size(); h++) {
+            levels[h].insert(levels[h].end(),
+                             other.levels[h].begin(), other.levels[h].end());
+        }
+        n     += other.n;
+        minVal = std::min(minVal, other.minVal);
+        maxVal = std::max(maxVal, other.maxVal);
+        updateSize();
+        while (size >= capacity) compress();
+    }
+
+    // Writes the values at the normalized ranks probs[i] to out[i]. The
+    // quantiles of an empty sketch are NaN.
+    void quantiles(double *out, const double *probs, const unsigned nprobs) const
+    {
+        if (n == 0) {
+            std::fill(out, out + nprobs, std::numeric_limits<double>::quiet_NaN());
+            return;
+        }
+
+        std::vector<std::pair<double, double> > items;
+        items.reserve(size);
+        for (size_t h = 0; h < levels.size(); h++) {
+            const double weight = std::ldexp(1.0, (int)h);
+            for (size_t i = 0; i < levels[h].size(); i++) {
+                items.push_back(std::make_pair(levels[h][i], weight));
+            }
+        }
+        std::sort(items.begin(), items.end());
+
+        std::vector<double> ranks(items.size());
+        double total = 0;
+        for (size_t i = 0; i < items.size(); i++) {
+            total   += items[i].second;
+            ranks[i] = total;
+        }
+
+        for (unsigned i = 0; i < nprobs; i++) {
+            if (probs[i] <= 0) { out[i] = minVal; continue; }
+            if (probs[i] >= 1) { out[i] = maxVal; continue; }
+            size_t idx = std::lower_bound(ranks.begin(), ranks.end(),
+                                          probs[i] * total) - ranks.begin();
+            out[i] = items[std::min(idx, items.size() - 1)].first;
+        }
+    }
+};
+
+// Key of a value for distinct counting. Integral values hash alike whatever
+// their type, and both zeros are the same value.
+template<typename T>
+static inline unsigned long long sketchKey(T val)
+{
+    return (unsigned long long)val;
+}
+
+static inline unsigned long long sketchKey(double val)
+{
+    if (val == 0) return 0;
+    if (std::floor(val) == val && std::fabs(val) < 9.2e18) {
+        return (unsigned long long)(long long)val;
+    }
+    unsigned long long bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    return bits;
+}
+
+static inline unsigned long long sketchKey(float val)
+{
+    return sketchKey((double)val);
+}
+
+static inline unsigned long long sketchKey(long long val)
+{
+    return (unsigned long long)val;
+}
+
+// SplitMix64 finalizer
+static inline unsigned long long sketchHash(unsigned long long key)
+{
+    key += 0x9E3779B97F4A7C15ULL;
+    key  = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key  = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+static inline unsigned leadingZeros(unsigned long long val)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanReverse64(&idx, val);
+    return 63 - idx;
+#else
+    return __builtin_clzll(val);
+#endif
+}
+
+// HyperLogLog distinct count sketch with 2^precision registers. Every
+// register keeps the longest run of leading zeros seen in the hashes routed
+// to it, and merging takes the larger register. The relative standard error
+// of the estimate is 1.04 / sqrt(2^precision).
+class distinct_sketch
+{
+    unsigned p;
+    std::vector<unsigned char> registers;
+
+public:
+    explicit distinct_sketch(unsigned precision = SKETCH_DISTINCT_PRECISION)
+        : p(precision), registers((size_t)1 << precision, 0)
+    {}
+
+    unsigned precision() const { return p; }
+
+    // NaNs are skipped
+    template<typename T>
+    void insert(T val)
+    {
+        if (val != val) return;
+        const unsigned long long hash = sketchHash(sketchKey(val));
+        const size_t idx = (size_t)(hash >> (64 - p));
+        // The guard bit bounds the rank when the remaining bits are zero
+        const unsigned long long rest = (hash << p) | (1ULL << (p - 1));
+        const unsigned char rank = (unsigned char)(leadingZeros(rest) + 1);
+        registers[idx] = std::max(registers[idx], rank);
+    }
+
+    void merge(const distinct_sketch &other)
+    {
+        for (size_t i = 0; i < registers.size(); i++) {
+            registers[i] = std::max(registers[i], other.registers[i]);
+        }
+    }
+
+    double estimate() const
+    {
+        const double m = (double)registers.size();
+        double alpha;
+        switch (p) {
+        case 4:  alpha = 0.673; break;
+        case 5:  alpha = 0.697; break;
+        case 6:  alpha = 0.709; break;
+        default: alpha = 0.7213 / (1.0 + 1.079 / m); break;
+        }
+
+        double sum = 0;
+        size_t zeros = 0;
+        for (size_t i = 0; i < registers.size(); i++) {
+            sum   += std::ldexp(1.0, -(int)registers[i]);
+            zeros += registers[i] == 0;
+        }
+
+        // Linear counting is more accurate for small cardinalities
+        const double est = alpha * m * m / sum;
+        if (est <= 2.5 * m && zeros) return m * std::log(m / zeros);
+        return est;
+    }
+};
+
+}
@@ -0,0 +1,228 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <utility>
+
+// Host factorizations of matrices small enough for the overhead of a LAPACK
+// call to dominate. The order is a template parameter, so the loops are
+// unrolled and the matrix stays in registers or L1. The results follow the
+// LAPACK conventions (packed LU with 1-based row interchanges, info codes), so
+// batches can mix these kernels and LAPACK. Complex matrices are expected as
+// std::complex.
+
+namespace common
+{
+
+// Largest order handled by the unrolled kernels
+static const int SMALL_LAPACK_MAX = 16;
+
+// Minimum number of flops handled by a single thread when batches of matrices
+// are factorized concurrently
+static const dim_t LAPACK_BATCH_GRAIN = 1 << 15;
+
+// Offset of matrix n of a batch along dimensions 2 and 3
+static inline dim_t batchOffset(const af::dim4 &dims, const af::dim4 &strides,
+                                const dim_t n)
+{
+    const dim_t w = n / dims[2];
+    const dim_t z = n - w * dims[2];
+    return z * strides[2] + w * strides[3];
+}
+
+// Number of matrices processed by a thread for matrices of order n
+static inline dim_t lapackBatchGrain(const dim_t n)
+{
+    return std::max(LAPACK_BATCH_GRAIN / std::max(n * n * n, (dim_t)1), (dim_t)1);
+}
+
+template<typename T> static inline T conjugate(const T val) { return val; }
+template<typename T> static inline std::complex<T> conjugate(const std::complex<T> val)
+{ return std::conj(val); }
+
+template<typename T> static inline T realPart(const T val) { return val; }
+template<typename T> static inline T realPart(const std::complex<T> val)
+{ return val.real(); }
+
+// Magnitude used to choose pivots, |re| + |im| for complex values as in LAPACK
+template<typename T> static inline T pivotAbs(const T val) { return std::abs(val); }
+template<typename T> static inline T pivotAbs(const std::complex<T> val)
+{ return std::abs(val.real()) + std::abs(val.imag()); }
+
+// LU factorization with partial pivoting, as getrf
+template<typename T, int N>
+int getrfSmall(T *a, const dim_t lda, int *ipiv)
+{
+    int info = 0;
+    for (int k = 0; k < N; k++) {
+        int p = k;
+        auto best = pivotAbs(a[k + k * lda]);
+        for (int i = k + 1; i < N; i++) {
+            auto val = pivotAbs(a[i + k * lda]);
+            if (val > best) { best = val; p = i; }
+        }
+        ipiv[k] = p + 1;
+
+        if (best == 0) {
+            if (info == 0) info = k + 1;
+            continue;
+        }
+
+        if (p != k) {
+            for (int j = 0; j < N; j++) std::swap(a[k + j * lda], a[p + j * lda]);
+        }
+
+        const T inv = T(1) / a[k + k * lda];
+        for (int i = k + 1; i < N; i++) a[i + k * lda] *= inv;
+        for (int j = k + 1; j < N; j++) {
+            const T akj = a[k + j * lda];
+            for (int i = k + 1; i < N; i++) a[i + j * lda] -= a[i + k * lda] * akj;
+        }
+    }
+    return info;
+}
+
+// Solves A X = B given the factorization of getrfSmall, as getrs
+template<typename T, int N>
+void getrsSmall(const T *lu, const dim_t lda, const int *ipiv,
+                T *b, const dim_t ldb, const dim_t nrhs)
+{
+    for (dim_t c = 0; c < nrhs; c++) {
+        T *x = b + c * ldb;
+        for (int k = 0; k < N; k++) {
+            if (ipiv[k] - 1 != k) std::swap(x[k], x[ipiv[k] - 1]);
+        }
+        for (int j = 0; j < N; j++) {
+            for (int i = j + 1; i < N; i++) x[i] -= lu[i + j * lda] * x[j];
+        }
+        for (int j = N - 1; j >= 0; j--) {
+            x[j] /= lu[j + j * lda];
+            for (int i = 0; i < j; i++) x[i] -= lu[i + j * lda] * x[j];
+        }
+    }
+}
+
+// Replaces the factorization of getrfSmall by the inverse, as getri
+template<typename T, int N>
+void getriSmall(T *a, const dim_t lda, const int *ipiv)
+{
+    T inv[N * N];
+    for (int j = 0; j < N; j++) {
+        for (int i = 0; i < N; i++) inv[i + j * N] = T(i == j ? 1 : 0);
+    }
+    getrsSmall<T, N>(a, lda, ipiv, inv, N, N);
+    for (int j = 0; j < N; j++) {
+        for (int i = 0; i < N; i++) a[i + j * lda] = inv[i + j * N];
+    }
+}
+
+// Cholesky factorization of a Hermitian positive definite matrix, as potrf.
+// Only the referenced triangle is read and written.
+template<typename T, int N>
+int potrfSmall(T *a, const dim_t lda, const bool upper)
+{
+    for (int j = 0; j < N; j++) {
+        T d = a[j + j * lda];
+        for (int k = 0; k < j; k++) {
+            const T v = upper ? a[k + j * lda] : a[j + k * lda];
+            d -= conjugate(v) * v;
+        }
+        if (!(realPart(d) > 0)) return j + 1;
+        const T root = T(std::sqrt(realPart(d)));
+        a[j + j * lda] = root;
+
+        for (int i = j + 1; i < N; i++) {
+            if (upper) {
+                T s = a[j + i * lda];
+                for (int k = 0; k < j; k++) s -= conjugate(a[k + j * lda]) * a[k + i * lda];
+                a[j + i * lda] = s / root;
+            } else {
+                T s = a[i + j * lda];
+                for (int k = 0; k < j; k++) s -= a[i + k * lda] * conjugate(a[j + k * lda]);
+                a[i + j * lda] = s / root;
+            }
+        }
+    }
+    return 0;
+}
+
+// Calls KERNEL<T, n>(...) for the order n in [2, SMALL_LAPACK_MAX] at runtime
+#define SMALL_LAPACK_DISPATCH(RET, KERNEL, T, n, ...)                 \
+    switch (n) {                                                      \
+    case  2: RET KERNEL<T,  2>(__VA_ARGS__); break;                   \
+    case  3: RET KERNEL<T,  3>(__VA_ARGS__); break;                   \
+    case  4: RET KERNEL<T,  4>(__VA_ARGS__); break;                   \
+    case  5: RET KERNEL<T,  5>(__VA_ARGS__); break;                   \
+    case  6: RET KERNEL<T,  6>(__VA_ARGS__); break;                   \
+    case  7: RET KERNEL<T,  7>(__VA_ARGS__); break;                   \
+    case  8: RET KERNEL<T,  8>(__VA_ARGS__); break;                   \
+    case  9: RET KERNEL<T,  9>(__VA_ARGS__); break;                   \
+    case 10: RET KERNEL<T, 10>(__VA_ARGS__); break;                   \
+    case 11: RET KERNEL<T, 11>(__VA_ARGS__); break;                   \
+    case 12: RET KERNEL<T, 12>(__VA_ARGS__); break;                   \
+    case 13: RET KERNEL<T, 13>(__VA_ARGS__); break;                   \
+    case 14: RET KERNEL<T, 14>(__VA_ARGS__); break;                   \
+    case 15: RET KERNEL<T, 15>(__VA_ARGS__); break;                   \
+    default: RET KERNEL<T, 16>(__VA_ARGS__); break;                   \
+    }
+
+static inline bool isSmallLapack(const dim_t n)
+{
+    return n >= 2 && n <= SMALL_LAPACK_MAX;
+}
+
+template<typename T>
+int getrfSmall(T *a, const dim_t lda, int *ipiv, const int n)
+{
+    int info = 0;
+    SMALL_LAPACK_DISPATCH(info =, getrfSmall, T, n, a, lda, ipiv)
+    return info;
+}
+
+template<typename T>
+void getrsSmall(const T *lu, const dim_t lda, const int *ipiv,
+                T *b, const dim_t ldb, const dim_t nrhs, const int n)
+{
+    SMALL_LAPACK_DISPATCH(, getrsSmall, T, n, lu, lda, ipiv, b, ldb, nrhs)
+}
+
+template<typename T>
+void getriSmall(T *a, const dim_t lda, const int *ipiv, const int n)
+{
+    SMALL_LAPACK_DISPATCH(, getriSmall, T, n, a, lda, ipiv)
+}
+
+template<typename T>
+int potrfSmall(T *a, const dim_t lda, const bool upper, const int n)
+{
+    int info = 0;
+    SMALL_LAPACK_DISPATCH(info =, potrfSmall, T, n, a, lda, upper)
+    return info;
+}
+
+#undef SMALL_LAPACK_DISPATCH
+
+// Sets the n x nrhs solution of a singular system to NaN. LAPACK leaves it
+// unmodified, so the solvers call this whichever kernel factorized the matrix
+template<typename T>
+void fillSingular(T *x, const dim_t ldx, const dim_t nrhs, const int n)
+{
+    const T nan = T(std::numeric_limits<double>::quiet_NaN());
+    for (dim_t k = 0; k < nrhs; k++) {
+        std::fill(x + k * ldx, x + k * ldx + n, nan);
+    }
+}
+
+}
@@ -18,7 +18,10 @@
 #include <common/blas_headers.hpp>
 #include <common/err_common.hpp>
 #include <common/complex.hpp>
+#include <common/igemm.hpp>
+#include <copy.hpp>
 #include <kernel/dot.hpp>
+#include <parallel.hpp>
 #include <platform.hpp>
 #include <types.hpp>
 
@@ -28,7 +31,9 @@
 
 
 #include <algorithm>
+#include <cmath>
 #include <type_traits>
+#include <vector>
 
 namespace cpu
 {
@@ -108,6 +113,12 @@ using gemv_func_def = void (*)( const CBLAS_ORDER, const CBLAS_TRANSPOSE,
                                 cptr_type<T>, const blasint,
                                 scale_type<T>, ptr_type<T>, const blasint);
 
+template<typename T>
+using syrk_func_def = void (*)( const CBLAS_ORDER, const CBLAS_UPLO, const CBLAS_TRANSPOSE,
+                                const blasint, const blasint,
+                                const T, const T *, const blasint,
+                                const T, T *, const blasint);
+
 #define BLAS_FUNC_DEF( FUNC )                           \
 template<typename T> FUNC##_func_def<T> FUNC##_func();
 
@@ -127,6 +138,10 @@ BLAS_FUNC(gemv , double  , d)
 BLAS_FUNC(gemv , cfloat  , c)
 BLAS_FUNC(gemv , cdouble , z)
 
+BLAS_FUNC_DEF(syrk)
+BLAS_FUNC(syrk , float   , s)
+BLAS_FUNC(syrk , double  , d)
+
 template<typename T, int value>
 typename enable_if<is_floating_point<T>::value, scale_type<T>>::type
 getScale() { return T(value); }
@@ -139,6 +154,86 @@ getScale()
     return (const typename blas_base<T>::type *)&val;
 }
 
+// Writes op(A) * op(A)^T to the N x N matrix C with a symmetric rank-k update,
+// which does half the work of the equivalent gemm, and mirrors the triangle
+template<typename T>
+typename enable_if<is_floating_point<T>::value>::type
+gram(const CBLAS_TRANSPOSE trans, const int N, const int K,
+     cptr_type<T> A, const int lda, ptr_type<T> C, const int ldc)
+{
+    syrk_func<T>()(CblasColMajor, CblasUpper, trans, N, K, T(1), A, lda, T(0), C, ldc);
+    for (int j = 0; j < N; j++) {
+        for (int i = j + 1; i < N; i++) {
+            C[i + j * ldc] = C[j + i * ldc];
+        }
+    }
+}
+
+// matmul only takes the gram path for real floating point types
+template<typename T>
+typename enable_if<!is_floating_point<T>::value>::type
+gram(const CBLAS_TRANSPOSE, const int, const int,
+     cptr_type<T>, const int, ptr_type<T>, const int)
+{
+    AF_ERROR("gram is only supported for real floating point types", AF_ERR_NOT_SUPPORTED);
+}
+
+// Largest number of multiply-adds of a single product for which batches are
+// multiplied concurrently, about a 128 x 128 x 128 product
+static const dim_t BATCH_GEMM_MAX_WORK = 1 << 21;
+
+// Minimum number of multiply-adds handled by a single thread
+static const dim_t BATCH_GEMM_GRAIN = 1 << 16;
+
+#ifdef USE_MKL
+template<typename T>
+using gemm_batch_func_def = void (*)( const CBLAS_ORDER, const CBLAS_TRANSPOSE *,
+                                      const CBLAS_TRANSPOSE *,
+                                      const MKL_INT *, const MKL_INT *, const MKL_INT *,
+                                      const typename blas_base<T>::type *,
+                                      const typename blas_base<T>::type **, const MKL_INT *,
+                                      const typename blas_base<T>::type **, const MKL_INT *,
+                                      const typename blas_base<T>::type *,
+                                      typename blas_base<T>::type **, const MKL_INT *,
+                                      const MKL_INT, const MKL_INT *);
+
+BLAS_FUNC_DEF(gemm_batch)
+BLAS_FUNC(gemm_batch , float   , s)
+BLAS_FUNC(gemm_batch , double  , d)
+BLAS_FUNC(gemm_batch , cfloat  , c)
+BLAS_FUNC(gemm_batch , cdouble , z)
+
+// Multiplies all the batches with a single call that MKL parallelizes
+// across the batches as well as within them
+template<typename T, typename Offsets>
+void gemmBatch(const CBLAS_TRANSPOSE lOpts, const CBLAS_TRANSPOSE rOpts,
+               const MKL_INT M, const MKL_INT N, const MKL_INT K, const dim_t batchSize,
+               const T *left, const MKL_INT lda, const T *right, const MKL_INT ldb,
+               T *output, const MKL_INT ldc, Offsets offsets)
+{
+    using BT  =       typename blas_base<T>::type;
+    using CBT = const typename blas_base<T>::type;
+
+    const T alpha(1), beta(0);
+    std::vector<CBT *> lptrs(batchSize), rptrs(batchSize);
+    std::vector<BT *> optrs(batchSize);
+    for (dim_t n = 0; n < batchSize; n++) {
+        dim_t loff, roff, ooff;
+        offsets(n, loff, roff, ooff);
+        lptrs[n] = reinterpret_cast<CBT *>(left + loff);
+        rptrs[n] = reinterpret_cast<CBT *>(right + roff);
+        optrs[n] = reinterpret_cast<BT *>(output + ooff);
+    }
+
+    const MKL_INT groupSize = batchSize;
+    gemm_batch_func<T>()(CblasColMajor, &lOpts, &rOpts, &M, &N, &K,
+                         reinterpret_cast<CBT *>(&alpha), lptrs.data(), &lda,
+                         rptrs.data(), &ldb,
+                         reinterpret_cast<CBT *>(&beta), optrs.data(), &ldc,
+                         1, &groupSize);
+}
+#endif
+
 CBLAS_TRANSPOSE
 toCblasTranspose(af_mat_prop opt)
 {
@@ -175,6 +270,11 @@ Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
     using BT  =       typename blas_base<T>::type;
     using CBT = const typename blas_base<T>::type;
 
+    // A^T * A and A * A^T of a real matrix are symmetric
+    const bool isGram = is_floating_point<T>::value && lhs.get() == rhs.get() &&
+                        lDims == rDims && lhs.strides() == rhs.strides() &&
+                        (lOpts == CblasNoTrans) != (rOpts == CblasNoTrans);
+
     dim_t d2 = std::max(lDims[2], rDims[2]);
     dim_t d3 = std::max(lDims[3], rDims[3]);
     const dim4 oDims(M, N, d2, d3);
@@ -188,44 +288,74 @@ Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
         dim4 rStrides = right.strides();
         dim4 oStrides = output.strides();
 
-        int batchSize = oDims[2] * oDims[3];
+        const dim_t batchSize = oDims[2] * oDims[3];
+        const bool isGemv     = rDims[bColDim] == 1;
 
         bool is_l_d2_batched = oDims[2] == lDims[2];
         bool is_l_d3_batched = oDims[3] == lDims[3];
         bool is_r_d2_batched = oDims[2] == rDims[2];
         bool is_r_d3_batched = oDims[3] == rDims[3];
 
-        for (int n = 0; n < batchSize; n++) {
-            int w = n / oDims[2];
-            int z = n - w * oDims[2];
-
-            int loff = z * (is_l_d2_batched * lStrides[2]) + w * (is_l_d3_batched * lStrides[3]);
-            int roff = z * (is_r_d2_batched * rStrides[2]) + w * (is_r_d3_batched * rStrides[3]);
-
-            CBT *lptr = reinterpret_cast<CBT*>(left.get() + loff);
-            CBT *rptr = reinterpret_cast<CBT*>(right.get() + roff);
-            BT *optr = reinterpret_cast<BT*>(output.get() + z * oStrides[2] + w * oStrides[3]);
-
-            if(rDims[bColDim] == 1) {
-                dim_t incr = (optRhs == AF_MAT_NONE) ? rStrides[0] : rStrides[1];
-                gemv_func<T>()(
-                    CblasColMajor, lOpts,
-                    lDims[0], lDims[1],
-                    alpha,
-                    lptr, lStrides[1],
-                    rptr, incr,
-                    beta,
-                    optr, 1);
-            } else {
-                gemm_func<T>()(
-                    CblasColMajor, lOpts, rOpts,
-                    M, N, K,
-                    alpha,
-                    lptr, lStrides[1],
-                    rptr, rStrides[1],
-                    beta,
-                    optr, output.dims(0));
+        auto offsets = [&](dim_t n, dim_t &loff, dim_t &roff, dim_t &ooff) {
+            dim_t w = n / oDims[2];
+            dim_t z = n - w * oDims[2];
+            loff = z * (is_l_d2_batched * lStrides[2]) + w * (is_l_d3_batched * lStrides[3]);
+            roff = z * (is_r_d2_batched * rStrides[2]) + w * (is_r_d3_batched * rStrides[3]);
+            ooff = z * oStrides[2] + w * oStrides[3];
+        };
+
+#ifdef USE_MKL
+        if (batchSize > 1 && !isGemv && !isGram) {
+            gemmBatch<T>(lOpts, rOpts, M, N, K, batchSize,
+                         left.get(), lStrides[1], right.get(), rStrides[1],
+                         output.get(), output.dims(0), offsets);
+            return;
+        }
+#endif
+
+        auto multiply = [&](dim_t begin, dim_t end) {
+            for (dim_t n = begin; n < end; n++) {
+                dim_t loff, roff, ooff;
+                offsets(n, loff, roff, ooff);
+
+                CBT *lptr = reinterpret_cast<CBT*>(left.get() + loff);
+                CBT *rptr = reinterpret_cast<CBT*>(right.get() + roff);
+                BT *optr = reinterpret_cast<BT*>(output.get() + ooff);
+
+                if(isGemv) {
+                    dim_t incr = (optRhs == AF_MAT_NONE) ? rStrides[0] : rStrides[1];
+                    gemv_func<T>()(
+                        CblasColMajor, lOpts,
+                        lDims[0], lDims[1],
+                        alpha,
+                        lptr, lStrides[1],
+                        rptr, incr,
+                        beta,
+                        optr, 1);
+                } else if (isGram) {
+                    gram<T>(lOpts, M, K, lptr, lStrides[1], optr, output.dims(0));
+                } else {
+                    gemm_func<T>()(
+                        CblasColMajor, lOpts, rOpts,
+                        M, N, K,
+                        alpha,
+                        lptr, lStrides[1],
+                        rptr, rStrides[1],
+                        beta,
+                        optr, output.dims(0));
+                }
             }
+        };
+
+        // Products too small for the BLAS library to thread are spread
+        // across the worker threads a batch at a time. Larger ones are left
+        // to the library, one after the other.
+        const dim_t work = (dim_t)M * N * K;
+        if (batchSize > 1 && work <= BATCH_GEMM_MAX_WORK) {
+            parallelFor(batchSize, std::max(BATCH_GEMM_GRAIN / std::max(work, (dim_t)1), (dim_t)1),
+                        multiply);
+        } else {
+            multiply(0, batchSize);
         }
     };
     getQueue().enqueue(func, out, lhs, rhs);
@@ -233,6 +363,158 @@ Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
     return out;
 }
 
+template<typename T, af_activation act>
+static inline T activate(T val)
+{
+    switch (act) {
+    case AF_ACTIVATION_RELU:    return std::max(val, T(0));
+    case AF_ACTIVATION_SIGMOID: return T(1) / (T(1) + std::exp(-val));
+    case AF_ACTIVATION_TANH:    return std::tanh(val);
+    default:                    return val;
+    }
+}
+
+// Adds the bias to the columns [begin, end) of the M x N block at out and
+// applies the activation
+template<typename T, af_activation act>
+static void epilogue(T *out, const dim_t ldo, const dim_t M,
+                     const dim_t begin, const dim_t end,
+                     const T *rowBias, const T *colBias)
+{
+    for (dim_t j = begin; j < end; j++) {
+        T *col = out + j * ldo;
+        const T cb = colBias ? colBias[j] : T(0);
+        if (rowBias) {
+            for (dim_t i = 0; i < M; i++) col[i] = activate<T, act>(col[i] + rowBias[i] + cb);
+        } else {
+            for (dim_t i = 0; i < M; i++) col[i] = activate<T, act>(col[i] + cb);
+        }
+    }
+}
+
+template<typename T>
+static void epilogue(T *out, const dim_t ldo, const dim_t M,
+                     const dim_t begin, const dim_t end,
+                     const T *rowBias, const T *colBias, const af_activation act)
+{
+    switch (act) {
+    case AF_ACTIVATION_RELU:    epilogue<T, AF_ACTIVATION_RELU   >(out, ldo, M, begin, end, rowBias, colBias); break;
+    case AF_ACTIVATION_SIGMOID: epilogue<T, AF_ACTIVATION_SIGMOID>(out, ldo, M, begin, end, rowBias, colBias); break;
+    case AF_ACTIVATION_TANH:    epilogue<T, AF_ACTIVATION_TANH   >(out, ldo, M, begin, end, rowBias, colBias); break;
+    default:                    epilogue<T, AF_ACTIVATION_NONE   >(out, ldo, M, begin, end, rowBias, colBias); break;
+    }
+}
+
+template<typename T>
+void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+          const T alpha, const Array<T> &lhs, const Array<T> &rhs,
+          const T beta, const Array<T> &bias, const af_activation act)
+{
+    lhs.eval();
+    rhs.eval();
+    bias.eval();
+    out.eval();
+
+    CBLAS_TRANSPOSE lOpts = toCblasTranspose(optLhs);
+    CBLAS_TRANSPOSE rOpts = toCblasTranspose(optRhs);
+
+    const dim4 lDims = lhs.dims();
+    const dim4 rDims = rhs.dims();
+    const dim4 oDims = out.dims();
+    const dim_t M = oDims[0];
+    const dim_t N = oDims[1];
+    const dim_t K = lDims[lOpts == CblasNoTrans ? 1 : 0];
+
+    const bool hasBias = bias.elements() > 0;
+    const bool rowBias = hasBias && bias.dims()[0] == M && (dim_t)bias.elements() == M;
+
+    auto func = [=] (Param<T> output, CParam<T> left, CParam<T> right, CParam<T> b) {
+        const dim4 lStrides = left.strides();
+        const dim4 rStrides = right.strides();
+        const dim4 oStrides = output.strides();
+
+        const T *rowBiasPtr = rowBias ? b.get() : nullptr;
+        const T *colBiasPtr = (hasBias && !rowBias) ? b.get() : nullptr;
+
+        // Every product is computed by a single call to the BLAS library,
+        // which packs op(lhs) once and threads the call. The bias and the
+        // activation are then applied by the worker threads in one pass.
+        for (dim_t n = 0; n < oDims[2] * oDims[3]; n++) {
+            const dim_t w = n / oDims[2];
+            const dim_t z = n - w * oDims[2];
+
+            const T *lptr = left.get()  + z * (lDims[2] == oDims[2]) * lStrides[2]
+                                        + w * (lDims[3] == oDims[3]) * lStrides[3];
+            const T *rptr = right.get() + z * (rDims[2] == oDims[2]) * rStrides[2]
+                                        + w * (rDims[3] == oDims[3]) * rStrides[3];
+            T *optr = output.get() + z * oStrides[2] + w * oStrides[3];
+
+            gemm_func<T>()(CblasColMajor, lOpts, rOpts,
+                           M, N, K,
+                           alpha,
+                           lptr, lStrides[1],
+                           rptr, rStrides[1],
+                           beta,
+                           optr, oStrides[1]);
+
+            if (!hasBias && act == AF_ACTIVATION_NONE) continue;
+            parallelFor(N, std::max(BATCH_GEMM_GRAIN / std::max(M, (dim_t)1), (dim_t)1),
+                        [&](dim_t begin, dim_t end) {
+                            epilogue(optr, oStrides[1], M, begin, end,
+                                     rowBiasPtr, colBiasPtr, act);
+                        });
+        }
+    };
+    getQueue().enqueue(func, out, lhs, rhs, bias);
+}
+
+template<typename Ti, typename To>
+Array<To> integerMatmul(const Array<Ti> &lhs, const Array<Ti> &rhs,
+                        af_mat_prop optLhs, af_mat_prop optRhs,
+                        const int lhsZero, const int rhsZero)
+{
+    lhs.eval();
+    rhs.eval();
+
+    const bool lTrans = optLhs != AF_MAT_NONE;
+    const bool rTrans = optRhs != AF_MAT_NONE;
+
+    const dim4 lDims = lhs.dims();
+    const dim4 rDims = rhs.dims();
+    const dim4 oDims(lDims[lTrans ? 1 : 0], rDims[rTrans ? 0 : 1],
+                     std::max(lDims[2], rDims[2]), std::max(lDims[3], rDims[3]));
+    Array<To> out = createEmptyArray<To>(oDims);
+
+    // op(lhs) is packed once, and shared by the tasks computing blocks of
+    // output columns
+    auto func = [=] (Param<To> output, CParam<Ti> left, CParam<Ti> right) {
+        typedef common::igemm_pack_t<Ti, To> P;
+        const dim_t M = oDims[0];
+        const dim_t K = lDims[lTrans ? 0 : 1];
+
+        std::vector<P> lpack(lDims[2] * lDims[3] * M * K);
+        parallelFor(common::igemmLhsTasks(lDims, M),
+                    std::max(BATCH_GEMM_GRAIN / std::max(common::IGEMM_MC * K, (dim_t)1), (dim_t)1),
+                    [&](dim_t begin, dim_t end) {
+                        common::igemmPackLhs(lpack.data(), M, K, left.get(), lDims,
+                                             left.strides(), lTrans, lhsZero, begin, end);
+                    });
+
+        const dim_t work = M * std::min(oDims[1], common::IGEMM_NC) * K;
+        parallelFor(common::igemmTasks(oDims),
+                    std::max(BATCH_GEMM_GRAIN / std::max(work, (dim_t)1), (dim_t)1),
+                    [&](dim_t begin, dim_t end) {
+                        common::igemmPacked(output.get(), oDims, output.strides(),
+                                            lpack.data(), lDims, K,
+                                            right.get(), rDims, right.strides(), rTrans, rhsZero,
+                                            begin, end);
+                    });
+    };
+    getQueue().enqueue(func, out, lhs, rhs);
+
+    return out;
+}
+
 template<typename T>
 Array<T> dot(const Array<T> &lhs, const Array<T> &rhs,
              af_mat_prop optLhs, af_mat_prop optRhs)
@@ -240,7 +522,17 @@ Array<T> dot(const Array<T> &lhs, const Array<T> &rhs,
     lhs.eval();
     rhs.eval();
 
-    Array<T> out = createEmptyArray<T>(af::dim4(1));
+    const af::dim4 lDims = lhs.dims();
+    const af::dim4 rDims = rhs.dims();
+    Array<T> out = createEmptyArray<T>(af::dim4(1, std::max(lDims[1], rDims[1]),
+                                                std::max(lDims[2], rDims[2]),
+                                                std::max(lDims[3], rDims[3])));
+
+    // The kernel reads the columns as contiguous vectors
+    if (lhs.strides()[0] != 1 || rhs.strides()[0] != 1) {
+        return dot<T>(copyArray<T>(lhs), copyArray<T>(rhs), optLhs, optRhs);
+    }
+
     if(optLhs == AF_MAT_CONJ && optRhs == AF_MAT_CONJ) {
         getQueue().enqueue(kernel::dot<T, false, true>, out, lhs, rhs, optLhs, optRhs);
     } else if (optLhs == AF_MAT_CONJ && optRhs == AF_MAT_NONE) {
@@ -265,6 +557,29 @@ INSTANTIATE_BLAS(cfloat)
 INSTANTIATE_BLAS(double)
 INSTANTIATE_BLAS(cdouble)
 
+#define INSTANTIATE_GEMM(TYPE)                                                          \
+    template void gemm<TYPE>(Array<TYPE> &out, af_mat_prop optLhs, af_mat_prop optRhs,  \
+                             const TYPE alpha, const Array<TYPE> &lhs,                  \
+                             const Array<TYPE> &rhs, const TYPE beta,                   \
+                             const Array<TYPE> &bias, const af_activation act);
+
+INSTANTIATE_GEMM(float)
+INSTANTIATE_GEMM(double)
+
+#define INSTANTIATE_INTEGER_BLAS(Ti, To)                                                \
+    template Array<To> integerMatmul<Ti, To>(const Array<Ti> &lhs, const Array<Ti> &rhs, \
+                                             af_mat_prop optLhs, af_mat_prop optRhs,   \
+                                             const int lhsZero, const int rhsZero);
+
+INSTANTIATE_INTEGER_BLAS(uchar , intl )
+INSTANTIATE_INTEGER_BLAS(uchar , uint )
+INSTANTIATE_INTEGER_BLAS(short , intl )
+INSTANTIATE_INTEGER_BLAS(ushort, uintl)
+INSTANTIATE_INTEGER_BLAS(int   , int  )
+INSTANTIATE_INTEGER_BLAS(uint  , uint )
+INSTANTIATE_INTEGER_BLAS(intl  , intl )
+INSTANTIATE_INTEGER_BLAS(uintl , uintl)
+
 #define INSTANTIATE_DOT(TYPE)                                                               \
     template Array<TYPE> dot<TYPE>(const Array<TYPE> &lhs, const Array<TYPE> &rhs,          \
                                    af_mat_prop optLhs, af_mat_prop optRhs);
@@ -19,8 +19,11 @@
 #include <af/dim4.hpp>
 #include <triangle.hpp>
 #include <lapack_helper.hpp>
+#include <parallel.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
+#include <common/small_lapack.hpp>
+#include <vector>
 
 namespace cpu
 {
@@ -70,16 +73,32 @@ int cholesky_inplace(Array<T> &in, const bool is_upper)
     if(is_upper)
         uplo = 'U';
 
-    int info = 0;
+    // Every matrix along dimensions 2 and 3 is factorized independently and
+    // the first failure, in batch order, is reported
+    std::vector<int> info(iDims[2] * iDims[3], 0);
     auto func = [&] (int *info, Param<T> in) {
-        *info = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo, N, in.get(), in.strides(1));
+        parallelFor(iDims[2] * iDims[3], common::lapackBatchGrain(N),
+                    [&] (dim_t begin, dim_t end) {
+            for (dim_t n = begin; n < end; n++) {
+                T *iPtr = in.get() + common::batchOffset(iDims, in.strides(), n);
+                if (common::isSmallLapack(N)) {
+                    info[n] = common::potrfSmall(iPtr, in.strides(1), is_upper, N);
+                } else {
+                    info[n] = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo, N,
+                                              iPtr, in.strides(1));
+                }
+            }
+        });
     };
 
-    getQueue().enqueue(func, &info, in);
+    getQueue().enqueue(func, info.data(), in);
     // Ensure the value of info has been written into info.
     getQueue().sync();
 
-    return info;
+    for (size_t n = 0; n < info.size(); n++) {
+        if (info[n] != 0) return info[n];
+    }
+    return 0;
 }
 
 #define INSTANTIATE_CH(T)                                                                   \
@@ -0,0 +1,58 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <describe.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+#include <kernel/describe.hpp>
+
+using af::dim4;
+
+namespace cpu
+{
+
+static unsigned countStats(unsigned stats)
+{
+    unsigned count = 0;
+    for (; stats; stats >>= 1) count += stats & 1;
+    return count;
+}
+
+template<typename Ti, typename To>
+Array<To> describe(const Array<Ti> &in, const unsigned stats,
+                   const af_var_bias bias, const int dim)
+{
+    in.eval();
+
+    dim4 odims = in.dims();
+    odims[dim] = countStats(stats & AF_STAT_ALL);
+    Array<To> out = createEmptyArray<To>(odims);
+
+    getQueue().enqueue(kernel::describe<Ti, To>, out, in, stats, bias, dim);
+
+    return out;
+}
+
+#define INSTANTIATE(Ti, To)                                             \
+    template Array<To> describe<Ti, To>(const Array<Ti> &in, const unsigned stats, \
+                                        const af_var_bias bias, const int dim);
+
+INSTANTIATE(float , float )
+INSTANTIATE(double, double)
+INSTANTIATE(int   , float )
+INSTANTIATE(uint  , float )
+INSTANTIATE(intl  , double)
+INSTANTIATE(uintl , double)
+INSTANTIATE(short , float )
+INSTANTIATE(ushort, float )
+INSTANTIATE(uchar , float )
+INSTANTIATE(char  , float )
+
+}
@@ -0,0 +1,21 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+
+namespace cpu
+{
+// Computes the statistics selected by the af_stat_type flags in stats along
+// dim. NaNs are skipped by all the statistics except AF_STAT_NAN_COUNT. The
+// output has one element along dim for every selected statistic, in the
+// order of the flags.
+template<typename Ti, typename To>
+Array<To> describe(const Array<Ti> &in, const unsigned stats,
+                   const af_var_bias bias, const int dim);
+}
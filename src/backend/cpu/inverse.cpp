@@ -22,8 +22,10 @@
 #include <lu.hpp>
 #include <identity.hpp>
 #include <solve.hpp>
+#include <parallel.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
+#include <common/small_lapack.hpp>
 
 namespace cpu
 {
@@ -62,10 +64,23 @@ Array<T> inverse(const Array<T> &in)
     Array<T> A = copyArray<T>(in);
     Array<int> pivot = lu_inplace<T>(A, false);
 
+    // lu_inplace factorized every matrix along dimensions 2 and 3
     auto func = [=] (Param<T> A, Param<int> pivot, int M) {
-        getri_func<T>()(AF_LAPACK_COL_MAJOR, M,
-                        A.get(), A.strides(1),
-                        pivot.get());
+        const dim4 aDims = A.dims();
+        parallelFor(aDims[2] * aDims[3], common::lapackBatchGrain(M),
+                    [&] (dim_t begin, dim_t end) {
+            for (dim_t n = begin; n < end; n++) {
+                T *aPtr   = A.get() + common::batchOffset(aDims, A.strides(), n);
+                int *pPtr = pivot.get() + common::batchOffset(pivot.dims(), pivot.strides(), n);
+                if (common::isSmallLapack(M)) {
+                    common::getriSmall(aPtr, A.strides(1), pPtr, M);
+                } else {
+                    getri_func<T>()(AF_LAPACK_COL_MAJOR, M,
+                                    aPtr, A.strides(1),
+                                    pPtr);
+                }
+            }
+        });
     };
     getQueue().enqueue(func, A, pivot, M);
 
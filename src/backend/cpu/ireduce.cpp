@@ -20,10 +20,6 @@ using af::dim4;
 namespace cpu
 {
 
-template<af_op_t op, typename T>
-using ireduce_dim_func = std::function<void(Param<T>, Param<uint>, const dim_t,
-                                            CParam<T>, const dim_t, const int)>;
-
 template<af_op_t op, typename T>
 void ireduce(Array<T> &out, Array<uint> &loc, const Array<T> &in, const int dim)
 {
@@ -31,14 +27,7 @@ void ireduce(Array<T> &out, Array<uint> &loc, const Array<T> &in, const int dim)
     loc.eval();
     in.eval();
 
-    dim4 odims = in.dims();
-    odims[dim] = 1;
-    static const ireduce_dim_func<op, T> ireduce_funcs[] = { kernel::ireduce_dim<op, T, 1>()
-                                                           , kernel::ireduce_dim<op, T, 2>()
-                                                           , kernel::ireduce_dim<op, T, 3>()
-                                                           , kernel::ireduce_dim<op, T, 4>()};
-
-    getQueue().enqueue(ireduce_funcs[in.ndims() - 1], out, loc, 0, in, 0, dim);
+    getQueue().enqueue(kernel::ireduce<op, T>, out, loc, in, dim);
 }
 
 template<af_op_t op, typename T>
@@ -47,31 +36,7 @@ T ireduce_all(unsigned *loc, const Array<T> &in)
     in.eval();
     getQueue().sync();
 
-    af::dim4 dims = in.dims();
-    af::dim4 strides = in.strides();
-    const T *inPtr = in.get();
-
-    kernel::MinMaxOp<op, T> Op(inPtr[0], 0);
-
-    for(dim_t l = 0; l < dims[3]; l++) {
-        dim_t off3 = l * strides[3];
-
-        for(dim_t k = 0; k < dims[2]; k++) {
-            dim_t off2 = k * strides[2];
-
-            for(dim_t j = 0; j < dims[1]; j++) {
-                dim_t off1 = j * strides[1];
-
-                for(dim_t i = 0; i < dims[0]; i++) {
-                    dim_t idx = i + off1 + off2 + off3;
-                    Op(inPtr[idx], idx);
-                }
-            }
-        }
-    }
-
-    *loc = Op.m_idx;
-    return Op.m_val;
+    return kernel::ireduce_all<op, T>(loc, in);
 }
 
 #define INSTANTIATE(ROp, T)                                             \
@@ -58,6 +58,16 @@ namespace jit
                            });
         }
 
+        // The copy refers to the same data
+        Node_ptr clone(const std::array<Node_ptr, Node::kMaxChildren> &children) const final
+        {
+            UNUSED(children);
+            BufferNode<T> *copy = new BufferNode<T>();
+            copy->setData(m_sptr, m_bytes, m_ptr - m_sptr.get(),
+                          m_dims, m_strides, m_linear_buffer);
+            return Node_ptr(copy);
+        }
+
         void calc(int x, int y, int z, int w, int lim) final
         {
             dim_t l_off = 0;
@@ -69,6 +69,29 @@ namespace jit
 
         int getHeight() { return m_height; }
 
+        // Returns a copy of the node, with its own buffer for the values,
+        // whose children are the given copies of its children
+        virtual Node_ptr clone(const std::array<Node_ptr, kMaxChildren> &children) const = 0;
+
+        // Copies the tree rooted at this node, so that different threads can
+        // evaluate different parts of the output. copies maps the nodes that
+        // were already copied to their copies, so that shared nodes stay
+        // shared.
+        Node_ptr cloneTree(std::unordered_map<const Node *, Node_ptr> &copies) const
+        {
+            auto iter = copies.find(this);
+            if (iter != copies.end()) return iter->second;
+
+            std::array<Node_ptr, kMaxChildren> children;
+            for (int i = 0; i < kMaxChildren; i++) {
+                if (m_children[i] == nullptr) break;
+                children[i] = m_children[i]->cloneTree(copies);
+            }
+            Node_ptr copy = clone(children);
+            copies[this] = copy;
+            return copy;
+        }
+
         virtual void calc(int x, int y, int z, int w, int lim) {
             UNUSED(x);
             UNUSED(y);
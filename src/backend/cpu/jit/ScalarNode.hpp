@@ -26,6 +26,12 @@ namespace jit
         ScalarNode(T val) : TNode<T>(val, 0, {})
         {
         }
+
+        Node_ptr clone(const std::array<Node_ptr, Node::kMaxChildren> &children) const final
+        {
+            UNUSED(children);
+            return Node_ptr(new ScalarNode<T>(this->m_val[0]));
+        }
     };
 }
 
@@ -45,6 +45,11 @@ namespace jit
         {
         }
 
+        Node_ptr clone(const std::array<Node_ptr, Node::kMaxChildren> &children) const final
+        {
+            return Node_ptr(new UnaryNode<To, Ti, op>(children[0]));
+        }
+
         void calc(int x, int y, int z, int w, int lim) final
         {
             UNUSED(x);
@@ -11,6 +11,9 @@
 #include <Param.hpp>
 #include <platform.hpp>
 #include <jit/Node.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 namespace cpu
@@ -93,5 +96,69 @@ void evalArray(Param<T> arr, jit::Node_ptr node)
     evalMultiple<T>({arr}, {node});
 }
 
+// Evaluates the elements [begin, end) of the JIT tree rooted at node, which
+// has the dimensions dims, one vector at a time without storing the result.
+// func(vals, idx, lim) is called with the lim values starting at the linear
+// index idx and stops the evaluation by returning true.
+template<typename T, typename Func>
+void evalBlocks(jit::Node_ptr node, const af::dim4 dims,
+                const dim_t begin, const dim_t end, Func func)
+{
+    jit::Node_map_t nodes;
+    std::vector<jit::Node *> full_nodes;
+    node->getNodesMap(nodes, full_nodes);
+    const T *vals = reinterpret_cast<jit::TNode<T> *>(node.get())->m_val.data();
+
+    bool is_linear = true;
+    for (auto n : full_nodes) {
+        is_linear &= n->isLinear(dims.get());
+    }
+
+    if (is_linear) {
+        for (dim_t i = begin; i < end; i += jit::VECTOR_LENGTH) {
+            int lim = (int)std::min((dim_t)jit::VECTOR_LENGTH, end - i);
+            for (auto n : full_nodes) n->calc((int)i, lim);
+            if (func(vals, i, lim)) return;
+        }
+    } else {
+        const dim_t dim0 = dims[0];
+        for (dim_t i = begin; i < end;) {
+            dim_t row = i / dim0;
+            int x = (int)(i % dim0);
+            int y = (int)(row % dims[1]);
+            int z = (int)((row / dims[1]) % dims[2]);
+            int w = (int)(row / (dims[1] * dims[2]));
+            int lim = (int)std::min(std::min((dim_t)jit::VECTOR_LENGTH, dim0 - x), end - i);
+            for (auto n : full_nodes) n->calc(x, y, z, w, lim);
+            if (func(vals, i, lim)) return;
+            i += lim;
+        }
+    }
+}
+
+// Splits the elements of the JIT tree rooted at node into nchunks contiguous
+// chunks evaluated by different threads, each with its own copy of the tree.
+// func(chunk, vals, idx, lim) is called as for evalBlocks and stops the
+// evaluation of its chunk by returning true.
+template<typename T, typename Func>
+void parallelEvalBlocks(jit::Node_ptr node, const af::dim4 dims,
+                        const unsigned nchunks, Func func)
+{
+    const dim_t nelems = dims.elements();
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end;
+        chunkRange(nelems, nchunks, chunk, begin, end);
+
+        jit::Node_ptr tree = node;
+        if (nchunks > 1) {
+            std::unordered_map<const jit::Node *, jit::Node_ptr> copies;
+            tree = node->cloneTree(copies);
+        }
+        evalBlocks<T>(tree, dims, begin, end, [&](const T *vals, dim_t idx, int lim) {
+            return func(chunk, vals, idx, lim);
+        });
+    });
+}
+
 }
 }
@@ -0,0 +1,268 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <parallel.hpp>
+#include <af/defines.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Minimum number of elements described by a single thread
+static const dim_t DESCRIBE_GRAIN = 1 << 16;
+
+// Number of consecutive elements summarized together before they are
+// combined with the running statistics
+static const dim_t DESCRIBE_BLOCK = 1024;
+
+// Number of steps along the reduced dimension summarized together when the
+// statistics of whole rows are updated at once
+static const dim_t DESCRIBE_ROW_BLOCK = 32;
+
+// Running statistics of a set of values. NaNs are only counted.
+struct describe_acc
+{
+    double count;
+    double nans;
+    double sum;
+    double mean;
+    double m2;
+    double min;
+    double max;
+
+    describe_acc()
+        : count(0), nans(0), sum(0), mean(0), m2(0),
+          min( std::numeric_limits<double>::infinity()),
+          max(-std::numeric_limits<double>::infinity())
+    {}
+
+    // Combines the statistics of two disjoint sets using the pairwise update
+    // of Chan et al. for the mean and the sum of squared differences
+    void merge(const describe_acc &other)
+    {
+        nans += other.nans;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        if (other.count == 0) return;
+
+        const double n     = count + other.count;
+        const double delta = other.mean - mean;
+        mean  += delta * (other.count / n);
+        m2    += other.m2 + delta * delta * (count * other.count / n);
+        sum   += other.sum;
+        count  = n;
+    }
+
+    // Writes the requested statistics to out, one every stride elements, in
+    // the order of their af_stat_type flags
+    template<typename To>
+    void write(To *out, const dim_t stride, const unsigned stats,
+               const af_var_bias bias) const
+    {
+        const double nan   = std::numeric_limits<double>::quiet_NaN();
+        const double denom = (bias == AF_VARIANCE_SAMPLE) ? count - 1 : count;
+        const double var   = denom > 0 ? m2 / denom : nan;
+        if (stats & AF_STAT_MIN)       { *out = (To)min;                  out += stride; }
+        if (stats & AF_STAT_MAX)       { *out = (To)max;                  out += stride; }
+        if (stats & AF_STAT_SUM)       { *out = (To)sum;                  out += stride; }
+        if (stats & AF_STAT_MEAN)      { *out = (To)(count ? mean : nan); out += stride; }
+        if (stats & AF_STAT_VAR)       { *out = (To)var;                  out += stride; }
+        if (stats & AF_STAT_NAN_COUNT) { *out = (To)nans;                 out += stride; }
+    }
+};
+
+// Summarizes ptr[i * stride], i in [begin, end), block by block. Every block
+// is reduced in two passes, the second one computing the squared differences
+// from the mean of the block while the block is still in cache.
+template<typename T>
+describe_acc describeRange(const T *ptr, const dim_t stride,
+                           const dim_t begin, const dim_t end)
+{
+    describe_acc acc;
+    for (dim_t b = begin; b < end; b += DESCRIBE_BLOCK) {
+        const T *data   = ptr + b * stride;
+        const dim_t len = std::min(end - b, DESCRIBE_BLOCK);
+
+        describe_acc block;
+        dim_t nans = 0;
+        double sum = 0;
+        for (dim_t i = 0; i < len; i++) {
+            double val = (double)data[i * stride];
+            bool isnan = val != val;
+            nans += isnan;
+            sum  += isnan ? 0.0 : val;
+            // NaNs fail both comparisons
+            block.min = val < block.min ? val : block.min;
+            block.max = val > block.max ? val : block.max;
+        }
+
+        block.nans  = nans;
+        block.count = len - nans;
+        block.sum   = sum;
+        if (block.count) {
+            block.mean = sum / block.count;
+            double m2 = 0;
+            for (dim_t i = 0; i < len; i++) {
+                double diff = (double)data[i * stride] - block.mean;
+                m2 += diff == diff ? diff * diff : 0.0;
+            }
+            block.m2 = m2;
+        }
+        acc.merge(block);
+    }
+    return acc;
+}
+
+// Computes the statistics selected by stats along dim. The output has one
+// element along dim for every selected statistic.
+//
+// Reductions along the first dimension summarize contiguous columns. Along
+// the other dimensions, a block of rows is summarized at once so that the
+// reads stay contiguous. The outputs are split across threads, and when there
+// are fewer outputs than threads each output is summarized by several of them.
+template<typename Ti, typename To>
+void describe(Param<To> output, CParam<Ti> input, const unsigned stats,
+              const af_var_bias bias, const int dim)
+{
+    const af::dim4 idims    = input.dims();
+    const af::dim4 istrides = input.strides();
+    const af::dim4 ostrides = output.strides();
+
+    af::dim4 rdims = idims;
+    rdims[dim] = 1;
+
+    const dim_t nout    = rdims.elements();
+    const dim_t n       = idims[dim];
+    const dim_t stride  = istrides[dim];
+    const dim_t ostride = ostrides[dim];
+
+    Ti const * const in = input.get();
+    To * const out      = output.get();
+
+    auto offsets = [&](dim_t o, dim_t &inOff, dim_t &outOff) {
+        dim_t o0 = o % rdims[0];
+        dim_t o1 = (o / rdims[0]) % rdims[1];
+        dim_t o2 = (o / (rdims[0] * rdims[1])) % rdims[2];
+        dim_t o3 = o / (rdims[0] * rdims[1] * rdims[2]);
+        inOff  = o0 * istrides[0] + o1 * istrides[1] + o2 * istrides[2] + o3 * istrides[3];
+        outOff = o0 * ostrides[0] + o1 * ostrides[1] + o2 * ostrides[2] + o3 * ostrides[3];
+    };
+
+    const unsigned nchunks = getNumChunks(n, DESCRIBE_GRAIN);
+    if (nout < (dim_t)getNumThreads() && nchunks > 1) {
+        std::vector<describe_acc> partial(nchunks);
+        for (dim_t o = 0; o < nout; o++) {
+            dim_t inOff, outOff;
+            offsets(o, inOff, outOff);
+
+            parallelTasks(nchunks, [&](unsigned chunk) {
+                dim_t begin, end;
+                chunkRange(n, nchunks, chunk, begin, end);
+                partial[chunk] = describeRange(in + inOff, stride, begin, end);
+            });
+
+            describe_acc acc;
+            for (unsigned chunk = 0; chunk < nchunks; chunk++) {
+                acc.merge(partial[chunk]);
+            }
+            acc.write(out + outOff, ostride, stats, bias);
+        }
+        return;
+    }
+
+    const dim_t grain = std::max(DESCRIBE_GRAIN / std::max(n, (dim_t)1), (dim_t)1);
+
+    if (dim == 0) {
+        parallelFor(nout, grain, [&](dim_t begin, dim_t end) {
+            for (dim_t o = begin; o < end; o++) {
+                dim_t inOff, outOff;
+                offsets(o, inOff, outOff);
+                describeRange(in + inOff, stride, 0, n)
+                    .write(out + outOff, ostride, stats, bias);
+            }
+        });
+        return;
+    }
+
+    parallelFor(nout, grain, [&](dim_t begin, dim_t end) {
+        std::vector<describe_acc> accs;
+        std::vector<double> sums, m2s, mins, maxs, means;
+        std::vector<dim_t> nans;
+
+        for (dim_t o = begin; o < end;) {
+            const dim_t count = std::min(std::min(rdims[0] - o % rdims[0], end - o),
+                                         DESCRIBE_BLOCK);
+            dim_t inOff, outOff;
+            offsets(o, inOff, outOff);
+            const Ti *inRow = in + inOff;
+
+            accs.assign(count, describe_acc());
+            for (dim_t b = 0; b < n; b += DESCRIBE_ROW_BLOCK) {
+                const dim_t steps = std::min(n - b, DESCRIBE_ROW_BLOCK);
+
+                sums.assign(count, 0.0);
+                nans.assign(count, 0);
+                mins.assign(count,  std::numeric_limits<double>::infinity());
+                maxs.assign(count, -std::numeric_limits<double>::infinity());
+                for (dim_t k = b; k < b + steps; k++) {
+                    const Ti *row = inRow + k * stride;
+                    for (dim_t j = 0; j < count; j++) {
+                        double val = (double)row[j];
+                        bool isnan = val != val;
+                        nans[j] += isnan;
+                        sums[j] += isnan ? 0.0 : val;
+                        mins[j]  = val < mins[j] ? val : mins[j];
+                        maxs[j]  = val > maxs[j] ? val : maxs[j];
+                    }
+                }
+
+                means.resize(count);
+                for (dim_t j = 0; j < count; j++) {
+                    dim_t valid = steps - nans[j];
+                    means[j] = valid ? sums[j] / valid : 0.0;
+                }
+
+                m2s.assign(count, 0.0);
+                for (dim_t k = b; k < b + steps; k++) {
+                    const Ti *row = inRow + k * stride;
+                    for (dim_t j = 0; j < count; j++) {
+                        double diff = (double)row[j] - means[j];
+                        m2s[j] += diff == diff ? diff * diff : 0.0;
+                    }
+                }
+
+                for (dim_t j = 0; j < count; j++) {
+                    describe_acc block;
+                    block.nans  = nans[j];
+                    block.count = steps - nans[j];
+                    block.sum   = sums[j];
+                    block.mean  = means[j];
+                    block.m2    = m2s[j];
+                    block.min   = mins[j];
+                    block.max   = maxs[j];
+                    accs[j].merge(block);
+                }
+            }
+
+            for (dim_t j = 0; j < count; j++) {
+                accs[j].write(out + outOff + j * ostrides[0], ostride, stats, bias);
+            }
+            o += count;
+        }
+    });
+}
+
+}
+}
@@ -9,7 +9,11 @@
 
 #pragma once
 #include <Param.hpp>
+#include <math.hpp>
+#include <parallel.hpp>
+#include <algorithm>
 #include <complex>
+#include <vector>
 
 namespace cpu
 {
@@ -22,25 +26,93 @@ conj(T  x) { return x; }
 template<> cfloat  conj<cfloat> (cfloat  c) { return std::conj(c); }
 template<> cdouble conj<cdouble>(cdouble c) { return std::conj(c); }
 
+// Elements of a vector summed by one task. The partial sums of the blocks
+// are added in order, so the result does not depend on the number of threads.
+static const dim_t DOT_BLOCK = 1 << 13;
+
+// Smallest number of elements a thread is handed
+static const dim_t DOT_GRAIN = 1 << 16;
+
+// Independent accumulators of dotBlock. They hide the latency of the adds,
+// let the compiler vectorize the loop and, being combined pairwise, lose less
+// precision than a single running sum.
+static const int DOT_LANES = 8;
+
+template<typename T, bool conjugate>
+T dotBlock(const T *pL, const T *pR, const dim_t n)
+{
+    T acc[DOT_LANES];
+    for (int k = 0; k < DOT_LANES; k++) acc[k] = scalar<T>(0);
+
+    dim_t i = 0;
+    for (; i + DOT_LANES <= n; i += DOT_LANES) {
+        for (int k = 0; k < DOT_LANES; k++) {
+            acc[k] += (conjugate ? kernel::conj(pL[i + k]) : pL[i + k]) * pR[i + k];
+        }
+    }
+    for (int k = 0; i < n; i++, k++) {
+        acc[k] += (conjugate ? kernel::conj(pL[i]) : pL[i]) * pR[i];
+    }
+
+    for (int w = DOT_LANES / 2; w > 0; w /= 2) {
+        for (int k = 0; k < w; k++) acc[k] += acc[k + w];
+    }
+    return acc[0];
+}
+
+// Dot products of the columns of lhs and rhs. Either side can have a single
+// column, or be a single matrix, that is paired with all the columns of the
+// other one.
 template<typename T, bool conjugate, bool both_conjugate>
 void dot(Param<T> output, CParam<T> lhs, CParam<T> rhs,
          af_mat_prop optLhs, af_mat_prop optRhs)
 {
     UNUSED(optLhs);
     UNUSED(optRhs);
-    int N = lhs.dims(0);
 
-    T out = 0;
-    const T *pL = lhs.get();
-    const T *pR = rhs.get();
+    const dim4 oDims    = output.dims();
+    const dim4 lDims    = lhs.dims();
+    const dim4 rDims    = rhs.dims();
+    const dim4 lStrides = lhs.strides();
+    const dim4 rStrides = rhs.strides();
+
+    const dim_t N      = lDims[0];
+    const dim_t blocks = (N + DOT_BLOCK - 1) / DOT_BLOCK;
+    const dim_t cols   = oDims[1] * oDims[2] * oDims[3];
+    const dim_t grain  = std::max<dim_t>(1, DOT_GRAIN / std::min(N, DOT_BLOCK));
+
+    T *out = output.get();
+    std::vector<T> partial(blocks > 1 ? cols * blocks : 0);
 
-    for(int i = 0; i < N; i++)
-        out += (conjugate ? kernel::conj(pL[i]) : pL[i]) * pR[i];
+    parallelFor(cols * blocks, grain, [&](dim_t begin, dim_t end) {
+        for (dim_t t = begin; t < end; t++) {
+            const dim_t c = t / blocks;
+            const dim_t b = t - c * blocks;
+            const dim_t j = c % oDims[1];
+            const dim_t k = (c / oDims[1]) % oDims[2];
+            const dim_t l = c / (oDims[1] * oDims[2]);
 
-    if(both_conjugate) out = kernel::conj(out);
+            const dim_t i0 = b * DOT_BLOCK;
+            const T *pL = lhs.get() + i0 + j * (lDims[1] == oDims[1]) * lStrides[1]
+                                         + k * (lDims[2] == oDims[2]) * lStrides[2]
+                                         + l * (lDims[3] == oDims[3]) * lStrides[3];
+            const T *pR = rhs.get() + i0 + j * (rDims[1] == oDims[1]) * rStrides[1]
+                                         + k * (rDims[2] == oDims[2]) * rStrides[2]
+                                         + l * (rDims[3] == oDims[3]) * rStrides[3];
 
-    *output.get() = out;
+            const T val = dotBlock<T, conjugate>(pL, pR, std::min(DOT_BLOCK, N - i0));
+            if (blocks == 1) out[c] = both_conjugate ? kernel::conj(val) : val;
+            else             partial[t] = val;
+        }
+    });
 
+    if (blocks > 1) {
+        for (dim_t c = 0; c < cols; c++) {
+            T val = partial[c * blocks];
+            for (dim_t b = 1; b < blocks; b++) val += partial[c * blocks + b];
+            out[c] = both_conjugate ? kernel::conj(val) : val;
+        }
+    }
 }
 
 }
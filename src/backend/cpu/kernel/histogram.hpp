@@ -9,37 +9,155 @@
 
 #pragma once
 #include <Param.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace cpu
 {
 namespace kernel
 {
 
+// Minimum number of elements binned by one thread
+static const dim_t HISTOGRAM_GRAIN = 1 << 16;
+
+// Number of bins computed together before they are accumulated
+static const int HISTOGRAM_BLOCK = 256;
+
+template<typename InT>
+class histogram_binner
+{
+    double minval;
+    double step;
+    double rstep;
+    double lastBin;
+    unsigned nbins;
+    std::vector<unsigned> lut;
+
+public:
+    histogram_binner(unsigned const nbins_, double const minval_,
+                     double const maxval)
+        : minval(minval_),
+          step((float)((maxval - minval_) / (float)nbins_)),
+          rstep(1.0 / step), lastBin(nbins_ - 1), nbins(nbins_)
+    {
+        // 8-bit inputs only have 256 distinct values, the bins of all of them
+        // are computed upfront so that binning needs no arithmetic at all
+        if (sizeof(InT) == 1) {
+            lut.resize(256);
+            for (int b = 0; b < 256; b++) {
+                InT val = (InT)(unsigned char)b;
+                int bin = (int)((val - minval) / step);
+                bin = std::max(bin, 0);
+                bin = std::min(bin, (int)(nbins - 1));
+                lut[b] = bin;
+            }
+        }
+    }
+
+    // Adds the count elements at ptr to the bins
+    template<typename OutT>
+    void operator()(OutT *bins, const InT *ptr, dim_t count) const
+    {
+        if (sizeof(InT) == 1) {
+            for (dim_t i = 0; i < count; i++) {
+                bins[lut[(unsigned char)ptr[i]]]++;
+            }
+            return;
+        }
+
+        int idx[HISTOGRAM_BLOCK];
+        for (dim_t i = 0; i < count; i += HISTOGRAM_BLOCK) {
+            const int len = (int)std::min(count - i, (dim_t)HISTOGRAM_BLOCK);
+            const InT *data = ptr + i;
+
+            // Multiply by the reciprocal of the bin width instead of
+            // dividing. The result is corrected when the rounding of the
+            // reciprocal moves a value that lies on a bin edge.
+            for (int j = 0; j < len; j++) {
+                double offset = (double)data[j] - minval;
+                double q = offset * rstep;
+                q = q > 0 ? q : 0;
+                q = q < lastBin ? q : lastBin;
+                int bin = (int)q;
+                bin += (bin < lastBin) & (offset >= (bin + 1) * step);
+                bin -= (bin > 0) & (offset < bin * step);
+                idx[j] = bin;
+            }
+
+            for (int j = 0; j < len; j++) {
+                bins[idx[j]]++;
+            }
+        }
+    }
+};
+
 template<typename OutT, typename InT, bool IsLinear>
 void histogram(Param<OutT> out, CParam<InT> in,
                unsigned const nbins, double const minval, double const maxval)
 {
     dim4 const outDims   = out.dims();
-    float const step     = (maxval - minval)/(float)nbins;
     dim4 const inDims    = in.dims();
     dim4 const iStrides  = in.strides();
     dim4 const oStrides  = out.strides();
     dim_t const nElems   = inDims[0]*inDims[1];
+    dim_t const nSlices  = outDims[2]*outDims[3];
 
+    // Linear inputs are binned as a single row
+    dim_t const rowLen    = IsLinear ? nElems : inDims[0];
+    dim_t const rowStride = IsLinear ? nElems : iStrides[1];
 
-    for(dim_t b3 = 0; b3 < outDims[3]; b3++) {
-        OutT *outData    = out.get() + b3 * oStrides[3];
-        const InT* inData= in.get() + b3 * iStrides[3];
-        for(dim_t b2 = 0; b2 < outDims[2]; b2++) {
-            for(dim_t i=0; i<nElems; i++) {
-                int idx = IsLinear ? i : ((i % inDims[0]) + (i / inDims[0])*iStrides[1]);
-                int bin = (int)((inData[idx] - minval) / step);
-                bin = std::max(bin, 0);
-                bin = std::min(bin, (int)(nbins - 1));
-                outData[bin]++;
+    histogram_binner<InT> binner(nbins, minval, maxval);
+
+    // Bins the elements [begin, end) of the slice
+    auto binRange = [&](OutT *bins, const InT *inData, dim_t begin, dim_t end) {
+        for (dim_t i = begin; i < end;) {
+            dim_t row   = i / rowLen;
+            dim_t col   = i % rowLen;
+            dim_t count = std::min(rowLen - col, end - i);
+            binner(bins, inData + row * rowStride + col, count);
+            i += count;
+        }
+    };
+
+    auto sliceData = [&](dim_t s, const InT *&inData, OutT *&outData) {
+        dim_t b2 = s % outDims[2];
+        dim_t b3 = s / outDims[2];
+        inData  = in.get() + b3 * iStrides[3] + b2 * iStrides[2];
+        outData = out.get() + b3 * oStrides[3] + b2 * oStrides[2];
+    };
+
+    const unsigned nchunks = getNumChunks(nElems, HISTOGRAM_GRAIN);
+
+    if (nchunks <= 1 || nSlices >= (dim_t)getNumThreads()) {
+        // Every slice has its own output bins
+        parallelFor(nSlices, 1, [&](dim_t sbegin, dim_t send) {
+            for (dim_t s = sbegin; s < send; s++) {
+                const InT *inData; OutT *outData;
+                sliceData(s, inData, outData);
+                binRange(outData, inData, 0, nElems);
+            }
+        });
+    } else {
+        // Each chunk of a slice is binned into private bins which are summed
+        // into the output once all the chunks are done
+        std::vector<std::vector<OutT>> privBins(nchunks, std::vector<OutT>(nbins));
+        for (dim_t s = 0; s < nSlices; s++) {
+            const InT *inData; OutT *outData;
+            sliceData(s, inData, outData);
+
+            parallelTasks(nchunks, [&](unsigned chunk) {
+                dim_t begin, end;
+                chunkRange(nElems, nchunks, chunk, begin, end);
+                std::fill(privBins[chunk].begin(), privBins[chunk].end(), OutT(0));
+                binRange(privBins[chunk].data(), inData, begin, end);
+            });
+
+            for (unsigned chunk = 0; chunk < nchunks; chunk++) {
+                for (unsigned b = 0; b < nbins; b++) {
+                    outData[b] += privBins[chunk][b];
+                }
             }
-            inData  += iStrides[2];
-            outData += oStrides[2];
         }
     }
 }
@@ -10,6 +10,10 @@
 #pragma once
 #include <Param.hpp>
 #include <ops.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace cpu
 {
@@ -68,46 +72,257 @@ struct MinMaxOp<af_max_t, T>
     }
 };
 
-template<af_op_t op, typename T, int D>
-struct ireduce_dim
+// Minimum number of elements reduced by a single thread
+static const dim_t IREDUCE_GRAIN = 1 << 16;
+
+// Number of independent candidates tracked while scanning contiguous data
+static const int IREDUCE_LANES = 8;
+
+// Index of a lane that has not found a candidate yet
+static const uint IREDUCE_NO_INDEX = ~0u;
+
+// Types for which comparing the values directly gives the same ordering as
+// comparing their cabs, so that candidates can be updated without branches
+template<typename T>
+struct is_lane_reducible
+{
+    static const bool value = std::is_arithmetic<T>::value &&
+                              !std::is_same<T, char>::value &&
+                              !std::is_same<T, intl>::value &&
+                              !std::is_same<T, uintl>::value;
+};
+
+// Replaces the candidate (val, idx) by (v, i) when MinMaxOp would. Indices
+// must be visited in increasing order. val is never NaN.
+template<af_op_t op, typename T, bool Lanes = is_lane_reducible<T>::value>
+struct ireduce_step
 {
-    void operator()(Param<T> output, Param<uint> locParam, const dim_t outOffset,
-                    CParam<T> input, const dim_t inOffset, const int dim)
+    void operator()(T &val, uint &idx, const T v, const uint i) const
     {
-        const af::dim4 odims    = output.dims();
-        const af::dim4 ostrides = output.strides();
-        const af::dim4 istrides = input.strides();
-        const int D1 = D - 1;
-        for (dim_t i = 0; i < odims[D1]; i++) {
-            ireduce_dim<op, T, D1>()(output, locParam, outOffset + i * ostrides[D1],
-                                     input, inOffset + i * istrides[D1], dim);
-        }
+        MinMaxOp<op, T> Op(val, idx);
+        Op(v, i);
+        val = Op.m_val;
+        idx = Op.m_idx;
     }
 };
 
 template<af_op_t op, typename T>
-struct ireduce_dim<op, T, 0>
+struct ireduce_step<op, T, true>
 {
-    void operator()(Param<T> output, Param<uint> locParam, const dim_t outOffset,
-                    CParam<T> input, const dim_t inOffset, const int dim)
+    void operator()(T &val, uint &idx, const T v, const uint i) const
     {
-        const af::dim4 idims = input.dims();
-        const af::dim4 istrides = input.strides();
+        // NaNs fail both comparisons and are never taken
+        const bool take = (op == af_min_t) ? (v <= val) : (v > val);
+        val = take ? v : val;
+        idx = take ? i : idx;
+    }
+};
+
+// Folds the elements ptr[i * stride], i in [begin, end), into Op using the
+// index base + i. Contiguous elements are spread across IREDUCE_LANES
+// candidates which are merged at the end.
+template<af_op_t op, typename T>
+void ireduceRange(MinMaxOp<op, T> &Op, const T *ptr, const dim_t stride,
+                  const dim_t begin, const dim_t end, const dim_t base)
+{
+    dim_t i = begin;
+    if (is_lane_reducible<T>::value && stride == 1) {
+        ireduce_step<op, T> step;
+        T    lval[IREDUCE_LANES];
+        uint lidx[IREDUCE_LANES];
+        for (int l = 0; l < IREDUCE_LANES; l++) {
+            lval[l] = Binary<T, op>::init();
+            lidx[l] = IREDUCE_NO_INDEX;
+        }
 
-        T const * const in = input.get();
-        T * out = output.get();
-        uint * loc = locParam.get();
+        for (; i + IREDUCE_LANES <= end; i += IREDUCE_LANES) {
+            for (int l = 0; l < IREDUCE_LANES; l++) {
+                step(lval[l], lidx[l], ptr[i + l], (uint)(base + i + l));
+            }
+        }
 
-        dim_t stride = istrides[dim];
-        MinMaxOp<op, T> Op(in[inOffset], 0);
-        for (dim_t i = 0; i < idims[dim]; i++) {
-            Op(in[inOffset + i * stride], i);
+        for (int l = 0; l < IREDUCE_LANES; l++) {
+            if (lidx[l] != IREDUCE_NO_INDEX) Op(lval[l], lidx[l]);
         }
+    }
 
-        out[outOffset] = Op.m_val;
-        loc[outOffset] = Op.m_idx;
+    for (; i < end; i++) {
+        Op(ptr[i * stride], (uint)(base + i));
     }
-};
+}
+
+// Reduces the elements ptr[i * stride], i in [0, n), with index base + i.
+// Long ranges are split into chunks reduced concurrently. A chunk whose first
+// element is NaN and which found nothing better holds no candidate and is
+// left out of the merge.
+template<af_op_t op, typename T>
+MinMaxOp<op, T> ireduceParallel(const T *ptr, const dim_t stride,
+                                const dim_t n, const dim_t base)
+{
+    const unsigned nchunks = getNumChunks(n, IREDUCE_GRAIN);
+    std::vector<MinMaxOp<op, T>> partial(nchunks, MinMaxOp<op, T>(ptr[0], base));
+
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end;
+        chunkRange(n, nchunks, chunk, begin, end);
+        MinMaxOp<op, T> Op(ptr[begin * stride], (uint)(base + begin));
+        ireduceRange(Op, ptr, stride, begin, end, base);
+        partial[chunk] = Op;
+    });
+
+    MinMaxOp<op, T> Op = partial[0];
+    for (unsigned chunk = 1; chunk < nchunks; chunk++) {
+        dim_t begin, end;
+        chunkRange(n, nchunks, chunk, begin, end);
+        const MinMaxOp<op, T> &part = partial[chunk];
+        if (part.m_idx == base + begin && is_nan(ptr[begin * stride])) continue;
+        Op(part.m_val, part.m_idx);
+    }
+    return Op;
+}
+
+// Finds the minimum or maximum of input along dim and its index.
+//
+// Reductions along the first dimension scan contiguous columns. Along the
+// other dimensions, whole rows of candidates are updated for every step
+// along dim, so that both the reads and the updates are contiguous. The
+// outputs are split across threads, and when there are fewer outputs than
+// threads each output is reduced by several of them.
+template<af_op_t op, typename T>
+void ireduce(Param<T> output, Param<uint> locParam, CParam<T> input, const int dim)
+{
+    const af::dim4 idims    = input.dims();
+    const af::dim4 istrides = input.strides();
+    const af::dim4 odims    = output.dims();
+    const af::dim4 ostrides = output.strides();
+
+    const dim_t nout   = odims.elements();
+    const dim_t n      = idims[dim];
+    const dim_t stride = istrides[dim];
+
+    T const * const in = input.get();
+    T * const out      = output.get();
+    uint * const loc   = locParam.get();
+
+    auto offsets = [&](dim_t o, dim_t &inOff, dim_t &outOff) {
+        dim_t o0 = o % odims[0];
+        dim_t o1 = (o / odims[0]) % odims[1];
+        dim_t o2 = (o / (odims[0] * odims[1])) % odims[2];
+        dim_t o3 = o / (odims[0] * odims[1] * odims[2]);
+        inOff  = o0 * istrides[0] + o1 * istrides[1] + o2 * istrides[2] + o3 * istrides[3];
+        outOff = o0 * ostrides[0] + o1 * ostrides[1] + o2 * ostrides[2] + o3 * ostrides[3];
+    };
+
+    if (nout < (dim_t)getNumThreads() && getNumChunks(n, IREDUCE_GRAIN) > 1) {
+        for (dim_t o = 0; o < nout; o++) {
+            dim_t inOff, outOff;
+            offsets(o, inOff, outOff);
+            MinMaxOp<op, T> Op = ireduceParallel<op, T>(in + inOff, stride, n, 0);
+            out[outOff] = Op.m_val;
+            loc[outOff] = Op.m_idx;
+        }
+        return;
+    }
+
+    const dim_t grain = std::max(IREDUCE_GRAIN / std::max(n, (dim_t)1), (dim_t)1);
+
+    if (dim == 0) {
+        parallelFor(nout, grain, [&](dim_t begin, dim_t end) {
+            for (dim_t o = begin; o < end; o++) {
+                dim_t inOff, outOff;
+                offsets(o, inOff, outOff);
+                MinMaxOp<op, T> Op(in[inOff], 0);
+                ireduceRange(Op, in + inOff, stride, 0, n, 0);
+                out[outOff] = Op.m_val;
+                loc[outOff] = Op.m_idx;
+            }
+        });
+        return;
+    }
+
+    parallelFor(nout, grain, [&](dim_t begin, dim_t end) {
+        ireduce_step<op, T> step;
+        for (dim_t o = begin; o < end;) {
+            const dim_t count = std::min(odims[0] - o % odims[0], end - o);
+            dim_t inOff, outOff;
+            offsets(o, inOff, outOff);
+
+            const T *inRow = in + inOff;
+            T *outRow      = out + outOff;
+            uint *locRow   = loc + outOff;
+
+            for (dim_t j = 0; j < count; j++) {
+                MinMaxOp<op, T> Op(inRow[j], 0);
+                outRow[j] = Op.m_val;
+                locRow[j] = Op.m_idx;
+            }
+
+            for (dim_t i = 1; i < n; i++) {
+                const T *row = inRow + i * stride;
+                for (dim_t j = 0; j < count; j++) {
+                    step(outRow[j], locRow[j], row[j], (uint)i);
+                }
+            }
+            o += count;
+        }
+    });
+}
+
+// Finds the minimum or maximum of all the elements of in. The index of an
+// element is its offset from the start of in. The elements are split into
+// chunks that are reduced concurrently, a whole linear array being treated
+// as a single row.
+template<af_op_t op, typename T>
+T ireduce_all(uint *loc, CParam<T> in)
+{
+    const af::dim4 dims    = in.dims();
+    const af::dim4 strides = in.strides();
+    const dim_t nelems     = dims.elements();
+    T const * const inPtr  = in.get();
+
+    const bool isLinear = strides[1] == dims[0] &&
+                          strides[2] == dims[0] * dims[1] &&
+                          strides[3] == dims[0] * dims[1] * dims[2];
+    const dim_t rowLen  = isLinear ? nelems : dims[0];
+
+    auto rowOffset = [&](dim_t row) {
+        dim_t r1 = row % dims[1];
+        dim_t r2 = (row / dims[1]) % dims[2];
+        dim_t r3 = row / (dims[1] * dims[2]);
+        return r3 * strides[3] + r2 * strides[2] + r1 * strides[1];
+    };
+
+    const unsigned nchunks = getNumChunks(nelems, IREDUCE_GRAIN);
+    std::vector<MinMaxOp<op, T>> partial(nchunks, MinMaxOp<op, T>(inPtr[0], 0));
+    std::vector<dim_t> first(nchunks);
+
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end;
+        chunkRange(nelems, nchunks, chunk, begin, end);
+        first[chunk] = rowOffset(begin / rowLen) + begin % rowLen;
+
+        MinMaxOp<op, T> Op(inPtr[first[chunk]], (uint)first[chunk]);
+        for (dim_t i = begin; i < end;) {
+            dim_t row   = i / rowLen;
+            dim_t col   = i % rowLen;
+            dim_t count = std::min(rowLen - col, end - i);
+            dim_t off   = rowOffset(row);
+            ireduceRange(Op, inPtr + off, 1, col, col + count, off);
+            i += count;
+        }
+        partial[chunk] = Op;
+    });
+
+    MinMaxOp<op, T> Op = partial[0];
+    for (unsigned chunk = 1; chunk < nchunks; chunk++) {
+        const MinMaxOp<op, T> &part = partial[chunk];
+        if (part.m_idx == first[chunk] && is_nan(inPtr[first[chunk]])) continue;
+        Op(part.m_val, part.m_idx);
+    }
+
+    *loc = Op.m_idx;
+    return Op.m_val;
+}
 
 }
 }
@@ -0,0 +1,199 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <parallel.hpp>
+#include <af/defines.h>
+#include <algorithm>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Columns at least this long are sorted by parallelMergeSort when comparisons
+// are needed
+static const dim_t MERGE_SORT_THRESHOLD = 1 << 16;
+
+// Minimum number of elements in a run sorted by a single thread
+static const dim_t MERGE_SORT_GRAIN = 1 << 15;
+
+// Length of the runs insertion sorted before merging in stableSortRun
+static const dim_t MERGE_SORT_RUN = 32;
+
+// Stable merge sort of data[0, n) using tmp[0, n) as the merge buffer
+template<typename T, typename Compare>
+void stableSortRun(T *data, T *tmp, const dim_t n, Compare comp)
+{
+    for (dim_t i = 0; i < n; i += MERGE_SORT_RUN) {
+        T *begin = data + i;
+        T *end   = data + std::min(i + MERGE_SORT_RUN, n);
+        for (T *it = begin + 1; it < end; ++it) {
+            T val = *it;
+            T *pos = it;
+            for (; pos > begin && comp(val, *(pos - 1)); --pos) {
+                *pos = *(pos - 1);
+            }
+            *pos = val;
+        }
+    }
+
+    T *src = data, *dst = tmp;
+    for (dim_t width = MERGE_SORT_RUN; width < n; width *= 2) {
+        for (dim_t i = 0; i < n; i += 2 * width) {
+            dim_t mid = std::min(i + width, n);
+            dim_t end = std::min(i + 2 * width, n);
+            std::merge(src + i, src + mid, src + mid, src + end, dst + i, comp);
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != data) std::copy(src, src + n, data);
+}
+
+// Finds the positions splits[r] at which each of the sorted runs has to be
+// cut so that the elements before the cuts are the rank smallest elements of
+// all the runs. Equal elements are ordered by their run, which keeps the
+// merge stable.
+template<typename T, typename Compare>
+void multiwaySplit(const T *data, const std::vector<dim_t> &runStart,
+                   const dim_t rank, Compare comp, std::vector<dim_t> &splits)
+{
+    const unsigned nruns = runStart.size() - 1;
+    std::vector<dim_t> lo(nruns), hi(nruns), count(nruns);
+    for (unsigned r = 0; r < nruns; r++) {
+        lo[r] = 0;
+        hi[r] = runStart[r + 1] - runStart[r];
+    }
+
+    while (true) {
+        // Pick the pivot from the middle of the widest remaining interval
+        unsigned prun = nruns;
+        dim_t width = 0;
+        for (unsigned r = 0; r < nruns; r++) {
+            if (hi[r] - lo[r] > width) {
+                width = hi[r] - lo[r];
+                prun  = r;
+            }
+        }
+        if (prun == nruns) break;
+
+        const dim_t ppos = (lo[prun] + hi[prun]) / 2;
+        const T &pivot = data[runStart[prun] + ppos];
+
+        // Number of elements of every run that come before the pivot
+        dim_t total = 0;
+        for (unsigned r = 0; r < nruns; r++) {
+            const T *begin = data + runStart[r];
+            const T *end   = data + runStart[r + 1];
+            if (r < prun) {
+                count[r] = std::upper_bound(begin, end, pivot, comp) - begin;
+            } else if (r > prun) {
+                count[r] = std::lower_bound(begin, end, pivot, comp) - begin;
+            } else {
+                count[r] = ppos;
+            }
+            total += count[r];
+        }
+
+        if (total == rank) {
+            lo = count;
+            break;
+        } else if (total < rank) {
+            for (unsigned r = 0; r < nruns; r++) lo[r] = std::max(lo[r], count[r]);
+            lo[prun] = ppos + 1;
+        } else {
+            for (unsigned r = 0; r < nruns; r++) hi[r] = std::min(hi[r], count[r]);
+            hi[prun] = ppos;
+        }
+    }
+
+    splits = lo;
+}
+
+// Sorts data[0, n) by sorting contiguous runs concurrently and merging all
+// the runs at once. The output is split into one range per thread, the
+// positions at which every run has to be cut for each range are selected,
+// and the threads merge their ranges independently. tmp is the only extra
+// memory used and is resized to n.
+template<typename T, typename Compare>
+void parallelMergeSort(T *data, const dim_t n, Compare comp,
+                       std::vector<T> &tmp, bool isStable)
+{
+    const unsigned nruns = getNumChunks(n, MERGE_SORT_GRAIN);
+    if (nruns <= 1) {
+        if (isStable) {
+            tmp.resize(n);
+            stableSortRun(data, tmp.data(), n, comp);
+        } else {
+            std::sort(data, data + n, comp);
+        }
+        return;
+    }
+
+    tmp.resize(n);
+    std::vector<dim_t> runStart(nruns + 1);
+    for (unsigned r = 0; r < nruns; r++) {
+        dim_t end;
+        chunkRange(n, nruns, r, runStart[r], end);
+    }
+    runStart[nruns] = n;
+
+    parallelTasks(nruns, [&](unsigned r) {
+        dim_t begin = runStart[r], len = runStart[r + 1] - begin;
+        if (isStable) stableSortRun(data + begin, tmp.data() + begin, len, comp);
+        else          std::sort(data + begin, data + begin + len, comp);
+    });
+
+    // splits[t][r] is where run r is cut at the start of output range t
+    std::vector<std::vector<dim_t>> splits(nruns + 1);
+    splits[0].assign(nruns, 0);
+    for (unsigned r = 0; r < nruns; r++) {
+        splits[nruns].push_back(runStart[r + 1] - runStart[r]);
+    }
+    parallelTasks(nruns - 1, [&](unsigned t) {
+        multiwaySplit(data, runStart, runStart[t + 1], comp, splits[t + 1]);
+    });
+
+    parallelTasks(nruns, [&](unsigned t) {
+        std::vector<dim_t> pos(nruns), end(nruns);
+        std::vector<unsigned> heap;
+        for (unsigned r = 0; r < nruns; r++) {
+            pos[r] = runStart[r] + splits[t][r];
+            end[r] = runStart[r] + splits[t + 1][r];
+            if (pos[r] < end[r]) heap.push_back(r);
+        }
+
+        // Heap of the runs ordered by their next element, the front being the
+        // smallest one. Equal elements are taken from the earlier run first.
+        auto after = [&](unsigned a, unsigned b) {
+            if (comp(data[pos[b]], data[pos[a]])) return true;
+            if (comp(data[pos[a]], data[pos[b]])) return false;
+            return a > b;
+        };
+        std::make_heap(heap.begin(), heap.end(), after);
+
+        T *out = tmp.data() + runStart[t];
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), after);
+            unsigned r = heap.back();
+            *out++ = data[pos[r]++];
+            if (pos[r] < end[r]) std::push_heap(heap.begin(), heap.end(), after);
+            else                 heap.pop_back();
+        }
+    });
+
+    parallelFor(n, MERGE_SORT_GRAIN, [&](dim_t begin, dim_t end) {
+        std::copy(tmp.data() + begin, tmp.data() + end, data + begin);
+    });
+}
+
+}
+}
@@ -0,0 +1,86 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <parallel.hpp>
+#include <common/moving.hpp>
+#include <af/defines.h>
+#include <algorithm>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Minimum number of input elements handled by a single thread
+static const dim_t MOVING_GRAIN = 1 << 16;
+
+// Computes the statistic stat of every window of window elements along dim,
+// the windows starting every step elements. Series along dim are split
+// across threads. When there are fewer series than threads, the windows of
+// each series are split instead, every thread starting its own accumulator.
+template<typename Ti, typename To>
+void moving(Param<To> output, CParam<Ti> input, const af_stat_type stat,
+            const dim_t window, const dim_t step, const af_var_bias bias,
+            const int dim)
+{
+    const af::dim4 idims    = input.dims();
+    const af::dim4 istrides = input.strides();
+    const af::dim4 odims    = output.dims();
+    const af::dim4 ostrides = output.strides();
+
+    af::dim4 rdims = idims;
+    rdims[dim] = 1;
+
+    const dim_t nseries = rdims.elements();
+    const dim_t nout    = odims[dim];
+    const dim_t istride = istrides[dim];
+    const dim_t ostride = ostrides[dim];
+
+    auto offsets = [&](dim_t o, dim_t &inOff, dim_t &outOff) {
+        dim_t o0 = o % rdims[0];
+        dim_t o1 = (o / rdims[0]) % rdims[1];
+        dim_t o2 = (o / (rdims[0] * rdims[1])) % rdims[2];
+        dim_t o3 = o / (rdims[0] * rdims[1] * rdims[2]);
+        inOff  = o0 * istrides[0] + o1 * istrides[1] + o2 * istrides[2] + o3 * istrides[3];
+        outOff = o0 * ostrides[0] + o1 * ostrides[1] + o2 * ostrides[2] + o3 * ostrides[3];
+    };
+
+    auto series = [&](dim_t s, dim_t kbegin, dim_t kend, std::vector<dim_t> &queue) {
+        dim_t inOff, outOff;
+        offsets(s, inOff, outOff);
+        common::movingSeries(output.get() + outOff, ostride, input.get() + inOff, istride,
+                             stat, window, step, bias, kbegin, kend, queue);
+    };
+
+    // Every window costs step elements plus a window to start a new chunk
+    const dim_t outGrain = std::max((MOVING_GRAIN + window) / step, (dim_t)1);
+
+    if (nseries >= (dim_t)getNumThreads() || getNumChunks(nout, outGrain) <= 1) {
+        const dim_t len = idims[dim];
+        parallelFor(nseries, std::max(MOVING_GRAIN / len, (dim_t)1),
+                    [&](dim_t begin, dim_t end) {
+            std::vector<dim_t> queue;
+            for (dim_t s = begin; s < end; s++) series(s, 0, nout, queue);
+        });
+        return;
+    }
+
+    for (dim_t s = 0; s < nseries; s++) {
+        parallelFor(nout, outGrain, [&](dim_t kbegin, dim_t kend) {
+            std::vector<dim_t> queue;
+            series(s, kbegin, kend, queue);
+        });
+    }
+}
+
+}
+}
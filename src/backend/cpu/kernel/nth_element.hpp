@@ -0,0 +1,83 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Writes the ranks[i]-th smallest element of every slice along dim to
+// position i of the same slice in out. Each slice is copied to a scratch
+// buffer and partitioned with std::nth_element, visiting the ranks in
+// ascending order so that every selection only partitions the elements
+// after the previously selected rank.
+template<typename T>
+void nthElement(Param<T> out, CParam<T> in, const unsigned dim,
+                const std::vector<dim_t> ranks)
+{
+    const af::dim4 idims    = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 ostrides = out.strides();
+
+    int odim[3];
+    for (int i = 0, j = 0; i < 4; i++) {
+        if (i != (int)dim) odim[j++] = i;
+    }
+
+    const dim_t len     = idims[dim];
+    const dim_t nslices = idims.elements() / len;
+    const dim_t istride = istrides[dim];
+    const dim_t ostride = ostrides[dim];
+
+    // Visit the ranks in ascending order and remember where they go
+    std::vector<std::pair<dim_t, dim_t>> order(ranks.size());
+    for (size_t i = 0; i < ranks.size(); i++) {
+        order[i] = std::make_pair(ranks[i], (dim_t)i);
+    }
+    std::sort(order.begin(), order.end());
+
+    parallelFor(nslices, std::max(dim_t(1), dim_t(1 << 16) / len),
+                [&](dim_t sbegin, dim_t send) {
+        std::vector<T> buf(len);
+        for (dim_t s = sbegin; s < send; s++) {
+            dim_t s0 = s % idims[odim[0]];
+            dim_t s1 = (s / idims[odim[0]]) % idims[odim[1]];
+            dim_t s2 = s / (idims[odim[0]] * idims[odim[1]]);
+
+            const T *iptr = in.get() + s0 * istrides[odim[0]] +
+                            s1 * istrides[odim[1]] + s2 * istrides[odim[2]];
+                  T *optr = out.get() + s0 * ostrides[odim[0]] +
+                            s1 * ostrides[odim[1]] + s2 * ostrides[odim[2]];
+
+            for (dim_t i = 0; i < len; i++) buf[i] = iptr[i * istride];
+
+            dim_t first = 0;
+            for (size_t r = 0; r < order.size(); r++) {
+                dim_t rank = order[r].first;
+                if (rank >= first) {
+                    std::nth_element(buf.begin() + first, buf.begin() + rank,
+                                     buf.end());
+                    first = rank + 1;
+                }
+                optr[order[r].second * ostride] = buf[rank];
+            }
+        }
+    });
+}
+
+}
+}
@@ -0,0 +1,159 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <parallel.hpp>
+#include <af/defines.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Columns shorter than this are sorted using comparisons
+static const dim_t RADIX_SORT_THRESHOLD = 1 << 12;
+
+// Minimum number of elements histogrammed and scattered by one thread
+static const dim_t RADIX_SORT_GRAIN = 1 << 16;
+
+static const int RADIX_BITS    = 8;
+static const int RADIX_BUCKETS = 1 << RADIX_BITS;
+
+template<int bytes> struct radix_bits_type;
+template<> struct radix_bits_type<1> { typedef uint8_t  type; };
+template<> struct radix_bits_type<2> { typedef uint16_t type; };
+template<> struct radix_bits_type<4> { typedef uint32_t type; };
+template<> struct radix_bits_type<8> { typedef uint64_t type; };
+
+// Maps keys to unsigned integers with the same ordering. The sign bit of
+// signed integers is flipped. Negative floating point numbers have all
+// their bits flipped, positive ones only the sign bit.
+template<typename T, bool isFloat = std::is_floating_point<T>::value>
+struct radix_key
+{
+    typedef typename radix_bits_type<sizeof(T)>::type Bits;
+    static const Bits signBit = Bits(1) << (8 * sizeof(T) - 1);
+
+    static Bits get(T val)
+    {
+        Bits bits;
+        std::memcpy(&bits, &val, sizeof(T));
+        return std::is_signed<T>::value ? Bits(bits ^ signBit) : bits;
+    }
+};
+
+template<typename T>
+struct radix_key<T, true>
+{
+    typedef typename radix_bits_type<sizeof(T)>::type Bits;
+    static const Bits signBit = Bits(1) << (8 * sizeof(T) - 1);
+
+    static Bits get(T val)
+    {
+        // -0 and +0 compare equal and must keep their relative order
+        if (val == T(0)) val = T(0);
+        Bits bits;
+        std::memcpy(&bits, &val, sizeof(T));
+        return (bits & signBit) ? Bits(~bits) : Bits(bits | signBit);
+    }
+};
+
+// Keys that can be sorted using radixSort
+template<typename T>
+struct is_radix_sortable
+{
+    static const bool value = std::is_arithmetic<T>::value &&
+                              !std::is_same<T, bool>::value;
+};
+
+// Stable least significant digit radix sort of keys[0, n) in ascending
+// order. When idx is not null, it is permuted along with the keys. Every
+// pass histograms the digits of contiguous chunks concurrently, after which
+// each chunk scatters its elements to the offsets reserved for it. Passes in
+// which all the keys share the same digit are skipped.
+//
+// keyTmp and idxTmp are scratch buffers that are resized to n as needed.
+template<typename T>
+void radixSort(T *keys, uint *idx, const dim_t n,
+               std::vector<T> &keyTmp, std::vector<uint> &idxTmp)
+{
+    typedef radix_key<T> Key;
+    if (n < 2) return;
+
+    keyTmp.resize(n);
+    if (idx) idxTmp.resize(n);
+
+    const unsigned nchunks = getNumChunks(n, RADIX_SORT_GRAIN);
+    std::vector<dim_t> offsets(nchunks * RADIX_BUCKETS);
+
+    T    *srcKey = keys,   *dstKey = keyTmp.data();
+    uint *srcIdx = idx,    *dstIdx = idx ? idxTmp.data() : nullptr;
+
+    for (unsigned pass = 0; pass < sizeof(T); pass++) {
+        const int shift = pass * RADIX_BITS;
+        auto digit = [shift](T val) {
+            return (unsigned)(Key::get(val) >> shift) & (RADIX_BUCKETS - 1);
+        };
+
+        std::fill(offsets.begin(), offsets.end(), 0);
+        parallelTasks(nchunks, [&](unsigned chunk) {
+            dim_t begin, end;
+            chunkRange(n, nchunks, chunk, begin, end);
+            dim_t *count = offsets.data() + chunk * RADIX_BUCKETS;
+            for (dim_t i = begin; i < end; i++) {
+                count[digit(srcKey[i])]++;
+            }
+        });
+
+        // Convert the counts into the offset every chunk starts writing the
+        // elements of each bucket at
+        dim_t total = 0;
+        bool skip = false;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            dim_t bucket = 0;
+            for (unsigned c = 0; c < nchunks; c++) {
+                dim_t count = offsets[c * RADIX_BUCKETS + b];
+                offsets[c * RADIX_BUCKETS + b] = total + bucket;
+                bucket += count;
+            }
+            skip  |= (bucket == n);
+            total += bucket;
+        }
+        if (skip) continue;
+
+        parallelTasks(nchunks, [&](unsigned chunk) {
+            dim_t begin, end;
+            chunkRange(n, nchunks, chunk, begin, end);
+            dim_t *offset = offsets.data() + chunk * RADIX_BUCKETS;
+            for (dim_t i = begin; i < end; i++) {
+                dim_t pos = offset[digit(srcKey[i])]++;
+                dstKey[pos] = srcKey[i];
+                if (srcIdx) dstIdx[pos] = srcIdx[i];
+            }
+        });
+
+        std::swap(srcKey, dstKey);
+        std::swap(srcIdx, dstIdx);
+    }
+
+    if (srcKey != keys) {
+        parallelFor(n, RADIX_SORT_GRAIN, [&](dim_t begin, dim_t end) {
+            std::copy(srcKey + begin, srcKey + end, keys + begin);
+            if (idx) std::copy(srcIdx + begin, srcIdx + end, idx + begin);
+        });
+    }
+}
+
+}
+}
@@ -9,6 +9,11 @@
 
 #pragma once
 #include <Param.hpp>
+#include <parallel.hpp>
+#include <kernel/Array.hpp>
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 namespace cpu
 {
@@ -65,5 +70,122 @@ struct reduce_dim<op, Ti, To, 0>
     }
 };
 
+// Minimum number of elements reduced by a single thread in reduce_all
+static const dim_t REDUCE_ALL_GRAIN = 1 << 16;
+
+// Number of elements reduced between two checks for an early exit
+static const dim_t REDUCE_ALL_BLOCK = 4096;
+
+// Returns true once a partial result of the reduction determines the final
+// result, so that the remaining elements do not need to be read
+template<af_op_t op, typename To>
+struct reduce_all_decided
+{
+    bool operator()(To) const { return false; }
+};
+
+template<typename To>
+struct reduce_all_decided<af_or_t, To>
+{
+    bool operator()(To val) const { return val != To(0); }
+};
+
+template<typename To>
+struct reduce_all_decided<af_and_t, To>
+{
+    bool operator()(To val) const { return val == To(0); }
+};
+
+// Reduces an evaluated array. The elements are split into contiguous chunks
+// reduced by different threads, and every thread stops as soon as any of
+// them has found an element that decides the result.
+template<af_op_t op, typename Ti, typename To>
+To reduce_all(CParam<Ti> in)
+{
+    const af::dim4 dims    = in.dims();
+    const af::dim4 strides = in.strides();
+    const dim_t nelems     = dims.elements();
+    const dim_t rowLen     = dims[0];
+
+    const unsigned nchunks = getNumChunks(nelems, REDUCE_ALL_GRAIN);
+    std::vector<To> partial(nchunks, Binary<To, op>::init());
+    std::atomic<bool> finished(false);
+
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        Transform<Ti, To, op> transform;
+        Binary<To, op> reduce;
+        reduce_all_decided<op, To> decided;
+
+        dim_t begin, end;
+        chunkRange(nelems, nchunks, chunk, begin, end);
+
+        To out_val = Binary<To, op>::init();
+        for (dim_t i = begin; i < end;) {
+            if (finished.load(std::memory_order_relaxed)) break;
+
+            dim_t row   = i / rowLen;
+            dim_t col   = i % rowLen;
+            dim_t count = std::min(std::min(rowLen - col, end - i), REDUCE_ALL_BLOCK);
+
+            dim_t r1 = row % dims[1];
+            dim_t r2 = (row / dims[1]) % dims[2];
+            dim_t r3 = row / (dims[1] * dims[2]);
+            const Ti *inPtr = in.get() + r3 * strides[3] + r2 * strides[2] +
+                              r1 * strides[1] + col;
+
+            for (dim_t j = 0; j < count; j++) {
+                out_val = reduce(transform(inPtr[j]), out_val);
+            }
+
+            if (decided(out_val)) finished = true;
+            i += count;
+        }
+        partial[chunk] = out_val;
+    });
+
+    Binary<To, op> reduce;
+    To out = Binary<To, op>::init();
+    for (unsigned chunk = 0; chunk < nchunks; chunk++) {
+        out = reduce(partial[chunk], out);
+    }
+    return out;
+}
+
+// Reduces the output of a JIT tree without materializing it. The elements
+// are split into chunks as for evaluated arrays, and every thread evaluates
+// its chunk from its own copy of the tree one vector at a time. The threads
+// stop as soon as any of them knows the result.
+template<af_op_t op, typename Ti, typename To>
+To reduce_all(jit::Node_ptr node, const af::dim4 dims)
+{
+    const unsigned nchunks = getNumChunks(dims.elements(), REDUCE_ALL_GRAIN);
+    std::vector<To> partial(nchunks, Binary<To, op>::init());
+    std::atomic<bool> finished(false);
+
+    Transform<Ti, To, op> transform;
+    Binary<To, op> reduce;
+    reduce_all_decided<op, To> decided;
+
+    parallelEvalBlocks<Ti>(node, dims, nchunks,
+                           [&](unsigned chunk, const Ti *vals, dim_t, int lim) {
+        if (finished.load(std::memory_order_relaxed)) return true;
+
+        To out_val = partial[chunk];
+        for (int i = 0; i < lim; i++) {
+            out_val = reduce(transform(vals[i]), out_val);
+        }
+        partial[chunk] = out_val;
+
+        if (decided(out_val)) finished = true;
+        return decided(out_val);
+    });
+
+    To out = Binary<To, op>::init();
+    for (unsigned chunk = 0; chunk < nchunks; chunk++) {
+        out = reduce(partial[chunk], out);
+    }
+    return out;
+}
+
 }
 }
@@ -9,84 +9,193 @@
 
 #pragma once
 #include <Param.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace cpu
 {
 namespace kernel
 {
 
-template<af_op_t op, typename Ti, typename Tk, typename To, int D>
-struct scan_dim_by_key
+// Minimum number of elements handled by a single block of the segmented scan
+static const dim_t SCAN_BY_KEY_BLOCK_SIZE = 1 << 14;
+
+template<af_op_t op, typename Ti, typename Tk, typename To>
+struct scan_by_key_block
 {
+    const Ti* in;
+    const Tk* key;
+          To* out;
+    dim_t istride;
+    dim_t kstride;
+    dim_t ostride;
+    dim_t len;
     bool inclusive_scan;
-    scan_dim_by_key(bool inclusiveSanKey) : inclusive_scan(inclusiveSanKey) {}
 
-    void operator()(Param<To> out, dim_t outOffset,
-                    CParam<Tk> key, dim_t keyOffset,
-                    CParam<Ti> in, dim_t inOffset,
-                    const int dim) const
+    // Scans the elements [begin, end) of the slice, starting a new segment at
+    // begin. For exclusive scans the value at element i is written to i + 1,
+    // so the blocks write to disjoint locations. Returns the value of the
+    // last element and whether the last segment extends to begin.
+    bool scan(dim_t begin, dim_t end, To &last) const
     {
-        const dim4 odims    = out.dims();
-        const dim4 ostrides = out.strides();
-        const dim4 kstrides = key.strides();
-        const dim4 istrides = in.strides();
-
-        const int D1 = D - 1;
-        for (dim_t i = 0; i < odims[D1]; i++) {
-            scan_dim_by_key<op, Ti, Tk, To, D1> func(inclusive_scan);
-            func(out, outOffset + i * ostrides[D1], key,
-                 keyOffset + i * kstrides[D1], in, inOffset + i * istrides[D1],
-                 dim);
-            if (D1 == dim) break;
+        Transform<Ti, To, op> transform;
+        Binary<To, op> binop;
+
+        To out_val  = Binary<To, op>::init();
+        Tk key_val  = key[begin * kstride];
+        bool headless = true;
+
+        if (!inclusive_scan && begin == 0) {
+            out[0] = Binary<To, op>::init();
+        }
+
+        for (dim_t i = begin; i < end; i++) {
+            To in_val  = transform(in[i * istride]);
+            Tk cur_key = key[i * kstride];
+            if (cur_key != key_val) {
+                out_val  = in_val;
+                key_val  = cur_key;
+                headless = false;
+            } else {
+                out_val = binop(in_val, out_val);
+            }
+
+            if (inclusive_scan) {
+                out[i * ostride] = out_val;
+            } else if (i + 1 < len) {
+                bool same = key[(i + 1) * kstride] == cur_key;
+                out[(i + 1) * ostride] = same ? out_val : Binary<To, op>::init();
+            }
+        }
+
+        last = out_val;
+        return headless;
+    }
+
+    // Combines the carry from the previous blocks into the leading segment of
+    // the block [begin, end)
+    void fixup(dim_t begin, dim_t end, To carry) const
+    {
+        Binary<To, op> binop;
+        Tk key_val = key[begin * kstride];
+
+        if (inclusive_scan) {
+            for (dim_t i = begin; i < end && key[i * kstride] == key_val; i++) {
+                out[i * ostride] = binop(out[i * ostride], carry);
+            }
+        } else {
+            for (dim_t i = begin; i < end && key[i * kstride] == key_val; i++) {
+                if (i + 1 >= len || key[(i + 1) * kstride] != key_val) break;
+                out[(i + 1) * ostride] = binop(out[(i + 1) * ostride], carry);
+            }
         }
     }
 };
 
+// Segmented scan of a single slice split into blocks that are scanned
+// concurrently. Each block produces a (headless, value) pair that is combined
+// serially across the blocks, after which the leading segment of every block
+// is updated with the carry of the blocks before it.
 template<af_op_t op, typename Ti, typename Tk, typename To>
-struct scan_dim_by_key<op, Ti, Tk, To, 0>
+void scanSliceByKeyParallel(const scan_by_key_block<op, Ti, Tk, To> &blk,
+                            unsigned nblocks)
+{
+    const dim_t len = blk.len;
+    std::vector<To> lastVal(nblocks);
+    std::vector<char> headless(nblocks);
+
+    parallelTasks(nblocks, [&](unsigned b) {
+        dim_t begin, end;
+        chunkRange(len, nblocks, b, begin, end);
+        headless[b] = blk.scan(begin, end, lastVal[b]);
+    });
+
+    // carry[b] is the scanned value the leading segment of block b continues
+    std::vector<To> carry(nblocks, Binary<To, op>::init());
+    std::vector<char> hasCarry(nblocks, false);
+    Binary<To, op> binop;
+    for (unsigned b = 1; b < nblocks; b++) {
+        dim_t begin, end;
+        chunkRange(len, nblocks, b, begin, end);
+        if (blk.key[begin * blk.kstride] != blk.key[(begin - 1) * blk.kstride]) {
+            continue;
+        }
+        hasCarry[b] = true;
+        if (headless[b - 1] && hasCarry[b - 1]) {
+            carry[b] = binop(lastVal[b - 1], carry[b - 1]);
+        } else {
+            carry[b] = lastVal[b - 1];
+        }
+    }
+
+    parallelTasks(nblocks, [&](unsigned b) {
+        if (!hasCarry[b]) return;
+        dim_t begin, end;
+        chunkRange(len, nblocks, b, begin, end);
+        blk.fixup(begin, end, carry[b]);
+    });
+}
+
+template<af_op_t op, typename Ti, typename Tk, typename To>
+struct scan_by_key
 {
     bool inclusive_scan;
-    scan_dim_by_key(bool inclusiveSanKey) : inclusive_scan(inclusiveSanKey) {}
+    scan_by_key(bool inclusiveScanKey) : inclusive_scan(inclusiveScanKey) {}
 
-    void operator()(Param<To> output, dim_t outOffset,
-                    CParam<Tk> keyinput, dim_t keyOffset,
-                    CParam<Ti> input, dim_t inOffset,
+    void operator()(Param<To> output, CParam<Tk> keyinput, CParam<Ti> input,
                     const int dim) const
     {
-        const Ti* in  = input.get()    + inOffset;
-        const Tk* key = keyinput.get() + keyOffset;
-              To* out = output.get()   + outOffset;
-
+        const dim4 idims    = input.dims();
         const dim4 ostrides = output.strides();
         const dim4 kstrides = keyinput.strides();
         const dim4 istrides = input.strides();
-        const dim4 idims    = input.dims();
 
-        dim_t istride = istrides[dim];
-        dim_t kstride = kstrides[dim];
-        dim_t ostride = ostrides[dim];
+        // The remaining three dimensions enumerate the independent slices
+        int odim[3];
+        for (int i = 0, j = 0; i < 4; i++) {
+            if (i != dim) odim[j++] = i;
+        }
 
-        Transform<Ti, To, op> transform;
-        // FIXME: Change the name to something better
-        Binary<To, op> scan;
+        const dim_t len     = idims[dim];
+        if (len == 0) return;
+        const dim_t nslices = idims.elements() / len;
 
-        To out_val = Binary<To, op>::init();
-        Tk key_val = key[0];
+        auto makeBlock = [&](dim_t s) {
+            dim_t s0 = s % idims[odim[0]];
+            dim_t s1 = (s / idims[odim[0]]) % idims[odim[1]];
+            dim_t s2 = s / (idims[odim[0]] * idims[odim[1]]);
 
-        dim_t k = !inclusive_scan;
-        if (!inclusive_scan) {
-            out[0] = Binary<To, op>::init();
-        }
+            scan_by_key_block<op, Ti, Tk, To> blk;
+            blk.in  = input.get() + s0 * istrides[odim[0]] +
+                      s1 * istrides[odim[1]] + s2 * istrides[odim[2]];
+            blk.key = keyinput.get() + s0 * kstrides[odim[0]] +
+                      s1 * kstrides[odim[1]] + s2 * kstrides[odim[2]];
+            blk.out = output.get() + s0 * ostrides[odim[0]] +
+                      s1 * ostrides[odim[1]] + s2 * ostrides[odim[2]];
+            blk.istride = istrides[dim];
+            blk.kstride = kstrides[dim];
+            blk.ostride = ostrides[dim];
+            blk.len     = len;
+            blk.inclusive_scan = inclusive_scan;
+            return blk;
+        };
 
-        for (dim_t i = 0; i < idims[dim] - (!inclusive_scan); i++, k++) {
-            To in_val = transform(in[i * istride]);
-            if (key[k * kstride] != key_val) {
-                out_val = !inclusive_scan? Binary<To, op>::init() : in_val;
-                key_val = key[k * kstride];
-            } else {
-                out_val = scan(in_val, out_val);
+        // Prefer parallelism across slices when there are enough of them;
+        // a few long slices are split into blocks instead
+        const unsigned nblocks = getNumChunks(len, SCAN_BY_KEY_BLOCK_SIZE);
+        if (nblocks <= 1 || nslices >= (dim_t)getNumThreads()) {
+            parallelFor(nslices, std::max(SCAN_BY_KEY_BLOCK_SIZE / len, dim_t(1)),
+                        [&](dim_t begin, dim_t end) {
+                To last;
+                for (dim_t s = begin; s < end; s++) {
+                    makeBlock(s).scan(0, len, last);
+                }
+            });
+        } else {
+            for (dim_t s = 0; s < nslices; s++) {
+                scanSliceByKeyParallel(makeBlock(s), nblocks);
             }
-            out[k * ostride] = out_val;
         }
     }
 };
@@ -0,0 +1,216 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <parallel.hpp>
+#include <kernel/radix_sort.hpp>
+#include <af/defines.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Minimum number of elements partitioned or probed by a single thread
+static const dim_t SET_HASH_GRAIN = 1 << 16;
+
+// Hash of a value. Values that compare equal, such as -0 and +0, have the
+// same hash.
+template<typename T>
+static inline uint64_t hashValue(T val)
+{
+    uint64_t x = radix_key<T>::get(val);
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Open addressing hash table of distinct values using linear probing
+template<typename T>
+class hash_table
+{
+    std::vector<T> slots;
+    std::vector<char> used;
+    uint64_t mask;
+    dim_t count;
+
+public:
+    hash_table() : mask(0), count(0) {}
+
+    // Prepares the table for up to n insertions
+    void reserve(dim_t n)
+    {
+        uint64_t capacity = 16;
+        while (capacity < 2 * (uint64_t)n) capacity *= 2;
+        slots.assign(capacity, T(0));
+        used.assign(capacity, 0);
+        mask  = capacity - 1;
+        count = 0;
+    }
+
+    // Returns true when val was not in the table before
+    bool insert(T val, uint64_t hash)
+    {
+        for (uint64_t i = hash & mask; ; i = (i + 1) & mask) {
+            if (!used[i]) {
+                used[i]  = 1;
+                slots[i] = val;
+                count++;
+                return true;
+            }
+            if (slots[i] == val) return false;
+        }
+    }
+
+    bool contains(T val, uint64_t hash) const
+    {
+        if (used.empty()) return false;
+        for (uint64_t i = hash & mask; used[i]; i = (i + 1) & mask) {
+            if (slots[i] == val) return true;
+        }
+        return false;
+    }
+
+    dim_t size() const { return count; }
+
+    // Copies the values in the table to out
+    void values(T *out) const
+    {
+        for (size_t i = 0; i < used.size(); i++) {
+            if (used[i]) *out++ = slots[i];
+        }
+    }
+};
+
+// Set of distinct values split into independent hash tables by the high bits
+// of the hash. The values are first scattered to their partitions by
+// contiguous chunks of the input, after which every partition builds its own
+// table concurrently. Lookups only read the tables and can run in parallel.
+template<typename T>
+class hash_set
+{
+    std::vector<hash_table<T>> parts;
+
+    unsigned partition(uint64_t hash) const
+    {
+        return (unsigned)((hash >> 32) % parts.size());
+    }
+
+public:
+    // Builds the set from all the elements of the given arrays
+    void build(const std::vector<const T *> &ptrs, const std::vector<dim_t> &sizes)
+    {
+        std::vector<dim_t> start(1, 0);
+        for (dim_t size : sizes) start.push_back(start.back() + size);
+        const dim_t total = start.back();
+
+        auto element = [&](dim_t i) {
+            size_t a = std::upper_bound(start.begin(), start.end(), i) - start.begin() - 1;
+            return ptrs[a][i - start[a]];
+        };
+
+        const unsigned nparts = std::max(getNumChunks(total, SET_HASH_GRAIN), 1u);
+        parts.assign(nparts, hash_table<T>());
+
+        if (nparts == 1) {
+            parts[0].reserve(total);
+            for (size_t a = 0; a < ptrs.size(); a++) {
+                for (dim_t i = 0; i < sizes[a]; i++) {
+                    parts[0].insert(ptrs[a][i], hashValue(ptrs[a][i]));
+                }
+            }
+            return;
+        }
+
+        // offsets[c * nparts + p] is where chunk c writes to partition p
+        const unsigned nchunks = nparts;
+        std::vector<dim_t> offsets(nchunks * nparts, 0);
+        parallelTasks(nchunks, [&](unsigned c) {
+            dim_t begin, end;
+            chunkRange(total, nchunks, c, begin, end);
+            for (dim_t i = begin; i < end; i++) {
+                offsets[c * nparts + partition(hashValue(element(i)))]++;
+            }
+        });
+
+        std::vector<dim_t> partStart(nparts + 1, 0);
+        dim_t pos = 0;
+        for (unsigned p = 0; p < nparts; p++) {
+            partStart[p] = pos;
+            for (unsigned c = 0; c < nchunks; c++) {
+                dim_t count = offsets[c * nparts + p];
+                offsets[c * nparts + p] = pos;
+                pos += count;
+            }
+        }
+        partStart[nparts] = pos;
+
+        std::vector<T> scattered(total);
+        parallelTasks(nchunks, [&](unsigned c) {
+            dim_t begin, end;
+            chunkRange(total, nchunks, c, begin, end);
+            dim_t *offset = offsets.data() + c * nparts;
+            for (dim_t i = begin; i < end; i++) {
+                T val = element(i);
+                scattered[offset[partition(hashValue(val))]++] = val;
+            }
+        });
+
+        parallelTasks(nparts, [&](unsigned p) {
+            parts[p].reserve(partStart[p + 1] - partStart[p]);
+            for (dim_t i = partStart[p]; i < partStart[p + 1]; i++) {
+                parts[p].insert(scattered[i], hashValue(scattered[i]));
+            }
+        });
+    }
+
+    bool contains(T val) const
+    {
+        if (parts.empty()) return false;
+        uint64_t hash = hashValue(val);
+        return parts[partition(hash)].contains(val, hash);
+    }
+
+    dim_t size() const
+    {
+        dim_t count = 0;
+        for (const hash_table<T> &part : parts) count += part.size();
+        return count;
+    }
+
+    // Copies all the distinct values to out, in an unspecified order
+    void values(T *out) const
+    {
+        std::vector<dim_t> start(parts.size(), 0);
+        for (size_t p = 1; p < parts.size(); p++) {
+            start[p] = start[p - 1] + parts[p - 1].size();
+        }
+        parallelTasks(parts.size(), [&](unsigned p) {
+            parts[p].values(out + start[p]);
+        });
+    }
+};
+
+// Writes to out[i] whether in[i] is an element of set
+template<typename T>
+void isIn(char *out, const T *in, const dim_t n, const hash_set<T> &set)
+{
+    parallelFor(n, SET_HASH_GRAIN, [&](dim_t begin, dim_t end) {
+        for (dim_t i = begin; i < end; i++) {
+            out[i] = set.contains(in[i]);
+        }
+    });
+}
+
+}
+}
@@ -0,0 +1,88 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <parallel.hpp>
+#include <common/sketch.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Minimum number of elements inserted by a single thread
+static const dim_t SKETCH_GRAIN = 1 << 16;
+
+// Calls func on the elements [begin, end) of the input in column major order
+template<typename T, typename F>
+void sketchRange(CParam<T> input, const dim_t begin, const dim_t end, F func)
+{
+    const af::dim4 dims    = input.dims();
+    const af::dim4 strides = input.strides();
+    const T *in = input.get();
+
+    for (dim_t i = begin; i < end;) {
+        const dim_t i0 = i % dims[0];
+        const dim_t i1 = (i / dims[0]) % dims[1];
+        const dim_t i2 = (i / (dims[0] * dims[1])) % dims[2];
+        const dim_t i3 = i / (dims[0] * dims[1] * dims[2]);
+        const T *col   = in + i1 * strides[1] + i2 * strides[2] + i3 * strides[3];
+        const dim_t len = std::min(dims[0] - i0, end - i);
+        for (dim_t j = i0; j < i0 + len; j++) func(col[j * strides[0]]);
+        i += len;
+    }
+}
+
+// Every thread fills its own sketch from a contiguous chunk of the input and
+// the partial sketches are merged into sketch afterwards
+template<typename T, typename Sketch, typename Create>
+void sketchUpdate(Sketch &sketch, CParam<T> input, Create create)
+{
+    const dim_t n = input.dims().elements();
+    const unsigned nchunks = getNumChunks(n, SKETCH_GRAIN);
+    if (nchunks <= 1) {
+        sketchRange(input, 0, n, [&](T val) { sketch.insert(val); });
+        return;
+    }
+
+    std::vector<Sketch> partial;
+    partial.reserve(nchunks);
+    for (unsigned chunk = 0; chunk < nchunks; chunk++) partial.push_back(create());
+
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end;
+        chunkRange(n, nchunks, chunk, begin, end);
+        Sketch &local = partial[chunk];
+        sketchRange(input, begin, end, [&](T val) { local.insert(val); });
+    });
+
+    for (unsigned chunk = 0; chunk < nchunks; chunk++) sketch.merge(partial[chunk]);
+}
+
+template<typename T>
+void sketchUpdate(common::quantile_sketch &sketch, CParam<T> input)
+{
+    sketchUpdate(sketch, input, [&]() {
+        return common::quantile_sketch(sketch.accuracy(), sketch.split());
+    });
+}
+
+template<typename T>
+void sketchUpdate(common::distinct_sketch &sketch, CParam<T> input)
+{
+    sketchUpdate(sketch, input, [&]() {
+        return common::distinct_sketch(sketch.precision());
+    });
+}
+
+}
+}
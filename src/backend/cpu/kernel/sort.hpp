@@ -10,41 +10,70 @@
 #pragma once
 #include <Param.hpp>
 #include <math.hpp>
+#include <kernel/merge_sort.hpp>
+#include <kernel/radix_sort.hpp>
 #include <algorithm>
 #include <numeric>
 #include <err_cpu.hpp>
 #include <functional>
+#include <vector>
 
 namespace cpu
 {
 namespace kernel
 {
 
-// Based off of http://stackoverflow.com/a/12399290
+// Sorts a single contiguous column of n elements
+template<typename T>
+void sortColumn(T *col, const dim_t n, bool isAscending,
+                std::vector<T> &keyTmp, std::vector<uint> &idxTmp)
+{
+    if (isAscending) {
+        if (is_radix_sortable<T>::value && n >= RADIX_SORT_THRESHOLD) {
+            radixSort<T>(col, nullptr, n, keyTmp, idxTmp);
+        } else if (n >= MERGE_SORT_THRESHOLD) {
+            parallelMergeSort(col, n, std::less<T>(), keyTmp, false);
+        } else {
+            std::sort(col, col + n, std::less<T>());
+        }
+    } else {
+        if (n >= MERGE_SORT_THRESHOLD) {
+            parallelMergeSort(col, n, std::greater<T>(), keyTmp, false);
+        } else {
+            std::sort(col, col + n, std::greater<T>());
+        }
+    }
+}
+
 template<typename T>
 void sort0Iterative(Param<T> val, bool isAscending)
 {
-    // initialize original index locations
     T *val_ptr = val.get();
 
-    function<bool(T, T)> op = std::greater<T>();
-    if(isAscending) { op = std::less<T>(); }
-
-    T *comp_ptr = nullptr;
-    for(dim_t w = 0; w < val.dims(3); w++) {
-        dim_t valW = w * val.strides(3);
-        for(dim_t z = 0; z < val.dims(2); z++) {
-            dim_t valWZ = valW + z * val.strides(2);
-            for(dim_t y = 0; y < val.dims(1); y++) {
+    const af::dim4 dims    = val.dims();
+    const af::dim4 strides = val.strides();
+    const dim_t ncols      = dims[1] * dims[2] * dims[3];
 
-                dim_t valOffset = valWZ + y * val.strides(1);
-
-                comp_ptr = val_ptr + valOffset;
-                std::sort(comp_ptr, comp_ptr + val.dims(0), op);
-            }
+    auto sortColumns = [&](dim_t begin, dim_t end) {
+        std::vector<T> keyTmp;
+        std::vector<uint> idxTmp;
+        for (dim_t c = begin; c < end; c++) {
+            dim_t y = c % dims[1];
+            dim_t z = (c / dims[1]) % dims[2];
+            dim_t w = c / (dims[1] * dims[2]);
+            T *col = val_ptr + w * strides[3] + z * strides[2] + y * strides[1];
+            sortColumn<T>(col, dims[0], isAscending, keyTmp, idxTmp);
         }
+    };
+
+    // Columns are sorted concurrently when there are enough of them. A few
+    // long columns are sorted one after the other using all the threads.
+    if (ncols < (dim_t)getNumThreads() && dims[0] >= MERGE_SORT_THRESHOLD) {
+        sortColumns(0, ncols);
+    } else {
+        parallelFor(ncols, std::max(RADIX_SORT_GRAIN / std::max(dims[0], dim_t(1)), dim_t(1)),
+                    sortColumns);
     }
-    return;
 }
 
 }
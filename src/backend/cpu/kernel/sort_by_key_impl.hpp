@@ -10,6 +10,8 @@
 #pragma once
 #include <kernel/sort_by_key.hpp>
 #include <kernel/sort_helper.hpp>
+#include <kernel/merge_sort.hpp>
+#include <kernel/radix_sort.hpp>
 #include <Param.hpp>
 #include <math.hpp>
 #include <algorithm>
@@ -19,59 +21,149 @@
 #include <functional>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace cpu
 {
 namespace kernel
 {
 
+// Largest scratch, in bytes, a thread keeps between two calls of sort_by_key
+static const size_t SORT_BY_KEY_SCRATCH_BYTES = 1 << 24;
+
+// Scratch buffers reused for all the columns sorted by one thread
 template<typename Tk, typename Tv>
-void sort0ByKeyIterative(Param<Tk> okey, Param<Tv> oval, bool isAscending)
+struct sort_by_key_scratch
 {
-    // Get pointers and initialize original index locations
-    Tk *okey_ptr = okey.get();
-    Tv *oval_ptr = oval.get();
+    std::vector<IndexPair<Tk, uint>> pairs;
+    std::vector<IndexPair<Tk, uint>> pairTmp;
+    std::vector<Tk> keyTmp;
+    std::vector<uint> perm;
+    std::vector<uint> idxTmp;
+    std::vector<Tv> valTmp;
 
-    typedef IndexPair<Tk, Tv> CurrentPair;
+    size_t bytes() const
+    {
+        return (pairs.capacity() + pairTmp.capacity()) * sizeof(IndexPair<Tk, uint>) +
+               keyTmp.capacity() * sizeof(Tk) +
+               (perm.capacity() + idxTmp.capacity()) * sizeof(uint) +
+               valTmp.capacity() * sizeof(Tv);
+    }
 
-    dim_t size = okey.dims(0);
-    std::vector<CurrentPair> pairKeyVal(size);
+    // Frees the buffers if they are larger than SORT_BY_KEY_SCRATCH_BYTES
+    void trim()
+    {
+        if (bytes() > SORT_BY_KEY_SCRATCH_BYTES) *this = sort_by_key_scratch();
+    }
+};
 
-    for(dim_t w = 0; w < okey.dims(3); w++) {
-        dim_t okeyW = w * okey.strides(3);
-        dim_t ovalW = w * oval.strides(3);
+// Returns the scratch buffers of the calling thread. They keep their memory
+// between calls, up to SORT_BY_KEY_SCRATCH_BYTES, so that repeated sorts do
+// not allocate.
+template<typename Tk, typename Tv>
+sort_by_key_scratch<Tk, Tv> &getSortByKeyScratch()
+{
+    static thread_local sort_by_key_scratch<Tk, Tv> scratch;
+    return scratch;
+}
 
-        for(dim_t z = 0; z < okey.dims(2); z++) {
-            dim_t okeyWZ = okeyW + z * okey.strides(2);
-            dim_t ovalWZ = ovalW + z * oval.strides(2);
+// Sorts a contiguous column of keys in place and returns in scratch.perm
+// the original position of every sorted key
+template<typename Tk, typename Tv>
+void sortKeyPermutation(Tk *keys, const dim_t size, bool isAscending,
+                        sort_by_key_scratch<Tk, Tv> &scratch)
+{
+    scratch.perm.resize(size);
 
-            for(dim_t y = 0; y < okey.dims(1); y++) {
+    // Long columns with ascending keys are radix sorted along with the index
+    // of every key
+    if (isAscending && is_radix_sortable<Tk>::value && size >= RADIX_SORT_THRESHOLD) {
+        std::iota(scratch.perm.begin(), scratch.perm.end(), 0u);
+        radixSort<Tk>(keys, scratch.perm.data(), size, scratch.keyTmp, scratch.idxTmp);
+        return;
+    }
 
-                dim_t okeyOffset = okeyWZ + y * okey.strides(1);
-                dim_t ovalOffset = ovalWZ + y * oval.strides(1);
+    // Other columns stable sort compact (key, index) pairs
+    std::vector<IndexPair<Tk, uint>> &pairs = scratch.pairs;
+    pairs.resize(size);
+    for (dim_t x = 0; x < size; x++) {
+        pairs[x] = std::make_tuple(keys[x], (uint)x);
+    }
 
-                Tk *okey_col_ptr = okey_ptr + okeyOffset;
-                Tv *oval_col_ptr = oval_ptr + ovalOffset;
+    if (size >= MERGE_SORT_THRESHOLD) {
+        if (isAscending) {
+            parallelMergeSort(pairs.data(), size, IPCompare<Tk, uint, true>(),
+                              scratch.pairTmp, true);
+        } else {
+            parallelMergeSort(pairs.data(), size, IPCompare<Tk, uint, false>(),
+                              scratch.pairTmp, true);
+        }
+    } else {
+        // std::stable_sort would allocate its own buffer
+        scratch.pairTmp.resize(size);
+        if (isAscending) {
+            stableSortRun(pairs.data(), scratch.pairTmp.data(), size,
+                          IPCompare<Tk, uint, true>());
+        } else {
+            stableSortRun(pairs.data(), scratch.pairTmp.data(), size,
+                          IPCompare<Tk, uint, false>());
+        }
+    }
 
-                for(dim_t x = 0; x < size; x++) {
-                   pairKeyVal[x] = std::make_tuple(okey_col_ptr[x], oval_col_ptr[x]);
-                }
+    for (dim_t x = 0; x < size; x++) {
+        keys[x]         = std::get<0>(pairs[x]);
+        scratch.perm[x] = std::get<1>(pairs[x]);
+    }
+}
 
-                if(isAscending) {
-                    std::stable_sort(pairKeyVal.begin(), pairKeyVal.end(), IPCompare<Tk, Tv, true>());
-                } else {
-                    std::stable_sort(pairKeyVal.begin(), pairKeyVal.end(), IPCompare<Tk, Tv, false>());
-                }
+// Sorts every column of okey along with oval. The keys are sorted together
+// with their index only, after which the values are moved with a single
+// gather. Columns are sorted concurrently when there are several of them.
+template<typename Tk, typename Tv>
+void sort0ByKeyIterative(Param<Tk> okey, Param<Tv> oval, bool isAscending)
+{
+    Tk *okey_ptr = okey.get();
+    Tv *oval_ptr = oval.get();
 
-                for(unsigned x = 0; x < size; x++) {
-                    okey_ptr[okeyOffset + x] = std::get<0>(pairKeyVal[x]);
-                    oval_ptr[ovalOffset + x] = std::get<1>(pairKeyVal[x]);
+    const af::dim4 dims = okey.dims();
+    const dim_t size    = dims[0];
+    const dim_t ncols   = dims[1] * dims[2] * dims[3];
+
+    auto sortColumns = [&](dim_t begin, dim_t end) {
+        sort_by_key_scratch<Tk, Tv> &scratch = getSortByKeyScratch<Tk, Tv>();
+        scratch.valTmp.resize(size);
+
+        for (dim_t c = begin; c < end; c++) {
+            dim_t y = c % dims[1];
+            dim_t z = (c / dims[1]) % dims[2];
+            dim_t w = c / (dims[1] * dims[2]);
+
+            Tk *okey_col_ptr = okey_ptr + w * okey.strides(3) + z * okey.strides(2) +
+                               y * okey.strides(1);
+            Tv *oval_col_ptr = oval_ptr + w * oval.strides(3) + z * oval.strides(2) +
+                               y * oval.strides(1);
+
+            sortKeyPermutation<Tk, Tv>(okey_col_ptr, size, isAscending, scratch);
+
+            const uint *perm = scratch.perm.data();
+            Tv *valTmp = scratch.valTmp.data();
+            parallelFor(size, RADIX_SORT_GRAIN, [&](dim_t xbegin, dim_t xend) {
+                for (dim_t x = xbegin; x < xend; x++) {
+                    valTmp[x] = oval_col_ptr[perm[x]];
                 }
-            }
+            });
+            std::copy(valTmp, valTmp + size, oval_col_ptr);
         }
-    }
+        scratch.trim();
+    };
 
-    return;
+    // A few long columns are sorted one after the other using all the threads
+    if (ncols < (dim_t)getNumThreads() && size >= MERGE_SORT_THRESHOLD) {
+        sortColumns(0, ncols);
+    } else {
+        parallelFor(ncols, std::max(RADIX_SORT_GRAIN / std::max(size, dim_t(1)), dim_t(1)),
+                    sortColumns);
+    }
 }
 
 template<typename Tk, typename Tv>
@@ -143,12 +235,7 @@ void sortByKeyBatched(Param<Tk> okey, Param<Tv> oval, const int dim, bool isAsce
 template<typename Tk, typename Tv>
 void sort0ByKey(Param<Tk> okey, Param<Tv> oval, bool isAscending)
 {
-    int higherDims =  okey.dims(1) * okey.dims(2) * okey.dims(3);
-    // TODO Make a better heurisitic
-    if(higherDims > 4)
-        kernel::sortByKeyBatched<Tk, Tv>(okey, oval, 0, isAscending);
-    else
-        kernel::sort0ByKeyIterative<Tk, Tv>(okey, oval, isAscending);
+    kernel::sort0ByKeyIterative<Tk, Tv>(okey, oval, isAscending);
 }
 
 #define INSTANTIATE(Tk, Tv)                                                             \
@@ -11,15 +11,262 @@
 #include <Param.hpp>
 #include <utility.hpp>
 #include <math.hpp>
-#include <kernel/sort_helper.hpp>
+#include <parallel.hpp>
 #include <algorithm>
-#include <tuple>
+#include <vector>
 
 namespace cpu
 {
 namespace kernel
 {
 
+// Smallest number of elements or nonzeros a thread is handed
+static const dim_t SPARSE_GRAIN = 1 << 16;
+
+// Turns the counts in offsets[1, count] into offsets, with offsets[0] = 0
+static inline
+void scanOffsets(int *offsets, const dim_t count)
+{
+    offsets[0] = 0;
+    const unsigned nchunks = getNumChunks(std::max(count, (dim_t)1), SPARSE_GRAIN);
+
+    // Every chunk sums its counts, and then adds them up on top of the sum
+    // of the chunks before it
+    std::vector<int> sums(nchunks + 1, 0);
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end;
+        chunkRange(count, nchunks, chunk, begin, end);
+        int sum = 0;
+        for (dim_t i = begin; i < end; i++) sum += offsets[i + 1];
+        sums[chunk + 1] = sum;
+    });
+    for (unsigned c = 0; c < nchunks; c++) sums[c + 1] += sums[c];
+
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end;
+        chunkRange(count, nchunks, chunk, begin, end);
+        int sum = sums[chunk];
+        for (dim_t i = begin; i < end; i++) {
+            sum += offsets[i + 1];
+            offsets[i + 1] = sum;
+        }
+    });
+}
+
+// Writes i to idx[offsets[i], offsets[i + 1]) for every i in [0, count)
+static inline
+void expandOffsets(int *idx, const int *offsets, const dim_t count)
+{
+    parallelForWeighted(offsets, count, SPARSE_GRAIN, [&](dim_t begin, dim_t end) {
+        for (dim_t i = begin; i < end; i++) {
+            std::fill(idx + offsets[i], idx + offsets[i + 1], (int)i);
+        }
+    });
+}
+
+// Chunks of the nonzeros of a CSR matrix made of whole rows, so that the row
+// of every nonzero is known without expanding the offsets
+struct CompressedChunks
+{
+    const int *offsets;
+    dim_t count;
+    unsigned nchunks;
+
+    template<typename F>
+    void operator()(const unsigned chunk, F func) const
+    {
+        dim_t begin, end;
+        weightedChunkRange(offsets, count, nchunks, chunk, begin, end);
+        for (dim_t i = begin; i < end; i++) {
+            for (int j = offsets[i]; j < offsets[i + 1]; j++) func(j, (int)i);
+        }
+    }
+};
+
+// Chunks of the nonzeros of a COO matrix, other holding the index that is
+// not sorted on
+struct CoordinateChunks
+{
+    const int *other;
+    dim_t nnz;
+    unsigned nchunks;
+
+    template<typename F>
+    void operator()(const unsigned chunk, F func) const
+    {
+        dim_t begin, end;
+        chunkRange(nnz, nchunks, chunk, begin, end);
+        for (dim_t j = begin; j < end; j++) func(j, other[j]);
+    }
+};
+
+// Number of chunks the nonzeros are split into by bucketByKey. Every chunk
+// keeps a counter per key, so there are no more chunks than nonzeros per key.
+static inline
+unsigned bucketChunks(const dim_t nnz, const dim_t nkeys)
+{
+    const dim_t maxChunks = std::max(nnz / std::max(nkeys, (dim_t)1), (dim_t)1);
+    const dim_t nchunks   = getNumChunks(std::max(nnz, (dim_t)1), SPARSE_GRAIN);
+    return (unsigned)std::min(nchunks, maxChunks);
+}
+
+// Stable counting sort of the nonzeros by keys[j], in [0, nkeys). The value
+// and the index other of every nonzero, as visited by chunks, are scattered
+// to oVal and oIdx, and the offsets of the keys are written to oOffsets.
+// This is a transpose when the keys are the columns of a CSR matrix.
+template<typename T, typename Chunks>
+void bucketByKey(T *oVal, int *oIdx, int *oOffsets, const dim_t nkeys,
+                 const T *iVal, const int *keys, const Chunks &chunks)
+{
+    const unsigned nchunks = chunks.nchunks;
+    const dim_t grain = SPARSE_GRAIN / nchunks;
+
+    // Number of nonzeros of every key in every chunk, later the position the
+    // next nonzero of the key in the chunk goes to
+    std::vector<int> next((size_t)nchunks * nkeys, 0);
+
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        int *count = next.data() + (size_t)chunk * nkeys;
+        chunks(chunk, [&](const int j, const int) { count[keys[j]]++; });
+    });
+
+    parallelFor(nkeys, grain, [&](dim_t begin, dim_t end) {
+        for (dim_t k = begin; k < end; k++) {
+            int total = 0;
+            for (unsigned c = 0; c < nchunks; c++) total += next[c * nkeys + k];
+            oOffsets[k + 1] = total;
+        }
+    });
+    scanOffsets(oOffsets, nkeys);
+
+    parallelFor(nkeys, grain, [&](dim_t begin, dim_t end) {
+        for (dim_t k = begin; k < end; k++) {
+            int pos = oOffsets[k];
+            for (unsigned c = 0; c < nchunks; c++) {
+                const int count = next[c * nkeys + k];
+                next[c * nkeys + k] = pos;
+                pos += count;
+            }
+        }
+    });
+
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        int *pos = next.data() + (size_t)chunk * nkeys;
+        chunks(chunk, [&](const int j, const int other) {
+            const int dst = pos[keys[j]]++;
+            oVal[dst] = iVal[j];
+            oIdx[dst] = other;
+        });
+    });
+}
+
+// Threads are handed blocks of rows, and go through all the columns of their
+// block, so that the dense matrix is read contiguously
+static inline
+dim_t denseRowGrain(const dim_t ncols)
+{
+    return SPARSE_GRAIN / std::max(ncols, (dim_t)1) + 1;
+}
+
+// Counts the nonzeros of the rows of in and writes their offsets to rowIdx
+template<typename T>
+void denseRowOffsets(Param<int> rowIdx, CParam<T> in)
+{
+    const T *iPtr = in.get();
+    int     *rPtr = rowIdx.get();
+    const dim_t M = in.dims(0);
+    const dim_t N = in.dims(1);
+    const dim_t stride = in.strides(1);
+
+    parallelFor(M, denseRowGrain(N), [&](dim_t begin, dim_t end) {
+        int *count = rPtr + 1;
+        std::fill(count + begin, count + end, 0);
+        for (dim_t j = 0; j < N; j++) {
+            const T *col = iPtr + j * stride;
+            for (dim_t i = begin; i < end; i++) count[i] += col[i] != scalar<T>(0);
+        }
+    });
+    scanOffsets(rPtr, M);
+}
+
+// Counts the nonzeros of the columns of in and writes their offsets to colIdx
+template<typename T>
+void denseColOffsets(Param<int> colIdx, CParam<T> in)
+{
+    const T *iPtr = in.get();
+    int     *cPtr = colIdx.get();
+    const dim_t M = in.dims(0);
+    const dim_t N = in.dims(1);
+    const dim_t stride = in.strides(1);
+
+    parallelFor(N, SPARSE_GRAIN / std::max(M, (dim_t)1) + 1, [&](dim_t begin, dim_t end) {
+        for (dim_t j = begin; j < end; j++) {
+            const T *col = iPtr + j * stride;
+            int count = 0;
+            for (dim_t i = 0; i < M; i++) count += col[i] != scalar<T>(0);
+            cPtr[j + 1] = count;
+        }
+    });
+    scanOffsets(cPtr, N);
+}
+
+template<typename T>
+void dense2csr(Param<T> values, Param<int> colIdx, CParam<int> rowIdx,
+               CParam<T> in)
+{
+    const T   *iPtr = in.get();
+    T         *vPtr = values.get();
+    const int *rPtr = rowIdx.get();
+    int       *cPtr = colIdx.get();
+    const dim_t M = in.dims(0);
+    const dim_t N = in.dims(1);
+    const dim_t stride = in.strides(1);
+
+    parallelFor(M, denseRowGrain(N), [&](dim_t begin, dim_t end) {
+        std::vector<int> next(rPtr + begin, rPtr + end);
+        for (dim_t j = 0; j < N; j++) {
+            const T *col = iPtr + j * stride;
+            for (dim_t i = begin; i < end; i++) {
+                if (col[i] != scalar<T>(0)) {
+                    const int pos = next[i - begin]++;
+                    vPtr[pos] = col[i];
+                    cPtr[pos] = (int)j;
+                }
+            }
+        }
+    });
+}
+
+// colOffsets holds the offsets of the columns of in, from denseColOffsets.
+// The nonzeros are written in column major order.
+template<typename T>
+void dense2coo(Param<T> values, Param<int> rowIdx, Param<int> colIdx,
+               CParam<int> colOffsets, CParam<T> in)
+{
+    T         *vPtr = values.get();
+    int       *rPtr = rowIdx.get();
+    int       *oPtr = colIdx.get();
+    const int *cPtr = colOffsets.get();
+    const T   *iPtr = in.get();
+    const dim_t M = in.dims(0);
+    const dim_t N = in.dims(1);
+    const dim_t stride = in.strides(1);
+
+    parallelForWeighted(cPtr, N, SPARSE_GRAIN, [&](dim_t begin, dim_t end) {
+        for (dim_t j = begin; j < end; j++) {
+            const T *col = iPtr + j * stride;
+            int pos = cPtr[j];
+            for (dim_t i = 0; i < M; i++) {
+                if (col[i] != scalar<T>(0)) {
+                    vPtr[pos]   = col[i];
+                    rPtr[pos++] = (int)i;
+                }
+            }
+            std::fill(oPtr + cPtr[j], oPtr + cPtr[j + 1], (int)j);
+        }
+    });
+}
+
 template<typename T>
 void coo2dense(Param<T> output,
                CParam<T> values, CParam<int> rowIdx, CParam<int> colIdx)
@@ -32,6 +279,7 @@ void coo2dense(Param<T> output,
 
     af::dim4 ostrides = output.strides();
 
+    // Serial, so that the last of duplicate coordinates wins
     int nNZ = values.dims(0);
     for(int i = 0; i < nNZ; i++) {
         T   v = vPtr[i];
@@ -44,31 +292,6 @@ void coo2dense(Param<T> output,
     }
 }
 
-template<typename T>
-void dense2csr(Param<T> values, Param<int> rowIdx, Param<int> colIdx,
-               CParam<T> in)
-{
-    const T * iPtr = in.get();
-    T       * vPtr = values.get();
-    int     * rPtr = rowIdx.get();
-    int     * cPtr = colIdx.get();
-
-    int stride = in.strides(1);
-    af::dim4 dims = in.dims();
-
-    int offset = 0;
-    for (int i = 0; i < dims[0]; ++i) {
-        rPtr[i] = offset;
-        for (int j = 0; j < dims[1]; ++j) {
-            if (iPtr[j*stride + i] != scalar<T>(0)) {
-                vPtr[offset] = iPtr[j*stride + i];
-                cPtr[offset++] = j;
-            }
-        }
-    }
-    rPtr[dims[0]] = offset;
-}
-
 template<typename T>
 void csr2dense(Param<T> out,
                CParam<T> values, CParam<int> rowIdx, CParam<int> colIdx)
@@ -78,105 +301,42 @@ void csr2dense(Param<T> out,
     const int *rPtr = rowIdx.get();
     const int *cPtr = colIdx.get();
 
-    int stride = out.strides(1);
+    const dim_t stride = out.strides(1);
 
-    int r = rowIdx.dims(0);
-    for (int i = 0; i < r - 1; i++) {
-        for (int ii = rPtr[i]; ii < rPtr[i+1]; ++ii) {
-            int j = cPtr[ii];
-            T v = vPtr[ii];
-            oPtr[j*stride + i] = v;
+    parallelForWeighted(rPtr, rowIdx.dims(0) - 1, SPARSE_GRAIN, [&](dim_t begin, dim_t end) {
+        for (dim_t i = begin; i < end; i++) {
+            for (int ii = rPtr[i]; ii < rPtr[i+1]; ++ii) {
+                oPtr[cPtr[ii] * stride + i] = vPtr[ii];
+            }
         }
-    }
+    });
 }
 
-// Modified code from sort helper
-template <typename T>
-using SpKeyIndexPair = std::tuple<int, T, int>; // sorting index, value, other index
-
-template <typename T>
-struct SpKIPCompareK
-{
-    bool operator()(const SpKeyIndexPair<T> &lhs, const SpKeyIndexPair<T> &rhs)
-    {
-        int lhsVal = std::get<0>(lhs);
-        int rhsVal = std::get<0>(rhs);
-        // Always returns ascending
-        return (lhsVal < rhsVal);
-    }
-};
-
+// The COO matrices are sorted by column, so the nonzeros of a CSR matrix are
+// bucketed by column, and the column offsets expanded
 template<typename T>
 void csr2coo(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
-             CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx)
+             CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx,
+             const int ncols)
 {
-    // First calculate the linear index
-    T         * ovPtr = ovalues.get();
-    int       * orPtr = orowIdx.get();
-    int       * ocPtr = ocolIdx.get();
-
-    const T   *ivPtr = ivalues.get();
-    const int *irPtr = irowIdx.get();
-    const int *icPtr = icolIdx.get();
-
-    // Create cordinate form of the row array
-    for(int i = 0; i < (int)irowIdx.dims().elements() - 1; i++) {
-        std::fill_n(orPtr + irPtr[i], irPtr[i + 1] - irPtr[i], i);
-    }
-
-    // Sort the coordinate form using column index
-    // Uses code from sort_by_key kernels
-    typedef SpKeyIndexPair<T> CurrentPair;
-    int size = ovalues.dims(0);
-    std::vector<CurrentPair> pairKeyVal(size);
-
-    for(int x = 0; x < size; x++) {
-       pairKeyVal[x] = std::make_tuple(icPtr[x], ivPtr[x], orPtr[x]);
-    }
-
-    std::stable_sort(pairKeyVal.begin(), pairKeyVal.end(), SpKIPCompareK<T>());
-
-    for(int x = 0; x < (int)ovalues.dims().elements(); x++) {
-        std::tie(ocPtr[x], ovPtr[x], orPtr[x]) = pairKeyVal[x];
-    }
-
+    const dim_t M = irowIdx.dims(0) - 1;
+    std::vector<int> offsets(ncols + 1);
+    CompressedChunks chunks = {irowIdx.get(), M, bucketChunks(ivalues.dims(0), ncols)};
+    bucketByKey(ovalues.get(), orowIdx.get(), offsets.data(), ncols,
+                ivalues.get(), icolIdx.get(), chunks);
+    expandOffsets(ocolIdx.get(), offsets.data(), ncols);
 }
 
+// Stable, so the nonzeros of a row keep the order they have in the COO matrix
 template<typename T>
 void coo2csr(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
              CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx)
 {
-    T   * ovPtr = ovalues.get();
-    int *orPtr = orowIdx.get();
-    int *ocPtr = ocolIdx.get();
-
-    const T   *ivPtr = ivalues.get();
-    const int *irPtr = irowIdx.get();
-    const int *icPtr = icolIdx.get();
-
-    // Sort the colidx and values based on rowIdx
-    // Uses code from sort_by_key kernels
-    typedef SpKeyIndexPair<T> CurrentPair;
-    int size = ovalues.dims(0);
-    std::vector<CurrentPair>pairKeyVal(size);
-
-    for(int x = 0; x < size; x++) {
-       pairKeyVal[x] = std::make_tuple(irPtr[x], ivPtr[x], icPtr[x]);
-    }
-
-    std::stable_sort(pairKeyVal.begin(), pairKeyVal.end(), SpKIPCompareK<T>());
-
-    ovPtr[0] = 0;
-    for(int x = 0; x < (int)ovalues.dims().elements(); x++) {
-        int row = -2; // Some value that will make orPtr[row + 1] error out
-        std::tie(row, ovPtr[x], ocPtr[x]) = pairKeyVal[x];
-        orPtr[row + 1]++;
-    }
-
-    // Compress row storage
-    for(int x = 1; x < (int)orowIdx.dims().elements(); x++) {
-        orPtr[x] += orPtr[x - 1];
-    }
+    const dim_t nNZ = ivalues.dims(0);
+    const dim_t M = orowIdx.dims(0) - 1;
+    CoordinateChunks chunks = {icolIdx.get(), nNZ, bucketChunks(nNZ, M)};
+    bucketByKey(ovalues.get(), ocolIdx.get(), orowIdx.get(), M,
+                ivalues.get(), irowIdx.get(), chunks);
 }
 
 }
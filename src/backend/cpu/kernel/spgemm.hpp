@@ -0,0 +1,196 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <math.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Rows of the product whose number of partial products exceeds
+// 1 / SPGEMM_DENSE_RATIO of the output columns are accumulated in an array
+// as wide as a row, sparser ones in a hash table sized after the row
+static const dim_t SPGEMM_DENSE_RATIO = 16;
+
+// Smallest number of partial products a thread is handed
+static const dim_t SPGEMM_GRAIN = 1 << 14;
+
+// Accumulates the rows of A * B one at a time (Gustavson). Every thread owns
+// one, so that the dense and hash buffers are reused across its rows.
+template<typename T>
+class SpgemmAccumulator
+{
+    const int ncols;
+    unsigned stamp;
+    std::vector<unsigned> marks;    // Stamp of the last row touching a column
+    std::vector<T> dense;
+    std::vector<int> keys;          // Columns of the hash table, -1 if empty
+    std::vector<T> hashed;
+    std::vector<int> cols;          // Columns of the current row
+
+    static unsigned hashShift(const dim_t size)
+    {
+        unsigned bits = 0;
+        while (((dim_t)1 << bits) < size) bits++;
+        return 32 - bits;
+    }
+
+    int &slot(const int col, const unsigned shift)
+    {
+        const unsigned mask = (unsigned)keys.size() - 1;
+        unsigned h = (shift == 32) ? 0 : ((unsigned)col * 0x9E3779B1u) >> shift;
+        while (keys[h] != -1 && keys[h] != col) h = (h + 1) & mask;
+        return keys[h];
+    }
+
+public:
+    explicit SpgemmAccumulator(const int ncols) : ncols(ncols), stamp(0) {}
+
+    // Gathers the columns of row r of A * B, and their values when numeric is
+    // set, and returns how many there are. flops is the number of partial
+    // products of the row. The columns are written in increasing order.
+    template<bool numeric>
+    int row(const int r, const dim_t flops,
+            const T *aVal, const int *aRow, const int *aCol,
+            const T *bVal, const int *bRow, const int *bCol,
+            T *oVal, int *oCol)
+    {
+        cols.clear();
+        if (flops == 0) return 0;
+
+        const bool isDense = flops * SPGEMM_DENSE_RATIO >= ncols;
+        unsigned shift = 0;
+        if (isDense) {
+            if (marks.empty()) {
+                marks.assign(ncols, 0);
+                if (numeric) dense.resize(ncols);
+            }
+            // The marks of the previous rows become stale, unless the stamp
+            // wraps around
+            if (++stamp == 0) {
+                std::fill(marks.begin(), marks.end(), 0);
+                stamp = 1;
+            }
+        } else {
+            const dim_t size = std::max((dim_t)2, 2 * flops);
+            shift = hashShift(size);
+            keys.assign((dim_t)1 << (32 - shift), -1);
+            if (numeric) hashed.resize(keys.size());
+        }
+
+        for (int j = aRow[r]; j < aRow[r + 1]; j++) {
+            const int k = aCol[j];
+            for (int l = bRow[k]; l < bRow[k + 1]; l++) {
+                const int c = bCol[l];
+                if (isDense) {
+                    if (marks[c] != stamp) {
+                        marks[c] = stamp;
+                        cols.push_back(c);
+                        if (numeric) dense[c] = aVal[j] * bVal[l];
+                    } else if (numeric) {
+                        dense[c] += aVal[j] * bVal[l];
+                    }
+                } else {
+                    int &key = slot(c, shift);
+                    T *val = hashed.data() + (&key - keys.data());
+                    if (key == -1) {
+                        key = c;
+                        cols.push_back(c);
+                        if (numeric) *val = aVal[j] * bVal[l];
+                    } else if (numeric) {
+                        *val += aVal[j] * bVal[l];
+                    }
+                }
+            }
+        }
+
+        if (numeric) {
+            std::sort(cols.begin(), cols.end());
+            for (size_t i = 0; i < cols.size(); i++) {
+                const int c = cols[i];
+                oCol[i] = c;
+                oVal[i] = isDense ? dense[c]
+                                  : hashed[&slot(c, shift) - keys.data()];
+            }
+        }
+        return (int)cols.size();
+    }
+};
+
+// Writes the number of partial products of the rows of A * B, as an
+// exclusive prefix sum, to flops[0, M]
+static inline
+void spgemmFlops(std::vector<dim_t> &flops, const int M,
+                 const int *aRow, const int *aCol, const int *bRow)
+{
+    flops.resize(M + 1);
+    flops[0] = 0;
+    for (int r = 0; r < M; r++) {
+        dim_t count = 0;
+        for (int j = aRow[r]; j < aRow[r + 1]; j++) {
+            count += bRow[aCol[j] + 1] - bRow[aCol[j]];
+        }
+        flops[r + 1] = flops[r] + count;
+    }
+}
+
+// Symbolic phase: the row index array of the product, sized from the number
+// of distinct columns of every row
+template<typename T>
+void spgemmRowIdx(Param<int> oRowIdx, const std::vector<dim_t> &flops,
+                  CParam<int> aRowIdx, CParam<int> aColIdx,
+                  CParam<int> bRowIdx, CParam<int> bColIdx, const int N)
+{
+    const int M = oRowIdx.dims(0) - 1;
+    int *oRow = oRowIdx.get();
+
+    parallelForWeighted(flops.data(), M, SPGEMM_GRAIN, [&](dim_t begin, dim_t end) {
+        SpgemmAccumulator<T> acc(N);
+        for (dim_t r = begin; r < end; r++) {
+            oRow[r + 1] = acc.template row<false>((int)r, flops[r + 1] - flops[r],
+                                                  nullptr, aRowIdx.get(), aColIdx.get(),
+                                                  nullptr, bRowIdx.get(), bColIdx.get(),
+                                                  nullptr, nullptr);
+        }
+    });
+
+    oRow[0] = 0;
+    for (int r = 0; r < M; r++) oRow[r + 1] += oRow[r];
+}
+
+// Numeric phase: the columns and values of the rows of the product
+template<typename T>
+void spgemm(Param<T> oValues, Param<int> oColIdx, CParam<int> oRowIdx,
+            const std::vector<dim_t> &flops,
+            CParam<T> aValues, CParam<int> aRowIdx, CParam<int> aColIdx,
+            CParam<T> bValues, CParam<int> bRowIdx, CParam<int> bColIdx,
+            const int N)
+{
+    const int M = oRowIdx.dims(0) - 1;
+    const int *oRow = oRowIdx.get();
+
+    parallelForWeighted(flops.data(), M, SPGEMM_GRAIN, [&](dim_t begin, dim_t end) {
+        SpgemmAccumulator<T> acc(N);
+        for (dim_t r = begin; r < end; r++) {
+            acc.template row<true>((int)r, flops[r + 1] - flops[r],
+                                   aValues.get(), aRowIdx.get(), aColIdx.get(),
+                                   bValues.get(), bRowIdx.get(), bColIdx.get(),
+                                   oValues.get() + oRow[r], oColIdx.get() + oRow[r]);
+        }
+    });
+}
+
+}
+}
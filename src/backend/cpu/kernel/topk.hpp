@@ -0,0 +1,129 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Minimum number of elements of a single column searched by one thread
+static const dim_t TOPK_CHUNK_SIZE = 1 << 16;
+
+// Orders (value, index) pairs so that the elements returned first by topk
+// compare less. Equal values are ordered by their index.
+template<typename T, bool isMin>
+struct topk_before
+{
+    bool operator()(const std::pair<T, uint> &lhs,
+                    const std::pair<T, uint> &rhs) const
+    {
+        if (lhs.first == rhs.first) return lhs.second < rhs.second;
+        return isMin ? lhs.first < rhs.first : lhs.first > rhs.first;
+    }
+};
+
+// Keeps the best k elements of [begin, end) of a column in a bounded heap
+// whose front is the worst of the retained elements. Elements that can not
+// enter the heap are rejected with a single comparison.
+template<typename T, bool isMin>
+void topkRange(std::vector<std::pair<T, uint>> &heap, const T *ptr,
+               const dim_t begin, const dim_t end, const int k)
+{
+    topk_before<T, isMin> before;
+
+    dim_t i = begin;
+    for (; i < end && (int)heap.size() < k; i++) {
+        heap.push_back(std::make_pair(ptr[i], (uint)i));
+        std::push_heap(heap.begin(), heap.end(), before);
+    }
+
+    for (; i < end; i++) {
+        const T val = ptr[i];
+        const T worst = heap.front().first;
+        if (isMin ? !(val < worst) : !(val > worst)) continue;
+
+        std::pop_heap(heap.begin(), heap.end(), before);
+        heap.back() = std::make_pair(val, (uint)i);
+        std::push_heap(heap.begin(), heap.end(), before);
+    }
+}
+
+template<typename T, bool isMin>
+void topk(Param<T> values, Param<unsigned> indices, CParam<T> in, const int k)
+{
+    typedef std::pair<T, uint> KeyValuePair;
+    topk_before<T, isMin> before;
+
+    const dim_t len    = in.dims(0);
+    const dim_t ncols  = in.dims(1) * in.dims(2) * in.dims(3);
+    const unsigned nchunks = getNumChunks(len, std::max(TOPK_CHUNK_SIZE, (dim_t)k));
+
+    auto writeColumn = [&](std::vector<KeyValuePair> &heap, dim_t col) {
+        std::sort(heap.begin(), heap.end(), before);
+        T *vptr = values.get() + col * values.strides(1);
+        unsigned *iptr = indices.get() + col * indices.strides(1);
+        for (int j = 0; j < k; j++) {
+            vptr[j] = heap[j].first;
+            iptr[j] = heap[j].second;
+        }
+    };
+
+    // The higher dimensions are contiguous columns of length strides(1)
+    auto column = [&](dim_t col) {
+        dim_t w = col / (in.dims(1) * in.dims(2));
+        dim_t z = (col / in.dims(1)) % in.dims(2);
+        dim_t y = col % in.dims(1);
+        return in.get() + w * in.strides(3) + z * in.strides(2) + y * in.strides(1);
+    };
+
+    if (nchunks <= 1 || ncols >= (dim_t)getNumThreads()) {
+        // Enough columns to keep all the threads busy
+        parallelFor(ncols, 1, [&](dim_t cbegin, dim_t cend) {
+            std::vector<KeyValuePair> heap;
+            heap.reserve(k);
+            for (dim_t col = cbegin; col < cend; col++) {
+                heap.clear();
+                topkRange<T, isMin>(heap, column(col), 0, len, k);
+                writeColumn(heap, col);
+            }
+        });
+    } else {
+        // Long columns are split into chunks whose candidates are merged
+        std::vector<std::vector<KeyValuePair>> heaps(nchunks);
+        for (dim_t col = 0; col < ncols; col++) {
+            const T *ptr = column(col);
+            parallelTasks(nchunks, [&](unsigned chunk) {
+                dim_t begin, end;
+                chunkRange(len, nchunks, chunk, begin, end);
+                heaps[chunk].clear();
+                heaps[chunk].reserve(k);
+                topkRange<T, isMin>(heaps[chunk], ptr, begin, end, k);
+            });
+
+            std::vector<KeyValuePair> merged;
+            merged.reserve(nchunks * k);
+            for (auto &heap : heaps) {
+                merged.insert(merged.end(), heap.begin(), heap.end());
+            }
+            std::partial_sort(merged.begin(), merged.begin() + k, merged.end(), before);
+            merged.resize(k);
+            writeColumn(merged, col);
+        }
+    }
+}
+
+}
+}
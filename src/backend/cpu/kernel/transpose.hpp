@@ -11,6 +11,9 @@
 #include <Param.hpp>
 #include <utility.hpp>
 #include <err_cpu.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace cpu
 {
@@ -36,6 +39,30 @@ cdouble getConjugate(const cdouble &in)
     return std::conj(in);
 }
 
+// Side of the square tiles the matrices are transposed by. A tile of the
+// input and one of the output fit in L1 together, so the strided side of the
+// copy touches every cache line once, and the inner loops are short enough for
+// the compiler to unroll them into register transposes.
+static const dim_t TRANSPOSE_TILE = 32;
+
+// Smallest number of elements a thread is handed
+static const dim_t TRANSPOSE_GRAIN = 1 << 16;
+
+// out(i, j) = in(j, i) for the rows x cols tile at out
+template<typename T, bool conjugate>
+static void transposeTile(T *out, const dim_t ost,
+                          const T *in, const dim_t ist0, const dim_t ist1,
+                          const dim_t rows, const dim_t cols)
+{
+    for (dim_t j = 0; j < cols; ++j) {
+        const T *src = in + j * ist0;
+        T *dst = out + j * ost;
+        for (dim_t i = 0; i < rows; ++i) {
+            dst[i] = conjugate ? getConjugate(src[i * ist1]) : src[i * ist1];
+        }
+    }
+}
+
 template<typename T, bool conjugate>
 void transpose(Param<T> output, CParam<T> input)
 {
@@ -46,28 +73,28 @@ void transpose(Param<T> output, CParam<T> input)
     T * out = output.get();
     T const * const in = input.get();
 
-    for (dim_t l = 0; l < odims[3]; ++l) {
-        for (dim_t k = 0; k < odims[2]; ++k) {
-            // Outermost loop handles batch mode
-            // if input has no data along third dimension
-            // this loop runs only once
-            for (dim_t j = 0; j < odims[1]; ++j) {
-                for (dim_t i = 0; i < odims[0]; ++i) {
-                    // calculate array indices based on offsets and strides
-                    // the helper getIdx takes care of indices
-                    const dim_t inIdx  = getIdx(istrides,j,i,k,l);
-                    const dim_t outIdx = getIdx(ostrides,i,j,k,l);
-                    if(conjugate)
-                        out[outIdx] = getConjugate(in[inIdx]);
-                    else
-                        out[outIdx] = in[inIdx];
-                }
+    // Every task writes a strip of TRANSPOSE_TILE output columns of a batch
+    const dim_t strips = (odims[1] + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    const dim_t grain  = std::max<dim_t>(1, TRANSPOSE_GRAIN / (TRANSPOSE_TILE * odims[0]));
+
+    parallelFor(strips * odims[2] * odims[3], grain, [=](dim_t begin, dim_t end) {
+        for (dim_t t = begin; t < end; ++t) {
+            const dim_t batch = t / strips;
+            const dim_t j0    = (t - batch * strips) * TRANSPOSE_TILE;
+            const dim_t cols  = std::min(TRANSPOSE_TILE, odims[1] - j0);
+            const dim_t l     = batch / odims[2];
+            const dim_t k     = batch - l * odims[2];
+
+            T *optr = out + getIdx(ostrides, 0, j0, k, l);
+            T const *iptr = in + getIdx(istrides, j0, 0, k, l);
+            for (dim_t i0 = 0; i0 < odims[0]; i0 += TRANSPOSE_TILE) {
+                const dim_t rows = std::min(TRANSPOSE_TILE, odims[0] - i0);
+                transposeTile<T, conjugate>(optr + i0 * ostrides[0], ostrides[1],
+                                            iptr + i0 * istrides[1],
+                                            istrides[0], istrides[1], rows, cols);
             }
-            // outData and inData pointers doesn't need to be
-            // offset as the getIdx function is taking care
-            // of the batch parameter
         }
-    }
+    });
 }
 
 template<typename T>
@@ -76,6 +103,27 @@ void transpose(Param<T> out, CParam<T> in, const bool conjugate)
     return (conjugate ? transpose<T, true>(out, in) : transpose<T, false>(out, in));
 }
 
+// Swaps the rows x cols tile at a with the transpose of the one at b. When a
+// and b are the same diagonal tile only its lower triangle is walked.
+template<typename T, bool conjugate>
+static void swapTiles(T *a, T *b, const dim_t st0, const dim_t st1,
+                      const dim_t rows, const dim_t cols, const bool diagonal)
+{
+    for (dim_t j = 0; j < cols; ++j) {
+        for (dim_t i = diagonal ? j + 1 : 0; i < rows; ++i) {
+            T &x = a[i * st0 + j * st1];
+            T &y = b[j * st0 + i * st1];
+            const T tmp = x;
+            x = conjugate ? getConjugate(y) : y;
+            y = conjugate ? getConjugate(tmp) : tmp;
+        }
+        if (conjugate && diagonal && j < rows) {
+            T &x = a[j * st0 + j * st1];
+            x = getConjugate(x);
+        }
+    }
+}
+
 template<typename T, bool conjugate>
 void transpose_inplace(Param<T> input)
 {
@@ -84,37 +132,124 @@ void transpose_inplace(Param<T> input)
 
     T * in = input.get();
 
-    for (dim_t l = 0; l < idims[3]; ++l) {
-        for (dim_t k = 0; k < idims[2]; ++k) {
-            // Outermost loop handles batch mode
-            // if input has no data along third dimension
-            // this loop runs only once
-            //
-            // Run only bottom triangle. std::swap swaps with upper triangle
-            for (dim_t j = 0; j < idims[1]; ++j) {
-                for (dim_t i = j + 1; i < idims[0]; ++i) {
-                    // calculate array indices based on offsets and strides
-                    // the helper getIdx takes care of indices
-                    const dim_t iIdx  = getIdx(istrides,j,i,k,l);
-                    const dim_t oIdx = getIdx(istrides,i,j,k,l);
-                    if(conjugate) {
-                        in[iIdx] = getConjugate(in[iIdx]);
-                        in[oIdx] = getConjugate(in[oIdx]);
-                        std::swap(in[iIdx], in[oIdx]);
-                    }
-                    else {
-                        std::swap(in[iIdx], in[oIdx]);
-                    }
+    // Tile row r swaps the tiles left of the diagonal with the ones above it.
+    // Every task takes rows r and tiles - 1 - r so that they all do the same
+    // amount of work.
+    const dim_t tiles = (idims[0] + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    const dim_t pairs = (tiles + 1) / 2;
+    const dim_t grain = std::max<dim_t>(1, TRANSPOSE_GRAIN / (TRANSPOSE_TILE * idims[0]));
+
+    auto tileRow = [=](T *ptr, const dim_t r) {
+        const dim_t i0   = r * TRANSPOSE_TILE;
+        const dim_t rows = std::min(TRANSPOSE_TILE, idims[0] - i0);
+        for (dim_t j0 = 0; j0 <= i0; j0 += TRANSPOSE_TILE) {
+            const dim_t cols = std::min(TRANSPOSE_TILE, idims[1] - j0);
+            swapTiles<T, conjugate>(ptr + i0 * istrides[0] + j0 * istrides[1],
+                                    ptr + j0 * istrides[0] + i0 * istrides[1],
+                                    istrides[0], istrides[1], rows, cols, i0 == j0);
+        }
+    };
+
+    parallelFor(pairs * idims[2] * idims[3], grain, [=](dim_t begin, dim_t end) {
+        for (dim_t t = begin; t < end; ++t) {
+            const dim_t batch = t / pairs;
+            const dim_t r     = t - batch * pairs;
+            const dim_t l     = batch / idims[2];
+            const dim_t k     = batch - l * idims[2];
+            T *ptr = in + getIdx(istrides, 0, 0, k, l);
+            tileRow(ptr, r);
+            if (tiles - 1 - r != r) tileRow(ptr, tiles - 1 - r);
+        }
+    });
+}
+
+// Rectangular matrices of up to this many elements are permuted in place. The
+// larger ones are transposed through a scratch matrix.
+static const dim_t TRANSPOSE_INPLACE_MAX = 1 << 20;
+
+// Transposes the contiguous M x N matrices of input in place, leaving N x M
+// matrices behind. The element at i + j * M moves to j + i * N, that is index
+// x moves to x * N mod (M * N - 1), and the permutation is walked one cycle at
+// a time. A bitmap of M * N bits, kept by each thread across calls, marks the
+// elements already moved. Cycles span the whole matrix so the batches, not the
+// cycles, are split across threads.
+template<typename T, bool conjugate>
+void transpose_inplace_rect(Param<T> input)
+{
+    const dim4 idims = input.dims();
+    const dim_t M    = idims[0];
+    const dim_t N    = idims[1];
+    const dim_t size = M * N;
+    const dim_t last = size - 1;
+
+    T * in = input.get();
+
+    parallelFor(idims[2] * idims[3], 1, [=](dim_t begin, dim_t end) {
+        static thread_local std::vector<bool> moved;
+        for (dim_t b = begin; b < end; ++b) {
+            T *ptr = in + b * size;
+            moved.assign(size, false);
+            for (dim_t start = 0; start < size; ++start) {
+                if (moved[start]) continue;
+                moved[start] = true;
+                // First and last elements and the other fixed points
+                dim_t next = start == last ? last : (start * N) % last;
+                if (next == start) {
+                    if (conjugate) ptr[start] = getConjugate(ptr[start]);
+                    continue;
                 }
+                T carry = ptr[start];
+                while (next != start) {
+                    const T tmp = ptr[next];
+                    ptr[next] = conjugate ? getConjugate(carry) : carry;
+                    carry = tmp;
+                    moved[next] = true;
+                    next = (next * N) % last;
+                }
+                ptr[start] = conjugate ? getConjugate(carry) : carry;
             }
         }
+    });
+}
+
+// Transposes the contiguous M x N matrices of input one after the other into
+// the N x M scratch matrix, then copies each back. Both steps are split across
+// the threads, which the cycles of transpose_inplace_rect can not be.
+template<typename T, bool conjugate>
+void transpose_scratch_rect(Param<T> input, Param<T> scratch)
+{
+    const dim4 idims = input.dims();
+    const dim_t size = idims[0] * idims[1];
+
+    T * tmp = scratch.get();
+
+    for (dim_t b = 0; b < idims[2] * idims[3]; ++b) {
+        T *ptr = input.get() + b * size;
+        transpose<T, conjugate>(scratch, CParam<T>(ptr, dim4(idims[0], idims[1]),
+                                                   input.strides()));
+        parallelFor(size, TRANSPOSE_GRAIN, [=](dim_t begin, dim_t end) {
+            std::copy(tmp + begin, tmp + end, ptr + begin);
+        });
     }
 }
 
 template<typename T>
 void transpose_inplace(Param<T> in, const bool conjugate)
 {
-    return (conjugate ? transpose_inplace<T, true >(in) : transpose_inplace<T, false>(in));
+    const dim4 dims = in.dims();
+    if (dims[0] == dims[1]) {
+        return (conjugate ? transpose_inplace<T, true >(in) : transpose_inplace<T, false>(in));
+    } else {
+        return (conjugate ? transpose_inplace_rect<T, true >(in)
+                          : transpose_inplace_rect<T, false>(in));
+    }
+}
+
+template<typename T>
+void transpose_inplace_scratch(Param<T> in, Param<T> scratch, const bool conjugate)
+{
+    return (conjugate ? transpose_scratch_rect<T, true >(in, scratch)
+                      : transpose_scratch_rect<T, false>(in, scratch));
 }
 
 }
@@ -0,0 +1,138 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <parallel.hpp>
+#include <kernel/Array.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Minimum number of elements compacted by a single thread
+static const dim_t WHERE_GRAIN = 1 << 16;
+
+// Calls func(ptr, idx, count) for the contiguous pieces of the elements
+// [begin, end) of in, where idx is the linear index of ptr[0]
+template<typename T, typename Func>
+void forEachRow(CParam<T> in, dim_t begin, dim_t end, Func func)
+{
+    const af::dim4 dims    = in.dims();
+    const af::dim4 strides = in.strides();
+    const dim_t rowLen     = dims[0];
+
+    for (dim_t i = begin; i < end;) {
+        dim_t row   = i / rowLen;
+        dim_t col   = i % rowLen;
+        dim_t count = std::min(rowLen - col, end - i);
+
+        dim_t r1 = row % dims[1];
+        dim_t r2 = (row / dims[1]) % dims[2];
+        dim_t r3 = row / (dims[1] * dims[2]);
+        func(in.get() + r3 * strides[3] + r2 * strides[2] + r1 * strides[1] + col,
+             i, count);
+        i += count;
+    }
+}
+
+// Returns the number of non zero elements of in and writes their linear
+// indices to the buffer returned by alloc(count). Every thread counts the
+// non zero elements of a contiguous chunk first. The prefix sum of the counts
+// gives the position every chunk writes its indices at in the second pass.
+template<typename T, typename Alloc>
+dim_t where(CParam<T> in, Alloc alloc)
+{
+    const dim_t nelems     = in.dims().elements();
+    const unsigned nchunks = getNumChunks(nelems, WHERE_GRAIN);
+    const T zero           = scalar<T>(0);
+
+    std::vector<dim_t> offsets(nchunks + 1, 0);
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end, count = 0;
+        chunkRange(nelems, nchunks, chunk, begin, end);
+        forEachRow(in, begin, end, [&](const T *ptr, dim_t, dim_t len) {
+            for (dim_t j = 0; j < len; j++) count += (ptr[j] != zero);
+        });
+        offsets[chunk + 1] = count;
+    });
+
+    for (unsigned chunk = 0; chunk < nchunks; chunk++) {
+        offsets[chunk + 1] += offsets[chunk];
+    }
+
+    const dim_t total = offsets[nchunks];
+    uint *out = alloc(total);
+    if (total == 0) return 0;
+
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end;
+        chunkRange(nelems, nchunks, chunk, begin, end);
+        if (offsets[chunk] == offsets[chunk + 1]) return;
+
+        // Every index is stored and the position only advances past non zero
+        // elements, so the loop has no branches. Stores past the end of the
+        // chunk go to a scratch slot.
+        uint *pos = out + offsets[chunk];
+        uint *last = out + offsets[chunk + 1];
+        uint scratch[1];
+        forEachRow(in, begin, end, [&](const T *ptr, dim_t idx, dim_t len) {
+            for (dim_t j = 0; j < len; j++) {
+                uint *dst = pos < last ? pos : scratch;
+                *dst = (uint)(idx + j);
+                pos += (ptr[j] != zero);
+            }
+        });
+    });
+
+    return total;
+}
+
+// Same as above for the output of a JIT tree, which is never evaluated into
+// a buffer. Every thread evaluates a contiguous chunk of the elements from its
+// own copy of the tree and keeps the indices of the chunk, so that the tree is
+// evaluated only once. The prefix sum of the counts gives the position every
+// chunk copies its indices to.
+template<typename T, typename Alloc>
+dim_t where(jit::Node_ptr node, const af::dim4 dims, Alloc alloc)
+{
+    const unsigned nchunks = getNumChunks(dims.elements(), WHERE_GRAIN);
+    const T zero           = scalar<T>(0);
+
+    std::vector<std::vector<uint>> indices(nchunks);
+    parallelEvalBlocks<T>(node, dims, nchunks,
+                          [&](unsigned chunk, const T *vals, dim_t idx, int lim) {
+        std::vector<uint> &chunkIndices = indices[chunk];
+        for (int j = 0; j < lim; j++) {
+            if (vals[j] != zero) chunkIndices.push_back((uint)(idx + j));
+        }
+        return false;
+    });
+
+    std::vector<dim_t> offsets(nchunks + 1, 0);
+    for (unsigned chunk = 0; chunk < nchunks; chunk++) {
+        offsets[chunk + 1] = offsets[chunk] + indices[chunk].size();
+    }
+
+    const dim_t total = offsets[nchunks];
+    uint *out = alloc(total);
+    if (total == 0) return 0;
+
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        std::copy(indices[chunk].begin(), indices[chunk].end(), out + offsets[chunk]);
+    });
+
+    return total;
+}
+
+}
+}
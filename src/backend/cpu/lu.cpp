@@ -16,9 +16,11 @@
 #include <kernel/lu.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
+#include <parallel.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <range.hpp>
+#include <common/small_lapack.hpp>
 
 #include <cassert>
 #include <iostream>
@@ -59,8 +61,8 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot, const Array<T> &in)
     pivot = lu_inplace(in_copy);
 
     // SPLIT into lower and upper
-    dim4 ldims(M, min(M, N));
-    dim4 udims(min(M, N), N);
+    dim4 ldims(M, min(M, N), iDims[2], iDims[3]);
+    dim4 udims(min(M, N), N, iDims[2], iDims[3]);
     lower = createEmptyArray<T>(ldims);
     upper = createEmptyArray<T>(udims);
 
@@ -73,16 +75,32 @@ Array<int> lu_inplace(Array<T> &in, const bool convert_pivot)
     in.eval();
 
     dim4 iDims = in.dims();
-    Array<int> pivot = createEmptyArray<int>(af::dim4(min(iDims[0], iDims[1]), 1, 1, 1));
+    Array<int> pivot = createEmptyArray<int>(af::dim4(min(iDims[0], iDims[1]), 1,
+                                                      iDims[2], iDims[3]));
 
+    // Every matrix along dimensions 2 and 3 is factorized independently,
+    // small square ones by the unrolled kernel
     auto func = [=] (Param<T> in, Param<int> pivot) {
         dim4 iDims = in.dims();
-        getrf_func<T>()(AF_LAPACK_COL_MAJOR, iDims[0], iDims[1], in.get(), in.strides(1), pivot.get());
+        const int M = iDims[0];
+        const int N = iDims[1];
+        parallelFor(iDims[2] * iDims[3], common::lapackBatchGrain(max(M, N)),
+                    [&] (dim_t begin, dim_t end) {
+            for (dim_t n = begin; n < end; n++) {
+                T *iPtr   = in.get() + common::batchOffset(iDims, in.strides(), n);
+                int *pPtr = pivot.get() + common::batchOffset(pivot.dims(), pivot.strides(), n);
+                if (M == N && common::isSmallLapack(N)) {
+                    common::getrfSmall(iPtr, in.strides(1), pPtr, N);
+                } else {
+                    getrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N, iPtr, in.strides(1), pPtr);
+                }
+            }
+        });
     };
     getQueue().enqueue(func, in, pivot);
 
     if(convert_pivot) {
-        Array<int> p = range<int>(dim4(iDims[0]), 0);
+        Array<int> p = range<int>(dim4(iDims[0], 1, iDims[2], iDims[3]), 0);
         getQueue().enqueue(kernel::convertPivot, p, pivot);
         return p;
     } else {
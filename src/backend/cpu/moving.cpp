@@ -0,0 +1,58 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <moving.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+#include <kernel/moving.hpp>
+
+using af::dim4;
+
+namespace cpu
+{
+
+template<typename Ti, typename To>
+Array<To> moving(const Array<Ti> &in, const af_stat_type stat, const dim_t window,
+                 const dim_t step, const af_var_bias bias, const int dim)
+{
+    in.eval();
+
+    dim4 odims = in.dims();
+    odims[dim] = (odims[dim] - window) / step + 1;
+    Array<To> out = createEmptyArray<To>(odims);
+
+    getQueue().enqueue(kernel::moving<Ti, To>, out, in, stat, window, step, bias, dim);
+
+    return out;
+}
+
+#define INSTANTIATE(Ti, To)                                             \
+    template Array<To> moving<Ti, To>(const Array<Ti> &in, const af_stat_type stat, \
+                                      const dim_t window, const dim_t step, \
+                                      const af_var_bias bias, const int dim);
+
+INSTANTIATE(float , float )
+INSTANTIATE(double, double)
+INSTANTIATE(int   , int   )
+INSTANTIATE(int   , float )
+INSTANTIATE(uint  , uint  )
+INSTANTIATE(uint  , float )
+INSTANTIATE(intl  , intl  )
+INSTANTIATE(intl  , double)
+INSTANTIATE(uintl , uintl )
+INSTANTIATE(uintl , double)
+INSTANTIATE(short , short )
+INSTANTIATE(short , float )
+INSTANTIATE(ushort, ushort)
+INSTANTIATE(ushort, float )
+INSTANTIATE(uchar , uchar )
+INSTANTIATE(uchar , float )
+
+}
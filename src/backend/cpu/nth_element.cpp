@@ -0,0 +1,52 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <nth_element.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+#include <kernel/nth_element.hpp>
+
+using af::dim4;
+using std::vector;
+
+namespace cpu
+{
+
+template<typename T>
+Array<T> nthElement(const Array<T> &in, const unsigned dim,
+                    const vector<dim_t> &ranks)
+{
+    in.eval();
+
+    dim4 odims = in.dims();
+    odims[dim] = ranks.size();
+    Array<T> out = createEmptyArray<T>(odims);
+
+    getQueue().enqueue(kernel::nthElement<T>, out, in, dim, ranks);
+
+    return out;
+}
+
+#define INSTANTIATE(T)                                                  \
+    template Array<T> nthElement<T>(const Array<T> &in, const unsigned dim, \
+                                    const vector<dim_t> &ranks);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(char)
+INSTANTIATE(uchar)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+INSTANTIATE(intl)
+INSTANTIATE(uintl)
+
+}
@@ -0,0 +1,21 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <vector>
+
+namespace cpu
+{
+// Returns the elements that would be at positions ranks[i] of every slice
+// along dim if the input was sorted in ascending order. The output has
+// ranks.size() elements along dim.
+template<typename T>
+Array<T> nthElement(const Array<T> &in, const unsigned dim,
+                    const std::vector<dim_t> &ranks);
+}
@@ -0,0 +1,196 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <parallel.hpp>
+#include <common/util.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::atomic;
+using std::condition_variable;
+using std::exception_ptr;
+using std::function;
+using std::lock_guard;
+using std::mutex;
+using std::shared_ptr;
+using std::unique_lock;
+
+namespace cpu
+{
+
+namespace
+{
+
+// Set on threads that are currently executing a parallel task. Nested
+// parallel regions run serially to avoid starving the pool.
+thread_local bool inParallelRegion = false;
+
+// State shared by all the threads working on a single parallelTasks call
+struct Job
+{
+    const function<void(unsigned)> *func;
+    unsigned ntasks;
+    atomic<unsigned> next;
+    unsigned done;
+    exception_ptr error;
+    mutex lock;
+    condition_variable finished;
+
+    Job(const function<void(unsigned)> *f, unsigned n)
+        : func(f), ntasks(n), next(0), done(0), error(nullptr)
+    {}
+
+    // Runs tasks until none are left. Returns once this thread cannot pick
+    // any more tasks.
+    void work()
+    {
+        bool prev = inParallelRegion;
+        inParallelRegion = true;
+        unsigned task;
+        while ((task = next++) < ntasks) {
+            exception_ptr err = nullptr;
+            try {
+                (*func)(task);
+            } catch (...) {
+                err = std::current_exception();
+            }
+            lock_guard<mutex> guard(lock);
+            if (err && !error) error = err;
+            if (++done == ntasks) finished.notify_all();
+        }
+        inParallelRegion = prev;
+    }
+};
+
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned nworkers)
+    {
+        for (unsigned i = 0; i < nworkers; ++i) {
+            workers.emplace_back([this] { this->loop(); });
+        }
+    }
+
+    void submit(const shared_ptr<Job> &job, unsigned copies)
+    {
+        {
+            lock_guard<mutex> guard(qlock);
+            for (unsigned i = 0; i < copies; ++i) jobs.push_back(job);
+        }
+        if (copies == 1) available.notify_one();
+        else             available.notify_all();
+    }
+
+    unsigned size() const { return (unsigned)workers.size(); }
+
+private:
+    void loop()
+    {
+        while (true) {
+            shared_ptr<Job> job;
+            {
+                unique_lock<mutex> guard(qlock);
+                available.wait(guard, [this] { return !jobs.empty(); });
+                job = jobs.front();
+                jobs.pop_front();
+            }
+            job->work();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<shared_ptr<Job>> jobs;
+    mutex qlock;
+    condition_variable available;
+};
+
+// The pool is intentionally leaked, like the DeviceManager instance, so that
+// the workers are not joined during static destruction.
+ThreadPool &getPool()
+{
+    static ThreadPool *pool = new ThreadPool(getNumThreads() - 1);
+    return *pool;
+}
+
+}
+
+unsigned getNumThreads()
+{
+    static const unsigned nthreads = [] {
+        unsigned count = std::thread::hardware_concurrency();
+        std::string env_var = getEnvVar("AF_CPU_NUM_THREADS");
+        if (!env_var.empty()) {
+            // Malformed or out of range values are ignored
+            char *end = nullptr;
+            errno = 0;
+            long value = std::strtol(env_var.c_str(), &end, 10);
+            if (errno == 0 && end != env_var.c_str() && *end == '\0' &&
+                value > 0 && value <= (long)UINT16_MAX) {
+                count = (unsigned)value;
+            }
+        }
+        return std::max(count, 1u);
+    }();
+    return nthreads;
+}
+
+unsigned getNumChunks(dim_t count, dim_t grain)
+{
+    if (count <= 0) return 0;
+    grain = std::max(grain, (dim_t)1);
+    dim_t nchunks = std::min((dim_t)getNumThreads(), (count + grain - 1) / grain);
+    return (unsigned)std::max(nchunks, (dim_t)1);
+}
+
+void parallelTasks(unsigned ntasks, const function<void(unsigned)> &func)
+{
+    if (ntasks == 0) return;
+
+    if (ntasks == 1 || inParallelRegion || getNumThreads() == 1) {
+        for (unsigned t = 0; t < ntasks; ++t) func(t);
+        return;
+    }
+
+    ThreadPool &pool = getPool();
+    auto job = std::make_shared<Job>(&func, ntasks);
+    pool.submit(job, std::min(ntasks - 1, pool.size()));
+
+    // The calling thread works on the job as well
+    job->work();
+
+    unique_lock<mutex> guard(job->lock);
+    job->finished.wait(guard, [&job] { return job->done == job->ntasks; });
+    if (job->error) std::rethrow_exception(job->error);
+}
+
+void parallelFor(dim_t count, dim_t grain,
+                 const function<void(dim_t, dim_t)> &func)
+{
+    unsigned nchunks = getNumChunks(count, grain);
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end;
+        chunkRange(count, nchunks, chunk, begin, end);
+        func(begin, end);
+    });
+}
+
+}
@@ -0,0 +1,91 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/defines.h>
+#include <algorithm>
+#include <functional>
+
+namespace cpu
+{
+
+/// Returns the number of threads (including the calling thread) the CPU
+/// kernels split their work across. Defaults to the number of hardware
+/// threads and can be overridden using the AF_CPU_NUM_THREADS environment
+/// variable.
+unsigned getNumThreads();
+
+/// Returns the number of chunks parallelFor splits \p count elements into
+/// when each chunk must have at least \p grain elements.
+unsigned getNumChunks(dim_t count, dim_t grain);
+
+/// Calls \p func(task) for every task in [0, \p ntasks) using the worker
+/// thread pool and returns once all of them finished. Calls made from inside
+/// another parallel region are executed serially on the calling thread.
+void parallelTasks(unsigned ntasks, const std::function<void(unsigned)> &func);
+
+/// Splits [0, \p count) into getNumChunks(count, grain) contiguous ranges and
+/// calls \p func(begin, end) on each of them concurrently.
+void parallelFor(dim_t count, dim_t grain,
+                 const std::function<void(dim_t, dim_t)> &func);
+
+/// Returns the [begin, end) range of chunk \p chunk when \p count elements
+/// are split into \p nchunks nearly equal chunks.
+static inline
+void chunkRange(dim_t count, unsigned nchunks, unsigned chunk,
+                dim_t &begin, dim_t &end)
+{
+    begin = (count * chunk) / nchunks;
+    end   = (count * (chunk + 1)) / nchunks;
+}
+
+/// Returns the [begin, end) range of chunk \p chunk when [0, \p count) is
+/// split into \p nchunks contiguous ranges of nearly equal weight, where the
+/// weight of [begin, end) is offsets[end] - offsets[begin]. A CSR row index
+/// array is the offsets of its rows weighted by their number of nonzeros.
+template<typename I>
+void weightedChunkRange(const I *offsets, dim_t count, unsigned nchunks,
+                        unsigned chunk, dim_t &begin, dim_t &end)
+{
+    const dim_t total = (dim_t)(offsets[count] - offsets[0]);
+
+    // First element whose weight starts at or after the one of chunk c
+    auto boundary = [&](unsigned c) {
+        if (c == 0)       return (dim_t)0;
+        if (c == nchunks) return count;
+        dim_t wbegin, wend;
+        chunkRange(total, nchunks, c, wbegin, wend);
+        const I *pos = std::lower_bound(offsets, offsets + count,
+                                        (I)(offsets[0] + wbegin));
+        return (dim_t)(pos - offsets);
+    };
+
+    begin = boundary(chunk);
+    end   = boundary(chunk + 1);
+}
+
+/// Splits [0, \p count) into ranges of nearly equal weight, see
+/// weightedChunkRange, holding at least \p grain each and calls
+/// \p func(begin, end) on each of them concurrently.
+template<typename I>
+void parallelForWeighted(const I *offsets, dim_t count, dim_t grain,
+                         const std::function<void(dim_t, dim_t)> &func)
+{
+    const dim_t total = (dim_t)(offsets[count] - offsets[0]);
+    const unsigned nchunks = getNumChunks(std::max(total, (dim_t)1), grain);
+
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end;
+        weightedChunkRange(offsets, count, nchunks, chunk, begin, end);
+        if (begin < end) func(begin, end);
+    });
+}
+
+}
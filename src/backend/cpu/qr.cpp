@@ -18,8 +18,10 @@
 #include <triangle.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
+#include <parallel.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
+#include <common/small_lapack.hpp>
 
 namespace cpu
 {
@@ -69,20 +71,29 @@ void qr(Array<T> &q, Array<T> &r, Array<T> &t, const Array<T> &in)
     int M      = iDims[0];
     int N      = iDims[1];
 
-    q = padArray<T, T>(in, dim4(M, max(M, N)));
+    q = padArray<T, T>(in, dim4(M, max(M, N), iDims[2], iDims[3]));
     q.resetDims(iDims);
     t = qr_inplace(q);
 
     // SPLIT into q and r
-    dim4 rdims(M, N);
+    dim4 rdims(M, N, iDims[2], iDims[3]);
     r = createEmptyArray<T>(rdims);
 
     triangle<T, true, false>(r, q);
 
     auto func = [=] (Param<T> q, Param<T> t, int M, int N) {
-        gqr_func<T>()(AF_LAPACK_COL_MAJOR, M, M, min(M, N), q.get(), q.strides(1), t.get());
+        const dim4 qDims = q.dims();
+        parallelFor(qDims[2] * qDims[3], common::lapackBatchGrain(max(M, N)),
+                    [&] (dim_t begin, dim_t end) {
+            for (dim_t n = begin; n < end; n++) {
+                gqr_func<T>()(AF_LAPACK_COL_MAJOR, M, M, min(M, N),
+                              q.get() + common::batchOffset(qDims, q.strides(), n),
+                              q.strides(1),
+                              t.get() + common::batchOffset(t.dims(), t.strides(), n));
+            }
+        });
     };
-    q.resetDims(dim4(M, M));
+    q.resetDims(dim4(M, M, iDims[2], iDims[3]));
     getQueue().enqueue(func, q, t, M, N);
 }
 
@@ -94,10 +105,20 @@ Array<T> qr_inplace(Array<T> &in)
     dim4 iDims = in.dims();
     int M      = iDims[0];
     int N      = iDims[1];
-    Array<T> t = createEmptyArray<T>(af::dim4(min(M, N), 1, 1, 1));
+    Array<T> t = createEmptyArray<T>(af::dim4(min(M, N), 1, iDims[2], iDims[3]));
 
+    // Every matrix along dimensions 2 and 3 is factorized independently
     auto func = [=] (Param<T> in, Param<T> t, int M, int N) {
-        geqrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N, in.get(), in.strides(1), t.get());
+        const dim4 iDims = in.dims();
+        parallelFor(iDims[2] * iDims[3], common::lapackBatchGrain(max(M, N)),
+                    [&] (dim_t begin, dim_t end) {
+            for (dim_t n = begin; n < end; n++) {
+                geqrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N,
+                                in.get() + common::batchOffset(iDims, in.strides(), n),
+                                in.strides(1),
+                                t.get() + common::batchOffset(t.dims(), t.strides(), n));
+            }
+        });
     };
     getQueue().enqueue(func, in, t, M, N);
 
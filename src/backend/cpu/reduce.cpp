@@ -62,6 +62,15 @@ Array<To> reduce(const Array<Ti> &in, const int dim, bool change_nan, double nan
 template<af_op_t op, typename Ti, typename To>
 To reduce_all(const Array<Ti> &in, bool change_nan, double nanval)
 {
+    // anyTrue, allTrue and count are commonly applied to temporary masks.
+    // They reduce JIT inputs without evaluating them into a buffer, and
+    // anyTrue and allTrue stop reading the input once the result is known.
+    if (op == af_or_t || op == af_and_t || op == af_notzero_t) {
+        getQueue().sync();
+        if (in.isReady()) return kernel::reduce_all<op, Ti, To>(in);
+        return kernel::reduce_all<op, Ti, To>(in.getNode(), in.dims());
+    }
+
     in.eval();
     getQueue().sync();
 
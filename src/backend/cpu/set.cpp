@@ -18,6 +18,8 @@
 #include <vector>
 #include <platform.hpp>
 #include <queue.hpp>
+#include <kernel/set.hpp>
+#include <kernel/sort.hpp>
 
 namespace cpu
 {
@@ -25,15 +27,47 @@ namespace cpu
 using namespace std;
 using af::dim4;
 
+// Returns the distinct elements of the given host buffers in ascending
+// order. The values are deduplicated using a hash set first, so only the
+// distinct values are sorted.
+template<typename T>
+static Array<T> hashUnique(const std::vector<const T *> &ptrs,
+                           const std::vector<dim_t> &sizes)
+{
+    kernel::hash_set<T> set;
+    set.build(ptrs, sizes);
+
+    Array<T> out = createEmptyArray<T>(dim4(set.size()));
+    set.values(out.get());
+
+    std::vector<T> keyTmp;
+    std::vector<uint> idxTmp;
+    kernel::sortColumn<T>(out.get(), out.elements(), true, keyTmp, idxTmp);
+    return out;
+}
+
+// Returns in when it is stored contiguously and a contiguous copy otherwise
+template<typename T>
+static Array<T> linearArray(const Array<T> &in)
+{
+    in.eval();
+    if (in.isLinear()) return in;
+    return copyArray<T>(in);
+}
+
 template<typename T>
 Array<T> setUnique(const Array<T> &in,
                     const bool is_sorted)
 {
     in.eval();
 
-    Array<T> out = createEmptyArray<T>(af::dim4());
-    if (is_sorted) out = copyArray<T>(in);
-    else           out = sort<T>(in, 0, true);
+    if (!is_sorted) {
+        Array<T> lin = linearArray(in);
+        getQueue().sync();
+        return hashUnique<T>({lin.get()}, {lin.elements()});
+    }
+
+    Array<T> out = copyArray<T>(in);
 
     // Need to sync old jobs since we need to
     // operator on pointers directly in std::unique
@@ -55,17 +89,21 @@ Array<T> setUnion(const Array<T> &first,
 {
     first.eval();
     second.eval();
+
+    if (!is_unique) {
+        // The union is the set of distinct values of both the inputs
+        Array<T> lFirst  = linearArray(first);
+        Array<T> lSecond = linearArray(second);
+        getQueue().sync();
+        return hashUnique<T>({lFirst.get(), lSecond.get()},
+                             {lFirst.elements(), lSecond.elements()});
+    }
+
     getQueue().sync();
 
     Array<T> uFirst = first;
     Array<T> uSecond = second;
 
-    if (!is_unique) {
-        // FIXME: Perhaps copy + unique would do ?
-        uFirst  = setUnique(first, false);
-        uSecond = setUnique(second, false);
-    }
-
     dim_t first_elements  = uFirst.elements();
     dim_t second_elements = uSecond.elements();
     dim_t elements = first_elements + second_elements;
@@ -91,16 +129,39 @@ Array<T> setIntersect(const Array<T> &first,
 {
     first.eval();
     second.eval();
+
+    if (!is_unique) {
+        // Build a hash set of the distinct values of the smaller input and
+        // keep the distinct values of the larger one found in it
+        Array<T> lFirst  = linearArray(first);
+        Array<T> lSecond = linearArray(second);
+        getQueue().sync();
+
+        bool firstSmaller = lFirst.elements() <= lSecond.elements();
+        Array<T> &small = firstSmaller ? lFirst : lSecond;
+        Array<T> &large = firstSmaller ? lSecond : lFirst;
+
+        kernel::hash_set<T> set;
+        set.build({small.get()}, {small.elements()});
+
+        Array<char> found = createEmptyArray<char>(large.dims());
+        kernel::isIn<T>(found.get(), large.get(), large.elements(), set);
+
+        const char *fptr = found.get();
+        const T *lptr = large.get();
+        std::vector<T> matches;
+        for (dim_t i = 0; i < large.elements(); i++) {
+            if (fptr[i]) matches.push_back(lptr[i]);
+        }
+
+        return hashUnique<T>({matches.data()}, {(dim_t)matches.size()});
+    }
+
     getQueue().sync();
 
     Array<T> uFirst = first;
     Array<T> uSecond = second;
 
-    if (!is_unique) {
-        uFirst  = setUnique(first, false);
-        uSecond = setUnique(second, false);
-    }
-
     dim_t first_elements  = uFirst.elements();
     dim_t second_elements = uSecond.elements();
     dim_t elements = std::max(first_elements, second_elements);
@@ -119,10 +180,25 @@ Array<T> setIntersect(const Array<T> &first,
     return out;
 }
 
+template<typename T>
+Array<char> isIn(const Array<T> &in, const Array<T> &set)
+{
+    Array<T> lin  = linearArray(in);
+    Array<T> lset = linearArray(set);
+    Array<char> out = createEmptyArray<char>(in.dims());
+    getQueue().sync();
+
+    kernel::hash_set<T> hset;
+    hset.build({lset.get()}, {lset.elements()});
+    kernel::isIn<T>(out.get(), lin.get(), lin.elements(), hset);
+    return out;
+}
+
 #define INSTANTIATE(T)                                                  \
     template Array<T> setUnique<T>(const Array<T> &in, const bool is_sorted); \
     template Array<T> setUnion<T>(const Array<T> &first, const Array<T> &second, const bool is_unique); \
     template Array<T> setIntersect<T>(const Array<T> &first, const Array<T> &second, const bool is_unique); \
+    template Array<char> isIn<T>(const Array<T> &in, const Array<T> &set); \
 
 INSTANTIATE(float)
 INSTANTIATE(double)
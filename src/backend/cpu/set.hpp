@@ -21,4 +21,7 @@ namespace cpu
     template<typename T> Array<T> setIntersect(const Array<T> &first,
                                                const Array<T> &second,
                                                const bool is_unique);
+
+    template<typename T> Array<char> isIn(const Array<T> &in,
+                                          const Array<T> &set);
 }
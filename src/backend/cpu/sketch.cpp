@@ -0,0 +1,52 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <sketch.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+#include <kernel/sketch.hpp>
+
+namespace cpu
+{
+
+template<typename T>
+void sketchUpdate(common::quantile_sketch &sketch, const Array<T> &in)
+{
+    in.eval();
+    getQueue().sync();
+
+    kernel::sketchUpdate<T>(sketch, in);
+}
+
+template<typename T>
+void sketchUpdate(common::distinct_sketch &sketch, const Array<T> &in)
+{
+    in.eval();
+    getQueue().sync();
+
+    kernel::sketchUpdate<T>(sketch, in);
+}
+
+#define INSTANTIATE(T)                                                          \
+    template void sketchUpdate<T>(common::quantile_sketch &sketch, const Array<T> &in); \
+    template void sketchUpdate<T>(common::distinct_sketch &sketch, const Array<T> &in);
+
+INSTANTIATE(float )
+INSTANTIATE(double)
+INSTANTIATE(int   )
+INSTANTIATE(uint  )
+INSTANTIATE(intl  )
+INSTANTIATE(uintl )
+INSTANTIATE(short )
+INSTANTIATE(ushort)
+INSTANTIATE(uchar )
+INSTANTIATE(char  )
+
+}
@@ -17,8 +17,11 @@
 #include <err_cpu.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
+#include <parallel.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
+#include <common/small_lapack.hpp>
+#include <vector>
 
 namespace cpu
 {
@@ -39,6 +42,10 @@ template<typename T>
 using trtrs_func_def = int (*)(ORDER_TYPE, char, char, char, int, int,
                                const T *, int, T *, int);
 
+template<typename T>
+using mixed_gesv_func_def = int (*)(ORDER_TYPE, int, int,
+                                    T *, int, int *, T *, int, T *, int, int *);
+
 
 #define SOLVE_FUNC_DEF( FUNC )                                 \
 template<typename T> FUNC##_func_def<T> FUNC##_func();
@@ -72,6 +79,16 @@ SOLVE_FUNC(trtrs , double , d)
 SOLVE_FUNC(trtrs , cfloat , c)
 SOLVE_FUNC(trtrs , cdouble, z)
 
+// dsgesv and zcgesv factorize in single precision and refine the solution
+// with double precision residuals, falling back to a double precision
+// factorization when the refinement does not converge. There is nothing to
+// gain for single precision systems.
+template<typename T> mixed_gesv_func_def<T> mixed_gesv_func() { return nullptr; }
+template<> mixed_gesv_func_def<double > mixed_gesv_func<double >()
+{ return & LAPACK_NAME(dsgesv); }
+template<> mixed_gesv_func_def<cdouble> mixed_gesv_func<cdouble>()
+{ return & LAPACK_NAME(zcgesv); }
+
 template<typename T>
 Array<T> solveLU(const Array<T> &A, const Array<int> &pivot,
                  const Array<T> &b, const af_mat_prop options)
@@ -105,14 +122,23 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b, const af_mat_prop o
     int N      = B.dims()[0];
     int NRHS   = B.dims()[1];
 
+    // Every matrix along dimensions 2 and 3 is an independent system
     auto func = [=] (Param<T> A, Param<T> B, int N, int NRHS, const af_mat_prop options) {
-        trtrs_func<T>()(AF_LAPACK_COL_MAJOR,
-                        options & AF_MAT_UPPER ? 'U' : 'L',
-                        'N', // transpose flag
-                        options & AF_MAT_DIAG_UNIT ? 'U' : 'N',
-                        N, NRHS,
-                        A.get(), A.strides(1),
-                        B.get(), B.strides(1));
+        const dim4 aDims = A.dims();
+        parallelFor(aDims[2] * aDims[3], common::lapackBatchGrain(N),
+                    [&] (dim_t begin, dim_t end) {
+            for (dim_t n = begin; n < end; n++) {
+                trtrs_func<T>()(AF_LAPACK_COL_MAJOR,
+                                options & AF_MAT_UPPER ? 'U' : 'L',
+                                'N', // transpose flag
+                                options & AF_MAT_DIAG_UNIT ? 'U' : 'N',
+                                N, NRHS,
+                                A.get() + common::batchOffset(aDims, A.strides(), n),
+                                A.strides(1),
+                                B.get() + common::batchOffset(B.dims(), B.strides(), n),
+                                B.strides(1));
+            }
+        });
     };
     getQueue().enqueue(func, A, B, N, NRHS, options);
 
@@ -130,32 +156,86 @@ Array<T> solve(const Array<T> &a, const Array<T> &b, const af_mat_prop options)
         return triangleSolve<T>(a, b, options);
     }
 
-    int M = a.dims()[0];
-    int N = a.dims()[1];
+    dim4 aDims = a.dims();
+    int M = aDims[0];
+    int N = aDims[1];
     int K = b.dims()[1];
 
     Array<T> A = copyArray<T>(a);
-    Array<T> B = padArray<T, T>(b, dim4(max(M, N), K));
+    Array<T> B = padArray<T, T>(b, dim4(max(M, N), K, aDims[2], aDims[3]));
+
+    if(M == N && (options & AF_MAT_MIXED_PRECISION) &&
+       mixed_gesv_func<T>() && !common::isSmallLapack(N)) {
+        Array<T> X = createEmptyArray<T>(B.dims());
+
+        auto func = [=] (Param<T> A, Param<T> B, Param<T> X, int N, int K) {
+            const dim4 aDims = A.dims();
+            parallelFor(aDims[2] * aDims[3], common::lapackBatchGrain(N),
+                        [&] (dim_t begin, dim_t end) {
+                std::vector<int> pivot(N);
+                for (dim_t n = begin; n < end; n++) {
+                    int iter = 0;
+                    T *xPtr = X.get() + common::batchOffset(X.dims(), X.strides(), n);
+                    int info = mixed_gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K,
+                                                    A.get() + common::batchOffset(aDims, A.strides(), n),
+                                                    A.strides(1), pivot.data(),
+                                                    B.get() + common::batchOffset(B.dims(), B.strides(), n),
+                                                    B.strides(1), xPtr, X.strides(1), &iter);
+                    // X is not written when the system is singular
+                    if (info > 0) common::fillSingular(xPtr, X.strides(1), K, N);
+                }
+            });
+        };
+        getQueue().enqueue(func, A, B, X, N, K);
+        return X;
+    }
 
     if(M == N) {
-        Array<int> pivot = createEmptyArray<int>(dim4(N, 1, 1));
-
-        auto func = [=] (Param<T> A, Param<T> B, Param<int> pivot, int N, int K) {
-            gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K, A.get(), A.strides(1),
-                           pivot.get(), B.get(), B.strides(1));
+        // Systems of order up to common::SMALL_LAPACK_MAX are solved by the
+        // unrolled kernels, larger ones by gesv, the batch being split
+        // across the threads in both cases. The solution of a singular
+        // system is NaN whichever solved it
+        auto func = [=] (Param<T> A, Param<T> B, int N, int K) {
+            const dim4 aDims = A.dims();
+            parallelFor(aDims[2] * aDims[3], common::lapackBatchGrain(N),
+                        [&] (dim_t begin, dim_t end) {
+                std::vector<int> pivot(N);
+                for (dim_t n = begin; n < end; n++) {
+                    T *aPtr = A.get() + common::batchOffset(aDims, A.strides(), n);
+                    T *bPtr = B.get() + common::batchOffset(B.dims(), B.strides(), n);
+                    int info = 0;
+                    if (common::isSmallLapack(N)) {
+                        info = common::getrfSmall(aPtr, A.strides(1), pivot.data(), N);
+                        if (info == 0) {
+                            common::getrsSmall(aPtr, A.strides(1), pivot.data(),
+                                               bPtr, B.strides(1), K, N);
+                        }
+                    } else {
+                        info = gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K, aPtr, A.strides(1),
+                                              pivot.data(), bPtr, B.strides(1));
+                    }
+                    if (info > 0) common::fillSingular(bPtr, B.strides(1), K, N);
+                }
+            });
         };
-        getQueue().enqueue(func, A, B, pivot, N, K);
+        getQueue().enqueue(func, A, B, N, K);
     } else {
+        // B holds max(M, N) rows for gels but only the first N are returned
         auto func = [=] (Param<T> A, Param<T> B, int M, int N, int K) {
-            int sM = A.strides(1);
-            int sN = A.strides(2) / sM;
-
-            gels_func<T>()(AF_LAPACK_COL_MAJOR, 'N',
-                    M, N, K,
-                    A.get(), A.strides(1),
-                    B.get(), max(sM, sN));
+            const dim4 aDims = A.dims();
+            parallelFor(aDims[2] * aDims[3], common::lapackBatchGrain(max(M, N)),
+                        [&] (dim_t begin, dim_t end) {
+                for (dim_t n = begin; n < end; n++) {
+                    gels_func<T>()(AF_LAPACK_COL_MAJOR, 'N',
+                                   M, N, K,
+                                   A.get() + common::batchOffset(aDims, A.strides(), n),
+                                   A.strides(1),
+                                   B.get() + common::batchOffset(B.dims(), B.strides(), n),
+                                   B.strides(1));
+                }
+            });
         };
-        B.resetDims(dim4(N, K));
+        B.resetDims(dim4(N, K, aDims[2], aDims[3]));
         getQueue().enqueue(func, A, B, M, N, K);
     }
 
@@ -55,12 +55,7 @@ void sortBatched(Array<T>& val, bool isAscending)
 template<typename T>
 void sort0(Array<T>& val, bool isAscending)
 {
-    int higherDims = val.elements() / val.dims()[0];
-    // TODO Make a better heurisitic
-    if(higherDims > 10)
-        sortBatched<T, 0>(val, isAscending);
-    else
-        getQueue().enqueue(kernel::sort0Iterative<T>, val, isAscending);
+    getQueue().enqueue(kernel::sort0Iterative<T>, val, isAscending);
 }
 
 template<typename T>
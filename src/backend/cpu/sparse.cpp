@@ -13,61 +13,53 @@
 #include <stdexcept>
 #include <string>
 
-#include <arith.hpp>
-#include <cast.hpp>
 #include <complex.hpp>
 #include <copy.hpp>
 #include <common/err_common.hpp>
 #include <common/complex.hpp>
-#include <lookup.hpp>
 #include <math.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
-#include <reduce.hpp>
-#include <where.hpp>
 
 namespace cpu {
 
 using common::SparseArray;
 using common::createArrayDataSparseArray;
-using common::createEmptySparseArray;
 
 template<typename T, af_storage stype>
 SparseArray<T> sparseConvertDenseToStorage(const Array<T> &in)
 {
     in.eval();
 
-    if (stype == AF_STORAGE_CSR) {
-        uint nNZ = reduce_all<af_notzero_t, T, uint>(in);
-
-        auto sparse = createEmptySparseArray<T>(in.dims(), nNZ, stype);
-        sparse.eval();
-
-        Array<T  > values = sparse.getValues();
-        Array<int> rowIdx = sparse.getRowIdx();
-        Array<int> colIdx = sparse.getColIdx();
-
-        getQueue().enqueue(kernel::dense2csr<T>, values, rowIdx, colIdx, in);
-
-        return sparse;
-    } else if (stype == AF_STORAGE_COO) {
-        auto nonZeroIdx = cast<int, uint>(where<T>(in));
-
-        dim_t nNZ = nonZeroIdx.elements();
+    if (stype != AF_STORAGE_CSR && stype != AF_STORAGE_COO) {
+        AF_ERROR("CPU Backend only supports Dense to CSR or COO", AF_ERR_NOT_SUPPORTED);
+    }
 
-        auto cnst = createValueArray<int>(dim4(nNZ), in.dims()[0]);
-        cnst.eval();
+    // The nonzeros are counted per row (CSR) or per column (COO) first, which
+    // gives their number, and then scattered in place. The nonzeros of COO
+    // matrices are in column major order.
+    const dim4 dims = in.dims();
+    const bool byRow = (stype == AF_STORAGE_CSR);
+    Array<int> offsets = createEmptyArray<int>(dim4(dims[byRow ? 0 : 1] + 1));
 
-        auto rowIdx = arithOp<int, af_mod_t>(nonZeroIdx, cnst, nonZeroIdx.dims());
-        auto colIdx = arithOp<int, af_div_t>(nonZeroIdx, cnst, nonZeroIdx.dims());
+    if (byRow) {
+        getQueue().enqueue(kernel::denseRowOffsets<T>, offsets, in);
+    } else {
+        getQueue().enqueue(kernel::denseColOffsets<T>, offsets, in);
+    }
+    getQueue().sync();
+    const int nNZ = offsets.get()[offsets.elements() - 1];
 
-        Array<T> values = copyArray<T>(in);
-        values.modDims(dim4(values.elements()));
-        values = lookup<T, int>(values, nonZeroIdx, 0);
+    Array<T  > values = createEmptyArray<T>(dim4(nNZ));
+    Array<int> idx    = createEmptyArray<int>(dim4(nNZ));
 
-        return createArrayDataSparseArray<T>(in.dims(), values, rowIdx, colIdx, stype);
+    if (stype == AF_STORAGE_CSR) {
+        getQueue().enqueue(kernel::dense2csr<T>, values, idx, offsets, in);
+        return createArrayDataSparseArray<T>(dims, values, offsets, idx, stype);
     } else {
-        AF_ERROR("CPU Backend only supports Dense to CSR or COO", AF_ERR_NOT_SUPPORTED);
+        Array<int> colIdx = createEmptyArray<int>(dim4(nNZ));
+        getQueue().enqueue(kernel::dense2coo<T>, values, idx, colIdx, offsets, in);
+        return createArrayDataSparseArray<T>(dims, values, idx, colIdx, stype);
     }
 }
 
@@ -98,24 +90,32 @@ SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in)
 {
     in.eval();
 
-    auto converted = createEmptySparseArray<T>(in.dims(), (int)in.getNNZ(), dest);
-    converted.eval();
+    // Every index array of the output is fully written by the converters
+    const dim4 dims = in.dims();
+    const dim_t nNZ = in.getNNZ();
+    Array<T  > values = createEmptyArray<T>(dim4(nNZ));
+    Array<int> rowIdx = createEmptyArray<int>(dim4(dest == AF_STORAGE_CSR ? dims[0] + 1 : nNZ));
+    Array<int> colIdx = createEmptyArray<int>(dim4(nNZ));
 
     function<void (Param<T>, Param<int>, Param<int>,
                    CParam<T>, CParam<int>, CParam<int>)> converter;
 
     if(src == AF_STORAGE_CSR && dest == AF_STORAGE_COO) {
-        converter = kernel::csr2coo<T>;
+        const int ncols = dims[1];
+        converter = [ncols] (Param<T> ov, Param<int> orow, Param<int> ocol,
+                             CParam<T> iv, CParam<int> irow, CParam<int> icol) {
+            kernel::csr2coo<T>(ov, orow, ocol, iv, irow, icol, ncols);
+        };
     } else if (src == AF_STORAGE_COO && dest == AF_STORAGE_CSR) {
         converter = kernel::coo2csr<T>;
     } else {
         // Should never come here
         AF_ERROR("CPU Backend invalid conversion combination", AF_ERR_NOT_SUPPORTED);
     }
-    getQueue().enqueue(converter, converted.getValues(),
-                       converted.getRowIdx(), converted.getColIdx(),
+    getQueue().enqueue(converter, values, rowIdx, colIdx,
                        in.getValues(), in.getRowIdx(), in.getColIdx());
-    return converted;
+
+    return createArrayDataSparseArray<T>(dims, values, rowIdx, colIdx, dest);
 }
 
 #define INSTANTIATE_TO_STORAGE(T, S)                                                                \
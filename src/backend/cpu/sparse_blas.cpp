@@ -14,20 +14,28 @@
 #endif
 
 #include <af/dim4.hpp>
+#include <kernel/spgemm.hpp>
 #include <complex.hpp>
 #include <common/complex.hpp>
 #include <common/err_common.hpp>
 #include <math.hpp>
+#include <parallel.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <types.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 #include <cassert>
+#include <memory>
+#include <vector>
 
 namespace cpu {
 
+using common::SparseArray;
+using common::createArrayDataSparseArray;
+
 #ifdef USE_MKL
 using sp_cfloat = MKL_Complex8;
 using sp_cdouble = MKL_Complex16;
@@ -319,131 +327,140 @@ cdouble getConjugate(const cdouble &in)
     return std::conj(in);
 }
 
+// Smallest number of nonzeros a thread is handed
+static const dim_t SPMV_GRAIN = 1 << 15;
+
+// Product of row i of the CSR matrix with the dense vector right. The four
+// independent partial sums keep the loads of the gathered elements of right
+// in flight.
 template<typename T, bool conjugate>
-void mv(Param<T> output,
-        CParam<T> values,
-        CParam<int> rowIdx,
-        CParam<int> colIdx,
-        CParam<T> right,
-        int M)
+T csrRowDot(const T *valPtr, const int *colPtr, const T *rightPtr,
+            const int begin, const int end)
 {
-    UNUSED(M);
-    const T   *valPtr = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T   *rightPtr = right.get();
-
-    T* outPtr = output.get();
+    T s0 = scalar<T>(0), s1 = scalar<T>(0), s2 = scalar<T>(0), s3 = scalar<T>(0);
+    int j = begin;
+    for (; j + 4 <= end; j += 4) {
+        T v0 = valPtr[j + 0], v1 = valPtr[j + 1], v2 = valPtr[j + 2], v3 = valPtr[j + 3];
+        if (conjugate) {
+            v0 = getConjugate(v0); v1 = getConjugate(v1);
+            v2 = getConjugate(v2); v3 = getConjugate(v3);
+        }
+        s0 += v0 * rightPtr[colPtr[j + 0]];
+        s1 += v1 * rightPtr[colPtr[j + 1]];
+        s2 += v2 * rightPtr[colPtr[j + 2]];
+        s3 += v3 * rightPtr[colPtr[j + 3]];
+    }
+    for (; j < end; ++j) {
+        s0 += (conjugate ? getConjugate(valPtr[j]) : valPtr[j]) * rightPtr[colPtr[j]];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
 
-    for (int i = 0; i < rowIdx.dims(0)-1; ++i) {
-        outPtr[i] = scalar<T>(0);
+// Adds right[i] times row i of the CSR matrix to out, for the rows in
+// [begin, end)
+template<typename T, bool conjugate>
+void csrScatter(T *outPtr, const T *valPtr, const int *rowPtr, const int *colPtr,
+                const T *rightPtr, const dim_t begin, const dim_t end)
+{
+    for (dim_t i = begin; i < end; ++i) {
+        const T r = rightPtr[i];
         for (int j = rowPtr[i]; j < rowPtr[i+1]; ++j) {
-            //If stride[0] of right is not 1 then rightPtr[colPtr[j]*stride]
-            if (conjugate) {
-                outPtr[i] += getConjugate(valPtr[j]) * rightPtr[colPtr[j]];
-            } else {
-                outPtr[i] += valPtr[j] * rightPtr[colPtr[j]];
-            }
+            outPtr[colPtr[j]] += (conjugate ? getConjugate(valPtr[j]) : valPtr[j]) * r;
         }
     }
 }
 
+// The rows are split across the threads so that they all get the same
+// number of nonzeros
+template<typename T, bool conjugate>
+void mv(T *outPtr, const T *valPtr, const int *rowPtr, const int *colPtr,
+        const T *rightPtr, const int nRows)
+{
+    parallelForWeighted(rowPtr, nRows, SPMV_GRAIN, [&](dim_t begin, dim_t end) {
+        for (dim_t i = begin; i < end; ++i) {
+            outPtr[i] = csrRowDot<T, conjugate>(valPtr, colPtr, rightPtr,
+                                                rowPtr[i], rowPtr[i+1]);
+        }
+    });
+}
+
+// Number of private buffers of M elements mtv scatters the nNZ nonzeros to
+static inline unsigned mtvChunks(const dim_t nNZ)
+{
+    return getNumChunks(std::max(nNZ, (dim_t)1), SPMV_GRAIN);
+}
+
+// Every thread zeroes a private buffer and scatters its share of the rows to
+// it. The buffers are then added, in order, one slice of the output per thread.
+// buffers holds mtvChunks(nNZ) * M elements and is unused when there is one.
 template<typename T, bool conjugate>
-void mtv(Param<T> output,
-         CParam<T> values,
-         CParam<int> rowIdx,
-         CParam<int> colIdx,
-         CParam<T> right,
-         int M)
+void mtv(T *outPtr, const T *valPtr, const int *rowPtr, const int *colPtr,
+         const T *rightPtr, const int nRows, const int M, T *buffers)
 {
-    const T *valPtr = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-    T* outPtr = output.get();
-
-    for (int i = 0; i < M; ++i) {
-        outPtr[i] = scalar<T>(0);
+    const unsigned nchunks = mtvChunks(rowPtr[nRows]);
+    if (nchunks == 1) {
+        std::fill(outPtr, outPtr + M, scalar<T>(0));
+        csrScatter<T, conjugate>(outPtr, valPtr, rowPtr, colPtr, rightPtr, 0, nRows);
+        return;
     }
 
-    for (int i = 0; i < rowIdx.dims(0)-1; ++i) {
-        for (int j = rowPtr[i]; j < rowPtr[i+1]; ++j) {
-            //If stride[0] of right is not 1 then rightPtr[i*stride]
-            if (conjugate) {
-                outPtr[colPtr[j]] += getConjugate(valPtr[j]) * rightPtr[i];
-            } else {
-                outPtr[colPtr[j]] += valPtr[j] * rightPtr[i];
-            }
+    parallelTasks(nchunks, [&](unsigned chunk) {
+        dim_t begin, end;
+        weightedChunkRange(rowPtr, nRows, nchunks, chunk, begin, end);
+        T *buffer = buffers + (size_t)chunk * M;
+        std::fill(buffer, buffer + M, scalar<T>(0));
+        csrScatter<T, conjugate>(buffer, valPtr, rowPtr, colPtr, rightPtr, begin, end);
+    });
+
+    parallelFor(M, SPMV_GRAIN / nchunks, [&](dim_t begin, dim_t end) {
+        for (dim_t i = begin; i < end; ++i) {
+            T sum = buffers[i];
+            for (unsigned c = 1; c < nchunks; ++c) sum += buffers[(size_t)c * M + i];
+            outPtr[i] = sum;
         }
-    }
+    });
 }
 
 template<typename T, bool conjugate>
-void mm(Param<T> output,
-        CParam<T> values,
-        CParam<int> rowIdx,
-        CParam<int> colIdx,
-        CParam<T> right,
-        int M, int N,
-        int ldb, int ldc)
+void mm(T *outPtr, const T *valPtr, const int *rowPtr, const int *colPtr,
+        const T *rightPtr, const int nRows, const int N, const int ldb, const int ldc)
 {
-    UNUSED(M);
-    const T *valPtr = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-    T *outPtr = output.get();
-
-    for (int o = 0; o < N; ++o) {
-        for (int i = 0; i < rowIdx.dims(0)-1; ++i) {
-            outPtr[i] = scalar<T>(0);
-            for (int j = rowPtr[i]; j < rowPtr[i+1]; ++j) {
-                //If stride[0] of right is not 1 then rightPtr[colPtr[j]*stride]
-                if (conjugate) {
-                    outPtr[i] += getConjugate(valPtr[j]) * rightPtr[colPtr[j]];
-                } else {
-                    outPtr[i] += valPtr[j] * rightPtr[colPtr[j]];
-                }
+    parallelForWeighted(rowPtr, nRows, SPMV_GRAIN / N + 1, [&](dim_t begin, dim_t end) {
+        for (int o = 0; o < N; ++o) {
+            const T *right = rightPtr + (dim_t)o * ldb;
+            T *out = outPtr + (dim_t)o * ldc;
+            for (dim_t i = begin; i < end; ++i) {
+                out[i] = csrRowDot<T, conjugate>(valPtr, colPtr, right,
+                                                 rowPtr[i], rowPtr[i+1]);
             }
         }
-        rightPtr += ldb;
-        outPtr += ldc;
-    }
+    });
 }
 
+// Columns of the output are independent, they are handed to the threads
+// whole when there are enough of them. Otherwise they are computed one after
+// the other by mtv, which uses buffers.
 template<typename T, bool conjugate>
-void mtm(Param<T> output,
-         CParam<T> values,
-         CParam<int> rowIdx,
-         CParam<int> colIdx,
-         CParam<T> right,
-         int M, int N,
-         int ldb, int ldc)
+void mtm(T *outPtr, const T *valPtr, const int *rowPtr, const int *colPtr,
+         const T *rightPtr, const int nRows, const int M, const int N,
+         const int ldb, const int ldc, T *buffers)
 {
-    const T *valPtr = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-    T *outPtr = output.get();
-
-    for (int o = 0; o < N; ++o) {
-        for (int i = 0; i < M; ++i) {
-            outPtr[i] = scalar<T>(0);
+    if ((unsigned)N < getNumThreads()) {
+        for (int o = 0; o < N; ++o) {
+            mtv<T, conjugate>(outPtr + (dim_t)o * ldc, valPtr, rowPtr, colPtr,
+                              rightPtr + (dim_t)o * ldb, nRows, M, buffers);
         }
+        return;
+    }
 
-        for (int i = 0; i < rowIdx.dims(0)-1; ++i) {
-            for (int j = rowPtr[i]; j < rowPtr[i+1]; ++j) {
-                //If stride[0] of right is not 1 then rightPtr[i*stride]
-                if (conjugate) {
-                    outPtr[colPtr[j]] += getConjugate(valPtr[j]) * rightPtr[i];
-                } else {
-                    outPtr[colPtr[j]] += valPtr[j] * rightPtr[i];
-                }
-            }
+    parallelFor(N, 1, [&](dim_t begin, dim_t end) {
+        for (dim_t o = begin; o < end; ++o) {
+            T *out = outPtr + o * ldc;
+            std::fill(out, out + M, scalar<T>(0));
+            csrScatter<T, conjugate>(out, valPtr, rowPtr, colPtr,
+                                     rightPtr + o * ldb, 0, nRows);
         }
-        rightPtr += ldb;
-        outPtr += ldc;
-    }
+    });
 }
 
 template<typename T>
@@ -469,29 +486,48 @@ Array<T> matmul(const common::SparseArray<T> lhs, const Array<T> rhs,
     Array<T> out = createValueArray<T>(af::dim4(M, N, 1, 1), scalar<T>(0));
     out.eval();
 
+    // The transposed products scatter to private buffers when they split the
+    // rows of lhs across the threads. They come from the memory manager
+    // uninitialized and are zeroed by the threads that use them.
+    const unsigned nchunks = mtvChunks(lhs.getNNZ());
+    const bool scatter = lOpts != SPARSE_OPERATION_NON_TRANSPOSE &&
+                         (unsigned)N < getNumThreads() && nchunks > 1;
+    Array<T> buffers = createEmptyArray<T>(af::dim4(scatter ? (dim_t)M * nchunks : 0));
+
     auto func = [=] (Param<T> output,
                      CParam<T> values,
                      CParam<int> rowIdx,
                      CParam<int> colIdx,
-                     CParam<T> right) {
+                     CParam<T> right,
+                     Param<T> scratch) {
         int ldb = right.strides(1);
         int ldc = output.strides(1);
 
+        const T   *valPtr   = values.get();
+        const int *rowPtr   = rowIdx.get();
+        const int *colPtr   = colIdx.get();
+        const T   *rightPtr = right.get();
+        T         *outPtr   = output.get();
+        T         *bufPtr   = scratch.get();
+        const int nRows     = rowIdx.dims(0) - 1;
+
         if(rDims[rColDim] == 1) {
             if (lOpts == SPARSE_OPERATION_NON_TRANSPOSE) {
-                mv<T, false>(output, values, rowIdx, colIdx, right, M);
+                mv<T, false>(outPtr, valPtr, rowPtr, colPtr, rightPtr, nRows);
             } else if (lOpts == SPARSE_OPERATION_TRANSPOSE) {
-                mtv<T, false>(output, values, rowIdx, colIdx, right, M);
+                mtv<T, false>(outPtr, valPtr, rowPtr, colPtr, rightPtr, nRows, M, bufPtr);
             } else if (lOpts == SPARSE_OPERATION_CONJUGATE_TRANSPOSE) {
-                mtv<T, true>(output, values, rowIdx, colIdx, right, M);
+                mtv<T, true>(outPtr, valPtr, rowPtr, colPtr, rightPtr, nRows, M, bufPtr);
             }
         } else {
             if (lOpts == SPARSE_OPERATION_NON_TRANSPOSE) {
-                mm<T, false>(output, values, rowIdx, colIdx, right, M, N, ldb, ldc);
+                mm<T, false>(outPtr, valPtr, rowPtr, colPtr, rightPtr, nRows, N, ldb, ldc);
             } else if (lOpts == SPARSE_OPERATION_TRANSPOSE) {
-                mtm<T, false>(output, values, rowIdx, colIdx, right, M, N, ldb, ldc);
+                mtm<T, false>(outPtr, valPtr, rowPtr, colPtr, rightPtr, nRows, M, N, ldb, ldc,
+                              bufPtr);
             } else if (lOpts == SPARSE_OPERATION_CONJUGATE_TRANSPOSE) {
-                mtm<T, true>(output, values, rowIdx, colIdx, right, M, N, ldb, ldc);
+                mtm<T, true>(outPtr, valPtr, rowPtr, colPtr, rightPtr, nRows, M, N, ldb, ldc,
+                             bufPtr);
             }
         }
     };
@@ -500,16 +536,67 @@ Array<T> matmul(const common::SparseArray<T> lhs, const Array<T> rhs,
     const Array<int> rowIdx = lhs.getRowIdx();
     const Array<int> colIdx = lhs.getColIdx();
 
-    getQueue().enqueue(func, out, values, rowIdx, colIdx, rhs);
+    getQueue().enqueue(func, out, values, rowIdx, colIdx, rhs, buffers);
 
     return out;
 }
 
 #endif // #if USE_MKL
 
+template<typename T>
+SparseArray<T> matmul(const SparseArray<T> lhs, const SparseArray<T> rhs,
+                      af_mat_prop optLhs, af_mat_prop optRhs)
+{
+    UNUSED(optLhs);
+    UNUSED(optRhs);
+    lhs.eval();
+    rhs.eval();
+
+    const int M = lhs.dims()[0];
+    const int N = rhs.dims()[1];
+
+    // Number of partial products of every row, shared by both phases
+    auto flops = std::make_shared<std::vector<dim_t> >();
+
+    auto symbolic = [=] (Param<int> oRowIdx,
+                         CParam<int> aRowIdx, CParam<int> aColIdx,
+                         CParam<int> bRowIdx, CParam<int> bColIdx) {
+        kernel::spgemmFlops(*flops, M, aRowIdx.get(), aColIdx.get(), bRowIdx.get());
+        kernel::spgemmRowIdx<T>(oRowIdx, *flops, aRowIdx, aColIdx, bRowIdx, bColIdx, N);
+    };
+
+    Array<int> rowIdx = createEmptyArray<int>(dim4(M + 1));
+    getQueue().enqueue(symbolic, rowIdx,
+                       lhs.getRowIdx(), lhs.getColIdx(),
+                       rhs.getRowIdx(), rhs.getColIdx());
+
+    // The output is sized by the symbolic phase
+    getQueue().sync();
+    const int nNZ = rowIdx.get()[M];
+
+    auto numeric = [=] (Param<T> oValues, Param<int> oColIdx, CParam<int> oRowIdx,
+                        CParam<T> aValues, CParam<int> aRowIdx, CParam<int> aColIdx,
+                        CParam<T> bValues, CParam<int> bRowIdx, CParam<int> bColIdx) {
+        kernel::spgemm<T>(oValues, oColIdx, oRowIdx, *flops,
+                          aValues, aRowIdx, aColIdx,
+                          bValues, bRowIdx, bColIdx, N);
+    };
+
+    Array<T  > values = createEmptyArray<T>(dim4(nNZ));
+    Array<int> colIdx = createEmptyArray<int>(dim4(nNZ));
+    getQueue().enqueue(numeric, values, colIdx, rowIdx,
+                       lhs.getValues(), lhs.getRowIdx(), lhs.getColIdx(),
+                       rhs.getValues(), rhs.getRowIdx(), rhs.getColIdx());
+
+    return createArrayDataSparseArray<T>(dim4(M, N), values, rowIdx, colIdx,
+                                         AF_STORAGE_CSR);
+}
+
 #define INSTANTIATE_SPARSE(T)                                                           \
     template Array<T> matmul<T>(const common::SparseArray<T> lhs, const Array<T> rhs,   \
                                 af_mat_prop optLhs, af_mat_prop optRhs);                \
+    template SparseArray<T> matmul<T>(const SparseArray<T> lhs, const SparseArray<T> rhs, \
+                                      af_mat_prop optLhs, af_mat_prop optRhs);          \
 
 
 INSTANTIATE_SPARSE(float)
@@ -39,7 +39,28 @@ template<typename T>
 void transpose_inplace(Array<T> &in, const bool conjugate)
 {
     in.eval();
-    getQueue().enqueue(kernel::transpose_inplace<T>, in, conjugate);
+
+    // Rectangular matrices are permuted in place only when they are contiguous
+    const dim4 inDims = in.dims();
+    if (inDims[0] != inDims[1] && !in.isLinear()) {
+        in = transpose<T>(in, conjugate);
+        return;
+    }
+
+    // Large rectangular matrices go through a scratch matrix from the memory
+    // manager, one at a time, so that all the threads can share each of them
+    if (inDims[0] != inDims[1] &&
+        inDims[0] * inDims[1] > kernel::TRANSPOSE_INPLACE_MAX) {
+        Array<T> scratch = createEmptyArray<T>(dim4(inDims[1], inDims[0]));
+        getQueue().enqueue(kernel::transpose_inplace_scratch<T>, in, scratch, conjugate);
+    } else {
+        getQueue().enqueue(kernel::transpose_inplace<T>, in, conjugate);
+    }
+
+    // Use modDims instead of setDataDims to only modify the ArrayInfo
+    if (inDims[0] != inDims[1]) {
+        in.modDims(dim4(inDims[1], inDims[0], inDims[2], inDims[3]));
+    }
 }
 
 #define INSTANTIATE(T)                                                      \
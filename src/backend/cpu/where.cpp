@@ -15,6 +15,10 @@
 #include <ops.hpp>
 #include <vector>
 #include <platform.hpp>
+#include <queue.hpp>
+#include <kernel/where.hpp>
+#include <algorithm>
+#include <functional>
 
 using af::dim4;
 
@@ -24,39 +28,17 @@ namespace cpu
 template<typename T>
 Array<uint> where(const Array<T> &in)
 {
-    in.eval();
     getQueue().sync();
 
-    const dim_t *dims    = in.dims().get();
-    const dim_t *strides = in.strides().get();
-    static const T zero = scalar<T>(0);
-
-    const T *iptr = in.get();
-    auto out_vec  = memAlloc<uint>(in.elements());
-
-    dim_t count = 0;
-    dim_t idx = 0;
-    for (dim_t w = 0; w < dims[3]; w++) {
-        uint offw = w * strides[3];
-
-        for (dim_t z = 0; z < dims[2]; z++) {
-            uint offz = offw + z * strides[2];
-
-            for (dim_t y = 0; y < dims[1]; y++) {
-                uint offy = y * strides[1] + offz;
-
-                for (dim_t x = 0; x < dims[0]; x++) {
-
-                    T val = iptr[offy + x];
-                    if (val != zero) {
-                        out_vec[count] = idx;
-                        count++;
-                    }
-                    idx++;
-                }
-            }
-        }
-    }
+    // Conditions which are not evaluated yet are compacted directly from
+    // the JIT tree so that the boolean array is never created
+    std::unique_ptr<uint[], std::function<void(uint *)>> out_vec;
+    auto alloc = [&](dim_t total) {
+        out_vec = memAlloc<uint>(std::max(total, dim_t(1)));
+        return out_vec.get();
+    };
+    dim_t count = in.isReady() ? kernel::where<T>(in, alloc)
+                               : kernel::where<T>(in.getNode(), in.dims(), alloc);
 
     Array<uint> out = createDeviceDataArray<uint>(dim4(count), out_vec.get());
     out_vec.release();
@@ -14,6 +14,7 @@
 
 #include <stdexcept>
 #include <string>
+#include <vector>
 #include <cassert>
 #include <math.hpp>
 #include <common/err_common.hpp>
@@ -22,6 +23,10 @@
 #include <arith.hpp>
 #include <reduce.hpp>
 #include <complex.hpp>
+#include <copy.hpp>
+#include <tile.hpp>
+#include <unary.hpp>
+#include <common/igemm.hpp>
 
 namespace cuda
 {
@@ -282,14 +287,87 @@ Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
 
 }
 
+template<typename T>
+void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+          const T alpha, const Array<T> &lhs, const Array<T> &rhs,
+          const T beta, const Array<T> &bias, const af_activation act)
+{
+    // The scaling, bias and activation are applied by a single JIT kernel
+    const dim4 oDims = out.dims();
+    Array<T> res = arithOp<T, af_mul_t>(matmul<T>(lhs, rhs, optLhs, optRhs),
+                                        createValueArray<T>(oDims, alpha), oDims);
+    if (beta != T(0)) {
+        res = arithOp<T, af_add_t>(res, arithOp<T, af_mul_t>(out, createValueArray<T>(oDims, beta),
+                                                             oDims), oDims);
+    }
+    if (bias.elements() > 0) {
+        const bool rowBias = bias.dims()[0] == oDims[0] && bias.elements() == oDims[0];
+        const dim4 tileDims(rowBias ? 1 : oDims[0], rowBias ? oDims[1] : 1, oDims[2], oDims[3]);
+        res = arithOp<T, af_add_t>(res, tile<T>(bias, tileDims), oDims);
+    }
+    switch (act) {
+    case AF_ACTIVATION_RELU:
+        res = arithOp<T, af_max_t>(res, createValueArray<T>(oDims, scalar<T>(0)), oDims); break;
+    case AF_ACTIVATION_SIGMOID: res = unaryOp<T, af_sigmoid_t>(res); break;
+    case AF_ACTIVATION_TANH:    res = unaryOp<T, af_tanh_t>(res);    break;
+    default: break;
+    }
+    out = res;
+}
+
+// cuBLAS and clBLAS have no integer matrix multiply, so the blocked host
+// kernel is used
+template<typename Ti, typename To>
+Array<To> integerMatmul(const Array<Ti> &lhs, const Array<Ti> &rhs,
+                        af_mat_prop optLhs, af_mat_prop optRhs,
+                        const int lhsZero, const int rhsZero)
+{
+    const bool lTrans = optLhs != AF_MAT_NONE;
+    const bool rTrans = optRhs != AF_MAT_NONE;
+
+    const dim4 lDims = lhs.dims();
+    const dim4 rDims = rhs.dims();
+    const dim4 oDims(lDims[lTrans ? 1 : 0], rDims[rTrans ? 0 : 1],
+                     std::max(lDims[2], rDims[2]), std::max(lDims[3], rDims[3]));
+
+    std::vector<Ti> hlhs(lhs.elements()), hrhs(rhs.elements());
+    std::vector<To> hout(oDims.elements());
+    copyData(hlhs.data(), lhs);
+    copyData(hrhs.data(), rhs);
+
+    auto strides = [](const dim4 &dims) {
+        return dim4(1, dims[0], dims[0] * dims[1], dims[0] * dims[1] * dims[2]);
+    };
+    common::igemm(hout.data(), oDims, strides(oDims),
+                  hlhs.data(), lDims, strides(lDims), lTrans, lhsZero,
+                  hrhs.data(), rDims, strides(rDims), rTrans, rhsZero);
+
+    return createHostDataArray<To>(oDims, hout.data());
+}
+
 template<typename T>
 Array<T> dot(const Array<T> &lhs, const Array<T> &rhs,
              af_mat_prop optLhs, af_mat_prop optRhs)
 {
-    const Array<T> lhs_ = (optLhs == AF_MAT_NONE ? lhs : conj<T>(lhs));
-    const Array<T> rhs_ = (optRhs == AF_MAT_NONE ? rhs : conj<T>(rhs));
+    Array<T> lhs_ = (optLhs == AF_MAT_NONE ? lhs : conj<T>(lhs));
+    Array<T> rhs_ = (optRhs == AF_MAT_NONE ? rhs : conj<T>(rhs));
+
+    // A side with a single column, or matrix, is paired with every column of
+    // the other one
+    const dim4 lDims = lhs_.dims();
+    const dim4 rDims = rhs_.dims();
+    const dim4 oDims(lDims[0], std::max(lDims[1], rDims[1]),
+                     std::max(lDims[2], rDims[2]), std::max(lDims[3], rDims[3]));
+    if (lDims != oDims) {
+        lhs_ = tile<T>(lhs_, dim4(1, oDims[1] / lDims[1],
+                                  oDims[2] / lDims[2], oDims[3] / lDims[3]));
+    }
+    if (rDims != oDims) {
+        rhs_ = tile<T>(rhs_, dim4(1, oDims[1] / rDims[1],
+                                  oDims[2] / rDims[2], oDims[3] / rDims[3]));
+    }
 
-    const Array<T> temp = arithOp<T, af_mul_t>(lhs_, rhs_, lhs_.dims());
+    const Array<T> temp = arithOp<T, af_mul_t>(lhs_, rhs_, oDims);
     return reduce<af_add_t, T, T>(temp, 0, false, 0);
 }
 
@@ -329,6 +407,29 @@ INSTANTIATE_BLAS(cfloat)
 INSTANTIATE_BLAS(double)
 INSTANTIATE_BLAS(cdouble)
 
+#define INSTANTIATE_GEMM(TYPE)                                                          \
+    template void gemm<TYPE>(Array<TYPE> &out, af_mat_prop optLhs, af_mat_prop optRhs,  \
+                             const TYPE alpha, const Array<TYPE> &lhs,                  \
+                             const Array<TYPE> &rhs, const TYPE beta,                   \
+                             const Array<TYPE> &bias, const af_activation act);
+
+INSTANTIATE_GEMM(float)
+INSTANTIATE_GEMM(double)
+
+#define INSTANTIATE_INTEGER_BLAS(Ti, To)                                                \
+    template Array<To> integerMatmul<Ti, To>(const Array<Ti> &lhs, const Array<Ti> &rhs, \
+                                             af_mat_prop optLhs, af_mat_prop optRhs,   \
+                                             const int lhsZero, const int rhsZero);
+
+INSTANTIATE_INTEGER_BLAS(uchar , intl )
+INSTANTIATE_INTEGER_BLAS(uchar , uint )
+INSTANTIATE_INTEGER_BLAS(short , intl )
+INSTANTIATE_INTEGER_BLAS(ushort, uintl)
+INSTANTIATE_INTEGER_BLAS(int   , int  )
+INSTANTIATE_INTEGER_BLAS(uint  , uint )
+INSTANTIATE_INTEGER_BLAS(intl  , intl )
+INSTANTIATE_INTEGER_BLAS(uintl , uintl)
+
 #define INSTANTIATE_DOT(TYPE)                                                           \
     template Array<TYPE> dot<TYPE>(const Array<TYPE> &lhs, const Array<TYPE> &rhs,      \
                                    af_mat_prop optLhs, af_mat_prop optRhs);
@@ -16,6 +16,20 @@ template<typename T>
 Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs,
                 af_mat_prop optLhs, af_mat_prop optRhs);
 
+// out = act(alpha * op(lhs) * op(rhs) + beta * out + bias), where bias is
+// empty, or a vector broadcast along the rows or the columns of the output
+template<typename T>
+void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs,
+          const T alpha, const Array<T> &lhs, const Array<T> &rhs,
+          const T beta, const Array<T> &bias, const af_activation act);
+
+// Integer matrix multiply of (op(lhs) - lhsZero) and (op(rhs) - rhsZero),
+// accumulated in To
+template<typename Ti, typename To>
+Array<To> integerMatmul(const Array<Ti> &lhs, const Array<Ti> &rhs,
+                        af_mat_prop optLhs, af_mat_prop optRhs,
+                        const int lhsZero, const int rhsZero);
+
 template<typename T>
 Array<T> dot(const Array<T> &lhs, const Array<T> &rhs,
              af_mat_prop optLhs, af_mat_prop optRhs);
@@ -103,6 +103,10 @@ void convertPivot(Array<int> &pivot, int out_sz)
 template<typename T>
 void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot, const Array<T> &in)
 {
+    if (in.ndims() > 2) {
+        AF_ERROR("lu can not be used in batch mode on CUDA", AF_ERR_BATCH);
+    }
+
     dim4 iDims = in.dims();
     int M = iDims[0];
     int N = iDims[1];
@@ -121,6 +125,10 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot, const Array<T> &in)
 template<typename T>
 Array<int> lu_inplace(Array<T> &in, const bool convert_pivot)
 {
+    if (in.ndims() > 2) {
+        AF_ERROR("lu can not be used in batch mode on CUDA", AF_ERR_BATCH);
+    }
+
     dim4 iDims = in.dims();
     int M = iDims[0];
     int N = iDims[1];
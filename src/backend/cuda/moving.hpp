@@ -0,0 +1,20 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+
+namespace cuda
+{
+// Computes the statistic stat, one of AF_STAT_MIN, AF_STAT_MAX, AF_STAT_SUM,
+// AF_STAT_MEAN or AF_STAT_VAR, of every window of window elements along dim.
+// Windows start every step elements and lie entirely inside the input.
+template<typename Ti, typename To>
+Array<To> moving(const Array<Ti> &in, const af_stat_type stat, const dim_t window,
+                 const dim_t step, const af_var_bias bias, const int dim);
+}
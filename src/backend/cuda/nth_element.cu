@@ -0,0 +1,47 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <nth_element.hpp>
+#include <lookup.hpp>
+#include <sort.hpp>
+
+using af::dim4;
+using std::vector;
+
+namespace cuda
+{
+
+template<typename T>
+Array<T> nthElement(const Array<T> &in, const unsigned dim,
+                    const vector<dim_t> &ranks)
+{
+    vector<uint> idx(ranks.begin(), ranks.end());
+    Array<uint> indices = createHostDataArray<uint>(dim4(idx.size()), idx.data());
+
+    Array<T> sorted = sort<T>(in, dim, true);
+    return lookup<T, uint>(sorted, indices, dim);
+}
+
+#define INSTANTIATE(T)                                                  \
+    template Array<T> nthElement<T>(const Array<T> &in, const unsigned dim, \
+                                    const vector<dim_t> &ranks);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(char)
+INSTANTIATE(uchar)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+INSTANTIATE(intl)
+INSTANTIATE(uintl)
+
+}
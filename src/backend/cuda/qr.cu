@@ -122,6 +122,10 @@ MQR_FUNC(mqr , cdouble, Zunmqr)
 template<typename T>
 void qr(Array<T> &q, Array<T> &r, Array<T> &t, const Array<T> &in)
 {
+    if (in.ndims() > 2) {
+        AF_ERROR("qr can not be used in batch mode on CUDA", AF_ERR_BATCH);
+    }
+
     dim4 iDims = in.dims();
     int M = iDims[0];
     int N = iDims[1];
@@ -175,6 +179,10 @@ void qr(Array<T> &q, Array<T> &r, Array<T> &t, const Array<T> &in)
 template<typename T>
 Array<T> qr_inplace(Array<T> &in)
 {
+    if (in.ndims() > 2) {
+        AF_ERROR("qr can not be used in batch mode on CUDA", AF_ERR_BATCH);
+    }
+
     dim4 iDims = in.dims();
     int M = iDims[0];
     int N = iDims[1];
@@ -20,6 +20,7 @@
 #include <thrust/sort.h>
 #include <thrust/unique.h>
 #include <thrust/set_operations.h>
+#include <thrust/binary_search.h>
 
 namespace cuda
 {
@@ -106,10 +107,32 @@ namespace cuda
         return out;
     }
 
+    template<typename T>
+    Array<char> isIn(const Array<T> &in, const Array<T> &set)
+    {
+        // Every element is looked up in the sorted distinct values of set
+        Array<T> values = setUnique<T>(set, false);
+        Array<T> input  = copyArray<T>(in);
+        Array<char> out = createEmptyArray<char>(in.dims());
+
+        thrust::device_ptr<T> values_ptr = thrust::device_pointer_cast<T>(values.get());
+        thrust::device_ptr<T> values_ptr_end = values_ptr + values.elements();
+
+        thrust::device_ptr<T> in_ptr = thrust::device_pointer_cast<T>(input.get());
+        thrust::device_ptr<T> in_ptr_end = in_ptr + input.elements();
+
+        thrust::device_ptr<char> out_ptr = thrust::device_pointer_cast<char>(out.get());
+
+        THRUST_SELECT(thrust::binary_search, values_ptr, values_ptr_end, in_ptr, in_ptr_end, out_ptr);
+
+        return out;
+    }
+
 #define INSTANTIATE(T)                                                  \
     template Array<T> setUnique<T>(const Array<T> &in, const bool is_sorted); \
     template Array<T> setUnion<T>(const Array<T> &first, const Array<T> &second, const bool is_unique); \
     template Array<T> setIntersect<T>(const Array<T> &first, const Array<T> &second, const bool is_unique); \
+    template Array<char> isIn<T>(const Array<T> &in, const Array<T> &set); \
 
     INSTANTIATE(float)
     INSTANTIATE(double)
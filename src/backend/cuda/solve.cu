@@ -12,6 +12,7 @@
 
 #include <platform.hpp>
 #include <cublas_v2.h>
+#include <diagonal.hpp>
 #include <identity.hpp>
 #include <memory.hpp>
 #include <copy.hpp>
@@ -23,8 +24,10 @@
 #include <blas.hpp>
 #include <lu.hpp>
 #include <qr.hpp>
+#include <reduce.hpp>
 
 #include <cstdio>
+#include <limits>
 
 namespace cuda
 {
@@ -196,6 +199,12 @@ Array<T> generalSolve(const Array<T> &a, const Array<T> &b)
     Array<T> B = copyArray<T>(b);
     Array<int> pivot = lu_inplace(A, false);
 
+    // getrf reports a singular matrix on the device only, so look for a zero
+    // on the diagonal of U. As on the host, the solution is then NaN
+    if (reduce_all<af_notzero_t, T, uint>(diagExtract<T>(A, 0)) < (uint)N) {
+        return createValueArray<T>(B.dims(), scalar<T>(std::numeric_limits<double>::quiet_NaN()));
+    }
+
     auto info = memAlloc<int>(1);
 
     CUSOLVER_CHECK(getrs_func<T>()(solverDnHandle(),
@@ -346,6 +355,10 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b, const af_mat_prop o
 template<typename T>
 Array<T> solve(const Array<T> &a, const Array<T> &b, const af_mat_prop options)
 {
+    if (a.ndims() > 2) {
+        AF_ERROR("solve can not be used in batch mode on CUDA", AF_ERR_BATCH);
+    }
+
     if (options & AF_MAT_UPPER ||
         options & AF_MAT_LOWER) {
         return triangleSolve<T>(a, b, options);
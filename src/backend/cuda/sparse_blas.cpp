@@ -185,9 +185,24 @@ Array<T> matmul(const common::SparseArray<T> lhs, const Array<T> rhs,
     return out;
 }
 
+template<typename T>
+common::SparseArray<T> matmul(const common::SparseArray<T> lhs,
+                              const common::SparseArray<T> rhs,
+                              af_mat_prop optLhs, af_mat_prop optRhs)
+{
+    UNUSED(lhs);
+    UNUSED(rhs);
+    UNUSED(optLhs);
+    UNUSED(optRhs);
+    AF_ERROR("CUDA Backend does not support sparse-sparse matmul", AF_ERR_NOT_SUPPORTED);
+}
+
 #define INSTANTIATE_SPARSE(T)                                                           \
     template Array<T> matmul<T>(const common::SparseArray<T> lhs, const Array<T> rhs,   \
                                 af_mat_prop optLhs, af_mat_prop optRhs);                \
+    template common::SparseArray<T> matmul<T>(const common::SparseArray<T> lhs,         \
+                                              const common::SparseArray<T> rhs,         \
+                                              af_mat_prop optLhs, af_mat_prop optRhs);  \
 
 
 INSTANTIATE_SPARSE(float)
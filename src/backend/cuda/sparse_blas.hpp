@@ -17,5 +17,11 @@ template<typename T>
 Array<T> matmul(const common::SparseArray<T> lhs, const Array<T> rhs,
                 af_mat_prop optLhs, af_mat_prop optRhs);
 
+// Product of two CSR arrays, in CSR storage
+template<typename T>
+common::SparseArray<T> matmul(const common::SparseArray<T> lhs,
+                              const common::SparseArray<T> rhs,
+                              af_mat_prop optLhs, af_mat_prop optRhs);
+
 }
 
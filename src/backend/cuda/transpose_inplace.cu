@@ -20,6 +20,13 @@ namespace cuda
 template<typename T>
 void transpose_inplace(Array<T> &in, const bool conjugate)
 {
+    // The kernels swap square tiles, rectangular matrices go through a copy
+    const dim4 inDims = in.dims();
+    if (inDims[0] != inDims[1]) {
+        in = transpose<T>(in, conjugate);
+        return;
+    }
+
     if(conjugate)   { kernel::transpose_inplace<T, true >(in); }
     else            { kernel::transpose_inplace<T, false>(in); }
 }
@@ -24,7 +24,8 @@ namespace opencl
 template<typename T>
 int cholesky_inplace(Array<T> &in, const bool is_upper)
 {
-    if(OpenCLCPUOffload()) {
+    // Batches of matrices are factorized on the host
+    if(OpenCLCPUOffload() || in.ndims() > 2) {
         return cpu::cholesky_inplace(in, is_upper);
     }
 
@@ -44,7 +45,7 @@ int cholesky_inplace(Array<T> &in, const bool is_upper)
 template<typename T>
 Array<T> cholesky(int *info, const Array<T> &in, const bool is_upper)
 {
-    if(OpenCLCPUOffload()) {
+    if(OpenCLCPUOffload() || in.ndims() > 2) {
         return cpu::cholesky(info, in, is_upper);
     }
 
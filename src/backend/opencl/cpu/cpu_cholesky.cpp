@@ -63,8 +63,20 @@ int cholesky_inplace(Array<T> &in, const bool is_upper)
 
     std::shared_ptr<T> inPtr = in.getMappedPtr();
 
-    int info = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo,
-                               N, inPtr.get(), in.strides()[1]);
+    // Every matrix along dimensions 2 and 3 is factorized independently and
+    // the first failure, in batch order, is reported
+    int info = 0;
+    for (dim_t n = 0; n < iDims[2] * iDims[3]; n++) {
+        T *iBatch = inPtr.get() + common::batchOffset(iDims, in.strides(), n);
+        int res = 0;
+        if (common::isSmallLapack(N)) {
+            res = common::potrfSmall(toSmallLapack(iBatch), in.strides()[1], is_upper, N);
+        } else {
+            res = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo,
+                                  N, iBatch, in.strides()[1]);
+        }
+        if (info == 0) info = res;
+    }
 
     return info;
 }
@@ -40,6 +40,28 @@
     #endif
 #endif
 
+#include <common/small_lapack.hpp>
+#include <complex>
+
+namespace opencl
+{
+namespace cpu
+{
+
+// Element type the kernels of common/small_lapack.hpp are instantiated with
+template<typename T> struct small_lapack_type  { typedef T type; };
+template<> struct small_lapack_type<cfloat >    { typedef std::complex<float > type; };
+template<> struct small_lapack_type<cdouble>    { typedef std::complex<double> type; };
+
+template<typename T>
+static inline typename small_lapack_type<T>::type *toSmallLapack(T *ptr)
+{
+    return reinterpret_cast<typename small_lapack_type<T>::type *>(ptr);
+}
+
+}
+}
+
 #endif  // WITH_LINEAR_ALGEBRA
 
 #endif  // AF_OPENCL_CPU
@@ -56,9 +56,18 @@ Array<T> inverse(const Array<T> &in)
     std::shared_ptr<T>   aPtr = A.getMappedPtr();
     std::shared_ptr<int> pPtr = pivot.getMappedPtr();
 
-    getri_func<T>()(AF_LAPACK_COL_MAJOR, M,
-                    aPtr.get(), A.strides()[1],
-                    pPtr.get());
+    // lu_inplace factorized every matrix along dimensions 2 and 3
+    for (dim_t n = 0; n < A.dims()[2] * A.dims()[3]; n++) {
+        T *aBatch   = aPtr.get() + common::batchOffset(A.dims(), A.strides(), n);
+        int *pBatch = pPtr.get() + common::batchOffset(pivot.dims(), pivot.strides(), n);
+        if (common::isSmallLapack(M)) {
+            common::getriSmall(toSmallLapack(aBatch), A.strides()[1], pBatch, M);
+        } else {
+            getri_func<T>()(AF_LAPACK_COL_MAJOR, M,
+                            aBatch, A.strides()[1],
+                            pBatch);
+        }
+    }
 
     return A;
 }
@@ -100,19 +100,21 @@ void lu_split(Array<T> &lower, Array<T> &upper, const Array<T> &in)
 
 void convertPivot(Array<int> &pivot, int out_sz)
 {
-    Array<int> p = range<int>(dim4(out_sz), 0); // Runs opencl
+    dim4 pDims = pivot.dims();
+    Array<int> p = range<int>(dim4(out_sz, 1, pDims[2], pDims[3]), 0); // Runs opencl
 
     std::shared_ptr<int> pi = pivot.getMappedPtr();
     std::shared_ptr<int> po = p.getMappedPtr();
 
-    int *d_pi = pi.get();
-    int *d_po = po.get();
+    dim_t d0 = pDims[0];
 
-    dim_t d0 = pivot.dims()[0];
-
-    for(int j = 0; j < (int)d0; j++) {
-        // 1 indexed in pivot
-        std::swap(d_po[j], d_po[d_pi[j] - 1]);
+    for(dim_t n = 0; n < pDims[2] * pDims[3]; n++) {
+        int *d_pi = pi.get() + common::batchOffset(pDims, pivot.strides(), n);
+        int *d_po = po.get() + common::batchOffset(p.dims(), p.strides(), n);
+        for(int j = 0; j < (int)d0; j++) {
+            // 1 indexed in pivot
+            std::swap(d_po[j], d_po[d_pi[j] - 1]);
+        }
     }
 
     pi.reset();
@@ -132,8 +134,8 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot, const Array<T> &in)
     pivot = lu_inplace(in_copy);
 
     // SPLIT into lower and upper
-    dim4 ldims(M, min(M, N));
-    dim4 udims(min(M, N), N);
+    dim4 ldims(M, min(M, N), iDims[2], iDims[3]);
+    dim4 udims(min(M, N), N, iDims[2], iDims[3]);
     lower = createEmptyArray<T>(ldims);
     upper = createEmptyArray<T>(udims);
 
@@ -147,14 +149,24 @@ Array<int> lu_inplace(Array<T> &in, const bool convert_pivot)
     int M = iDims[0];
     int N = iDims[1];
 
-    Array<int> pivot = createEmptyArray<int>(af::dim4(min(M, N), 1, 1, 1));
+    Array<int> pivot = createEmptyArray<int>(af::dim4(min(M, N), 1, iDims[2], iDims[3]));
 
     std::shared_ptr<T>   inPtr = in.getMappedPtr();
     std::shared_ptr<int> piPtr = pivot.getMappedPtr();
 
-    getrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N,
-                    inPtr.get(), in.strides()[1],
-                    piPtr.get());
+    // Every matrix along dimensions 2 and 3 is factorized independently,
+    // small square ones by the unrolled kernel
+    for (dim_t n = 0; n < iDims[2] * iDims[3]; n++) {
+        T *iBatch   = inPtr.get() + common::batchOffset(iDims, in.strides(), n);
+        int *pBatch = piPtr.get() + common::batchOffset(pivot.dims(), pivot.strides(), n);
+        if (M == N && common::isSmallLapack(N)) {
+            common::getrfSmall(toSmallLapack(iBatch), in.strides()[1], pBatch, N);
+        } else {
+            getrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N,
+                            iBatch, in.strides()[1],
+                            pBatch);
+        }
+    }
 
     inPtr.reset();
     piPtr.reset();
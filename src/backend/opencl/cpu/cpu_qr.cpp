@@ -62,13 +62,13 @@ void qr(Array<T> &q, Array<T> &r, Array<T> &t, const Array<T> &in)
     int M = iDims[0];
     int N = iDims[1];
 
-    dim4 padDims(M, max(M, N));
+    dim4 padDims(M, max(M, N), iDims[2], iDims[3]);
     q = padArray<T, T>(in, padDims, scalar<T>(0));
     q.resetDims(iDims);
     t = qr_inplace(q);
 
     // SPLIT into q and r
-    dim4 rdims(M, N);
+    dim4 rdims(M, N, iDims[2], iDims[3]);
     r = createEmptyArray<T>(rdims);
 
     std::shared_ptr<T> qPtr = q.getMappedPtr();
@@ -77,12 +77,15 @@ void qr(Array<T> &q, Array<T> &r, Array<T> &t, const Array<T> &in)
 
     triangle<T, true, false>(rPtr.get(), qPtr.get(), rdims, r.strides(), q.strides());
 
-    gqr_func<T>()(AF_LAPACK_COL_MAJOR,
-                  M, M, min(M, N),
-                  qPtr.get(), q.strides()[1],
-                  tPtr.get());
+    for (dim_t n = 0; n < iDims[2] * iDims[3]; n++) {
+        gqr_func<T>()(AF_LAPACK_COL_MAJOR,
+                      M, M, min(M, N),
+                      qPtr.get() + common::batchOffset(iDims, q.strides(), n),
+                      q.strides()[1],
+                      tPtr.get() + common::batchOffset(t.dims(), t.strides(), n));
+    }
 
-    q.resetDims(dim4(M, M));
+    q.resetDims(dim4(M, M, iDims[2], iDims[3]));
 }
 
 template<typename T>
@@ -92,14 +95,18 @@ Array<T> qr_inplace(Array<T> &in)
     int M = iDims[0];
     int N = iDims[1];
 
-    Array<T> t = createEmptyArray<T>(af::dim4(min(M, N), 1, 1, 1));
+    Array<T> t = createEmptyArray<T>(af::dim4(min(M, N), 1, iDims[2], iDims[3]));
 
     std::shared_ptr<T> iPtr = in.getMappedPtr();
     std::shared_ptr<T> tPtr = t.getMappedPtr();
 
-    geqrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N,
-                    iPtr.get(), in.strides()[1],
-                    tPtr.get());
+    // Every matrix along dimensions 2 and 3 is factorized independently
+    for (dim_t n = 0; n < iDims[2] * iDims[3]; n++) {
+        geqrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N,
+                        iPtr.get() + common::batchOffset(iDims, in.strides(), n),
+                        in.strides()[1],
+                        tPtr.get() + common::batchOffset(t.dims(), t.strides(), n));
+    }
 
     return t;
 }
@@ -44,6 +44,15 @@ using trtrs_func_def = int (*)(ORDER_TYPE,
                                const T *, int,
                                T *, int);
 
+template<typename T>
+using mixed_gesv_func_def = int (*)(ORDER_TYPE,
+                                    int, int,
+                                    T *, int,
+                                    int *,
+                                    T *, int,
+                                    T *, int,
+                                    int *);
+
 
 #define SOLVE_FUNC_DEF( FUNC )                                      \
 template<typename T> FUNC##_func_def<T> FUNC##_func();
@@ -77,6 +86,14 @@ SOLVE_FUNC(trtrs , double , d)
 SOLVE_FUNC(trtrs , cfloat , c)
 SOLVE_FUNC(trtrs , cdouble, z)
 
+// Single precision factorization with double precision refinement, only
+// worth it for double precision systems
+template<typename T> mixed_gesv_func_def<T> mixed_gesv_func() { return nullptr; }
+template<> mixed_gesv_func_def<double > mixed_gesv_func<double >()
+{ return & LAPACK_NAME(dsgesv); }
+template<> mixed_gesv_func_def<cdouble> mixed_gesv_func<cdouble>()
+{ return & LAPACK_NAME(zcgesv); }
+
 template<typename T>
 Array<T> solveLU(const Array<T> &A, const Array<int> &pivot,
                  const Array<T> &b, const af_mat_prop options)
@@ -110,13 +127,19 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b, const af_mat_prop o
     std::shared_ptr<T> aPtr = A.getMappedPtr();
     std::shared_ptr<T> bPtr = B.getMappedPtr();
 
-    trtrs_func<T>()(AF_LAPACK_COL_MAJOR,
-                    options & AF_MAT_UPPER ? 'U' : 'L',
-                    'N', // transpose flag
-                    options & AF_MAT_DIAG_UNIT ? 'U' : 'N',
-                    N, NRHS,
-                    aPtr.get(), A.strides()[1],
-                    bPtr.get(), B.strides()[1]);
+    // Every matrix along dimensions 2 and 3 is an independent system
+    const dim_t batches = A.dims()[2] * A.dims()[3];
+    for (dim_t n = 0; n < batches; n++) {
+        trtrs_func<T>()(AF_LAPACK_COL_MAJOR,
+                        options & AF_MAT_UPPER ? 'U' : 'L',
+                        'N', // transpose flag
+                        options & AF_MAT_DIAG_UNIT ? 'U' : 'N',
+                        N, NRHS,
+                        aPtr.get() + common::batchOffset(A.dims(), A.strides(), n),
+                        A.strides()[1],
+                        bPtr.get() + common::batchOffset(B.dims(), B.strides(), n),
+                        B.strides()[1]);
+    }
 
     return B;
 }
@@ -131,31 +154,75 @@ Array<T> solve(const Array<T> &a, const Array<T> &b, const af_mat_prop options)
         return triangleSolve<T>(a, b, options);
     }
 
-    int M = a.dims()[0];
-    int N = a.dims()[1];
+    dim4 aDims = a.dims();
+    int M = aDims[0];
+    int N = aDims[1];
     int K = b.dims()[1];
 
     Array<T> A = copyArray<T>(a);
-    Array<T> B = padArray<T, T>(b, dim4(max(M, N), K), scalar<T>(0));
+    Array<T> B = padArray<T, T>(b, dim4(max(M, N), K, aDims[2], aDims[3]), scalar<T>(0));
 
     std::shared_ptr<T> aPtr = A.getMappedPtr();
     std::shared_ptr<T> bPtr = B.getMappedPtr();
 
-    if(M == N) {
+    const dim_t batches = aDims[2] * aDims[3];
+    if(M == N && (options & AF_MAT_MIXED_PRECISION) &&
+       mixed_gesv_func<T>() && !common::isSmallLapack(N)) {
+        Array<T> X = createEmptyArray<T>(B.dims());
+        std::shared_ptr<T> xPtr = X.getMappedPtr();
+
+        std::vector<int> pivot(N);
+        for (dim_t n = 0; n < batches; n++) {
+            int iter = 0;
+            T *xBatch = xPtr.get() + common::batchOffset(X.dims(), X.strides(), n);
+            int info = mixed_gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K,
+                                            aPtr.get() + common::batchOffset(A.dims(), A.strides(), n),
+                                            A.strides()[1],
+                                            &pivot.front(),
+                                            bPtr.get() + common::batchOffset(B.dims(), B.strides(), n),
+                                            B.strides()[1],
+                                            xBatch, X.strides()[1],
+                                            &iter);
+            // X is not written when the system is singular
+            if (info > 0) {
+                common::fillSingular(toSmallLapack(xBatch), X.strides()[1], K, N);
+            }
+        }
+        return X;
+    } else if(M == N) {
         std::vector<int> pivot(N);
-        gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K,
-                       aPtr.get(), A.strides()[1],
-                       &pivot.front(),
-                       bPtr.get(), B.strides()[1]);
+        for (dim_t n = 0; n < batches; n++) {
+            T *aBatch = aPtr.get() + common::batchOffset(A.dims(), A.strides(), n);
+            T *bBatch = bPtr.get() + common::batchOffset(B.dims(), B.strides(), n);
+            int info = 0;
+            if (common::isSmallLapack(N)) {
+                info = common::getrfSmall(toSmallLapack(aBatch), A.strides()[1],
+                                          &pivot.front(), N);
+                if (info == 0) {
+                    common::getrsSmall(toSmallLapack(aBatch), A.strides()[1], &pivot.front(),
+                                       toSmallLapack(bBatch), B.strides()[1], K, N);
+                }
+            } else {
+                info = gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K,
+                                      aBatch, A.strides()[1],
+                                      &pivot.front(),
+                                      bBatch, B.strides()[1]);
+            }
+            // The solution of a singular system is NaN whichever solved it
+            if (info > 0) {
+                common::fillSingular(toSmallLapack(bBatch), B.strides()[1], K, N);
+            }
+        }
     } else {
-        int sM = a.strides()[1];
-        int sN = a.strides()[2] / sM;
-
-        gels_func<T>()(AF_LAPACK_COL_MAJOR, 'N',
-                       M, N, K,
-                       aPtr.get(), A.strides()[1],
-                       bPtr.get(), max(sM, sN));
-        B.resetDims(dim4(N, K));
+        for (dim_t n = 0; n < batches; n++) {
+            gels_func<T>()(AF_LAPACK_COL_MAJOR, 'N',
+                           M, N, K,
+                           aPtr.get() + common::batchOffset(A.dims(), A.strides(), n),
+                           A.strides()[1],
+                           bPtr.get() + common::batchOffset(B.dims(), B.strides(), n),
+                           B.strides()[1]);
+        }
+        B.resetDims(dim4(N, K, aDims[2], aDims[3]));
     }
 
     return B;
@@ -0,0 +1,93 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <describe.hpp>
+#include <arith.hpp>
+#include <cast.hpp>
+#include <join.hpp>
+#include <math.hpp>
+#include <reduce.hpp>
+#include <tile.hpp>
+#include <unary.hpp>
+#include <type_traits>
+#include <vector>
+
+using af::dim4;
+using std::vector;
+
+namespace opencl
+{
+
+template<typename Ti>
+static Array<uint> countNaN(const Array<Ti> &in, const int dim)
+{
+    if (std::is_floating_point<Ti>::value) {
+        return reduce<af_notzero_t, char, uint>(checkOp<Ti, af_isnan_t>(in), dim);
+    }
+    dim4 odims = in.dims();
+    odims[dim] = 1;
+    return createValueArray<uint>(odims, 0u);
+}
+
+template<typename Ti, typename To>
+Array<To> describe(const Array<Ti> &in, const unsigned stats,
+                   const af_var_bias bias, const int dim)
+{
+    const dim4 idims = in.dims();
+    dim4 odims = idims;
+    odims[dim] = 1;
+
+    // NaNs are replaced by zeros in the sums and excluded from the count
+    Array<To> input = cast<To, Ti>(in);
+    Array<To> nans  = cast<To, uint>(countNaN<Ti>(in, dim));
+    Array<To> len   = createValueArray<To>(odims, scalar<To>(idims[dim]));
+    Array<To> count = arithOp<To, af_sub_t>(len, nans, odims);
+    Array<To> sum   = reduce<af_add_t, To, To>(input, dim, true, 0);
+    Array<To> mean  = arithOp<To, af_div_t>(sum, count, odims);
+
+    vector<Array<To>> outputs;
+    if (stats & AF_STAT_MIN) outputs.push_back(cast<To, Ti>(reduce<af_min_t, Ti, Ti>(in, dim)));
+    if (stats & AF_STAT_MAX) outputs.push_back(cast<To, Ti>(reduce<af_max_t, Ti, Ti>(in, dim)));
+    if (stats & AF_STAT_SUM) outputs.push_back(sum);
+    if (stats & AF_STAT_MEAN) outputs.push_back(mean);
+    if (stats & AF_STAT_VAR) {
+        dim4 tileDims(1);
+        tileDims[dim] = idims[dim];
+        Array<To> diff = arithOp<To, af_sub_t>(input, tile<To>(mean, tileDims), idims);
+        Array<To> sq   = arithOp<To, af_mul_t>(diff, diff, idims);
+        Array<To> m2   = reduce<af_add_t, To, To>(sq, dim, true, 0);
+        if (bias == AF_VARIANCE_SAMPLE) {
+            Array<To> ones = createValueArray<To>(odims, scalar<To>(1));
+            count = arithOp<To, af_sub_t>(count, ones, odims);
+        }
+        outputs.push_back(arithOp<To, af_div_t>(m2, count, odims));
+    }
+    if (stats & AF_STAT_NAN_COUNT) outputs.push_back(nans);
+
+    if (outputs.size() == 1) return outputs[0];
+    return join<To>(dim, outputs);
+}
+
+#define INSTANTIATE(Ti, To)                                             \
+    template Array<To> describe<Ti, To>(const Array<Ti> &in, const unsigned stats, \
+                                        const af_var_bias bias, const int dim);
+
+INSTANTIATE(float , float )
+INSTANTIATE(double, double)
+INSTANTIATE(int   , float )
+INSTANTIATE(uint  , float )
+INSTANTIATE(intl  , double)
+INSTANTIATE(uintl , double)
+INSTANTIATE(short , float )
+INSTANTIATE(ushort, float )
+INSTANTIATE(uchar , float )
+INSTANTIATE(char  , float )
+
+}
@@ -21,7 +21,7 @@ namespace opencl
 template<typename T>
 Array<T> inverse(const Array<T> &in)
 {
-    if(OpenCLCPUOffload()) {
+    if(OpenCLCPUOffload() || in.ndims() > 2) {
         if (in.dims()[0] == in.dims()[1])
             return cpu::inverse(in);
     }
@@ -43,7 +43,8 @@ Array<int> convertPivot(int *ipiv, int in_sz, int out_sz)
 template<typename T>
 void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot, const Array<T> &in)
 {
-    if(OpenCLCPUOffload()) {
+    // Batches of matrices are factorized on the host
+    if(OpenCLCPUOffload() || in.ndims() > 2) {
         return cpu::lu(lower, upper, pivot, in);
     }
 
@@ -67,7 +68,7 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot, const Array<T> &in)
 template<typename T>
 Array<int> lu_inplace(Array<T> &in, const bool convert_pivot)
 {
-    if(OpenCLCPUOffload()) {
+    if(OpenCLCPUOffload() || in.ndims() > 2) {
         return cpu::lu_inplace(in, convert_pivot);
     }
 
@@ -0,0 +1,82 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <moving.hpp>
+#include <copy.hpp>
+#include <common/moving.hpp>
+#include <vector>
+
+using af::dim4;
+using std::vector;
+
+namespace opencl
+{
+
+template<typename Ti, typename To>
+Array<To> moving(const Array<Ti> &in, const af_stat_type stat, const dim_t window,
+                 const dim_t step, const af_var_bias bias, const int dim)
+{
+    // The monotonic queues and running sums are sequential along every
+    // series, so the windows are computed on the host
+    const dim4 idims = in.dims();
+    dim4 odims = idims;
+    odims[dim] = (idims[dim] - window) / step + 1;
+
+    vector<Ti> hin(in.elements());
+    vector<To> hout(odims.elements());
+    copyData(hin.data(), in);
+
+    const dim4 istrides(1, idims[0], idims[0] * idims[1], idims[0] * idims[1] * idims[2]);
+    const dim4 ostrides(1, odims[0], odims[0] * odims[1], odims[0] * odims[1] * odims[2]);
+
+    dim4 rdims = idims;
+    rdims[dim] = 1;
+
+    vector<dim_t> queue;
+    for (dim_t l = 0; l < rdims[3]; l++) {
+    for (dim_t k = 0; k < rdims[2]; k++) {
+    for (dim_t j = 0; j < rdims[1]; j++) {
+    for (dim_t i = 0; i < rdims[0]; i++) {
+        dim_t ioff = i + j * istrides[1] + k * istrides[2] + l * istrides[3];
+        dim_t ooff = i + j * ostrides[1] + k * ostrides[2] + l * ostrides[3];
+        common::movingSeries(hout.data() + ooff, ostrides[dim],
+                             hin.data() + ioff, istrides[dim],
+                             stat, window, step, bias, 0, odims[dim], queue);
+    }
+    }
+    }
+    }
+
+    return createHostDataArray<To>(odims, hout.data());
+}
+
+#define INSTANTIATE(Ti, To)                                             \
+    template Array<To> moving<Ti, To>(const Array<Ti> &in, const af_stat_type stat, \
+                                      const dim_t window, const dim_t step, \
+                                      const af_var_bias bias, const int dim);
+
+INSTANTIATE(float , float )
+INSTANTIATE(double, double)
+INSTANTIATE(int   , int   )
+INSTANTIATE(int   , float )
+INSTANTIATE(uint  , uint  )
+INSTANTIATE(uint  , float )
+INSTANTIATE(intl  , intl  )
+INSTANTIATE(intl  , double)
+INSTANTIATE(uintl , uintl )
+INSTANTIATE(uintl , double)
+INSTANTIATE(short , short )
+INSTANTIATE(short , float )
+INSTANTIATE(ushort, ushort)
+INSTANTIATE(ushort, float )
+INSTANTIATE(uchar , uchar )
+INSTANTIATE(uchar , float )
+
+}
@@ -28,7 +28,8 @@ namespace opencl
 template<typename T>
 void qr(Array<T> &q, Array<T> &r, Array<T> &t, const Array<T> &orig)
 {
-    if(OpenCLCPUOffload()) {
+    // Batches of matrices are factorized on the host
+    if(OpenCLCPUOffload() || orig.ndims() > 2) {
         return cpu::qr(q, r, t, orig);
     }
 
@@ -81,7 +82,7 @@ void qr(Array<T> &q, Array<T> &r, Array<T> &t, const Array<T> &orig)
 template<typename T>
 Array<T> qr_inplace(Array<T> &in)
 {
-    if(OpenCLCPUOffload()) {
+    if(OpenCLCPUOffload() || in.ndims() > 2) {
         return cpu::qr_inplace(in);
     }
 
@@ -14,6 +14,9 @@
 #include <sort.hpp>
 #include <err_opencl.hpp>
 
+#include <algorithm>
+#include <vector>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 
@@ -148,10 +151,31 @@ namespace opencl
         }
     }
 
+    template<typename T>
+    Array<char> isIn(const Array<T> &in, const Array<T> &set)
+    {
+        // boost.compute has no vectorized binary search, so the sorted
+        // distinct values of set are searched on the host
+        Array<T> values = setUnique<T>(set, false);
+
+        std::vector<T> hvalues(values.elements());
+        std::vector<T> hin(in.elements());
+        copyData(hvalues.data(), values);
+        copyData(hin.data(), in);
+
+        std::vector<char> mask(hin.size());
+        for (size_t i = 0; i < hin.size(); i++) {
+            mask[i] = std::binary_search(hvalues.begin(), hvalues.end(), hin[i]);
+        }
+
+        return createHostDataArray<char>(in.dims(), mask.data());
+    }
+
 #define INSTANTIATE(T)                                                  \
     template Array<T> setUnique<T>(const Array<T> &in, const bool is_sorted); \
     template Array<T> setUnion<T>(const Array<T> &first, const Array<T> &second, const bool is_unique); \
     template Array<T> setIntersect<T>(const Array<T> &first, const Array<T> &second, const bool is_unique); \
+    template Array<char> isIn<T>(const Array<T> &in, const Array<T> &set); \
 
     INSTANTIATE(float)
     INSTANTIATE(double)
@@ -0,0 +1,54 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <sketch.hpp>
+#include <copy.hpp>
+#include <vector>
+
+using std::vector;
+
+namespace opencl
+{
+
+// The sketches are host data structures updated one value at a time, so the
+// input is copied to the host and inserted there
+
+template<typename T>
+void sketchUpdate(common::quantile_sketch &sketch, const Array<T> &in)
+{
+    vector<T> data(in.elements());
+    copyData(data.data(), in);
+    for (size_t i = 0; i < data.size(); i++) sketch.insert((double)data[i]);
+}
+
+template<typename T>
+void sketchUpdate(common::distinct_sketch &sketch, const Array<T> &in)
+{
+    vector<T> data(in.elements());
+    copyData(data.data(), in);
+    for (size_t i = 0; i < data.size(); i++) sketch.insert(data[i]);
+}
+
+#define INSTANTIATE(T)                                                          \
+    template void sketchUpdate<T>(common::quantile_sketch &sketch, const Array<T> &in); \
+    template void sketchUpdate<T>(common::distinct_sketch &sketch, const Array<T> &in);
+
+INSTANTIATE(float )
+INSTANTIATE(double)
+INSTANTIATE(int   )
+INSTANTIATE(uint  )
+INSTANTIATE(intl  )
+INSTANTIATE(uintl )
+INSTANTIATE(short )
+INSTANTIATE(ushort)
+INSTANTIATE(uchar )
+INSTANTIATE(char  )
+
+}
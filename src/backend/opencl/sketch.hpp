@@ -0,0 +1,21 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <common/sketch.hpp>
+
+namespace opencl
+{
+// Inserts all the elements of in into sketch. NaNs are skipped.
+template<typename T>
+void sketchUpdate(common::quantile_sketch &sketch, const Array<T> &in);
+
+template<typename T>
+void sketchUpdate(common::distinct_sketch &sketch, const Array<T> &in);
+}
@@ -24,6 +24,7 @@
 #include <af/opencl.h>
 
 #include <algorithm>
+#include <limits>
 #include <string>
 
 #include <platform.hpp>
@@ -79,6 +80,11 @@ Array<T> generalSolve(const Array<T> &a, const Array<T> &b)
     magma_getrf_gpu<T>(M, N, (*A_buf)(), A.getOffset(), A.strides()[1],
                        &ipiv[0], q, &info);
 
+    // As on the host, the solution of a singular system is NaN
+    if (info > 0) {
+        return createValueArray<T>(B.dims(), scalar<T>(std::numeric_limits<double>::quiet_NaN()));
+    }
+
     cl::Buffer *B_buf = B.get();
     int K = B.dims()[1];
     magma_getrs_gpu<T>(MagmaNoTrans, M, K,
@@ -303,7 +309,8 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b, const af_mat_prop o
 template<typename T>
 Array<T> solve(const Array<T> &a, const Array<T> &b, const af_mat_prop options)
 {
-    if(OpenCLCPUOffload()) {
+    // Batches of systems are solved on the host, one after the other
+    if(OpenCLCPUOffload() || a.ndims() > 2) {
         return cpu::solve(a, b, options);
     }
 
@@ -22,6 +22,12 @@ void transpose_inplace(Array<T> &in, const bool conjugate)
 {
     dim4 iDims = in.dims();
 
+    // The kernels swap square tiles, rectangular matrices go through a copy
+    if (iDims[0] != iDims[1]) {
+        in = transpose<T>(in, conjugate);
+        return;
+    }
+
     if(conjugate) {
         if(iDims[0] % kernel::TILE_DIM == 0 && iDims[1] % kernel::TILE_DIM == 0)
             kernel::transpose_inplace<T, true, true>(in, getQueue());
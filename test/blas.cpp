@@ -339,3 +339,247 @@ TEST(MatrixMultiply, RhsBroadcastBatched)
         }
     }
 }
+
+TEST(MatrixMultiply, SmallBatched)
+{
+    // Small products are multiplied concurrently, a batch per thread
+    const int M = 16;
+    const int K = 24;
+    const int N = 8;
+    const int D2 = 50;
+    const int D3 = 20;
+
+    array a = randu(M, K, D2, D3);
+    array b = randu(K, N, D2, D3);
+    array v = randu(K, 1, D2, D3);
+    array c = matmul(a, b);
+    array cT = matmul(b, a, AF_MAT_TRANS, AF_MAT_TRANS);
+    array cv = matmul(a, v);
+    array cb = matmul(a, b(span, span, 0, 0));
+
+    for (int j = 0; j < D3; j += 7) {
+        for (int i = 0; i < D2; i += 9) {
+            array a_ij = a(span, span, i, j);
+            array b_ij = b(span, span, i, j);
+            ASSERT_ARRAYS_NEAR(c(span, span, i, j), matmul(a_ij, b_ij), 1E-4);
+            ASSERT_ARRAYS_NEAR(cT(span, span, i, j), matmul(b_ij.T(), a_ij.T()), 1E-4);
+            ASSERT_ARRAYS_NEAR(cv(span, span, i, j), matmul(a_ij, v(span, span, i, j)), 1E-4);
+            ASSERT_ARRAYS_NEAR(cb(span, span, i, j), matmul(a_ij, b(span, span, 0, 0)), 1E-4);
+        }
+    }
+}
+
+template<typename T>
+class IntegerMatrixMultiply : public ::testing::Test
+{
+};
+
+typedef ::testing::Types<int, uint, intl, uintl, short, ushort, uchar> IntegerTestTypes;
+TYPED_TEST_CASE(IntegerMatrixMultiply, IntegerTestTypes);
+
+// Integer products of 8 bit integers are returned as u32, those of 16 bit
+// integers as 64 bit integers
+template<typename T>
+static af::dtype integerMatmulType()
+{
+    af::dtype type = (af::dtype)dtype_traits<T>::af_type;
+    switch (type) {
+    case u8:  return u32;
+    case s16: return s64;
+    case u16: return u64;
+    default:  return type;
+    }
+}
+
+TYPED_TEST(IntegerMatrixMultiply, Batched)
+{
+    const af::dtype type = (af::dtype)dtype_traits<TypeParam>::af_type;
+    const af::dtype otype = integerMatmulType<TypeParam>();
+
+    // Products of small integers are exact in double precision
+    array a = (randu(67, 300, 3) * 16).as(type);
+    array b = (randu(300, 70, 3) * 16).as(type);
+    array gold = matmul(a.as(f64), b.as(f64)).as(otype);
+    ASSERT_ARRAYS_EQ(gold, matmul(a, b));
+
+    array aT = a(span, span, 0).T();
+    array bT = b(span, span, 1).T();
+    gold = matmul(a(span, span, 0).as(f64), b(span, span, 1).as(f64)).as(otype);
+    ASSERT_ARRAYS_EQ(gold, matmul(aT, bT, AF_MAT_TRANS, AF_MAT_TRANS));
+    ASSERT_ARRAYS_EQ(gold, matmul(aT, b(span, span, 1), AF_MAT_TRANS, AF_MAT_NONE));
+}
+
+TEST(IntegerMatrixMultiply, LargeSums)
+{
+    // Sums beyond the 53 bits of a double are exact
+    const intl big = 1LL << 40;
+    array a = af::constant(big, 4, 1000, s64);
+    array b = af::constant(1000, 1000, 3, s64);
+    array c = matmul(a, b);
+    vector<intl> h(c.elements());
+    c.host(h.data());
+    for (size_t i = 0; i < h.size(); i++) ASSERT_EQ(big * 1000 * 1000, h[i]);
+}
+
+TEST(IntegerMatrixMultiply, SixteenBitSums)
+{
+    // Two products of the largest 16 bit values already overflow 32 bits
+    array a = af::constant(65535, 3, 2, u16);
+    array b = af::constant(65535, 2, 4, u16);
+    array c = matmul(a, b);
+    ASSERT_EQ(u64, c.type());
+    vector<uintl> h(c.elements());
+    c.host(h.data());
+    for (size_t i = 0; i < h.size(); i++) ASSERT_EQ(2ULL * 65535 * 65535, h[i]);
+
+    array sa = af::constant(-32768, 3, 3, s16);
+    array sc = matmul(sa, sa);
+    ASSERT_EQ(s64, sc.type());
+    vector<intl> sh(sc.elements());
+    sc.host(sh.data());
+    for (size_t i = 0; i < sh.size(); i++) ASSERT_EQ(3LL * 32768 * 32768, sh[i]);
+}
+
+TEST(IntegerMatrixMultiply, Quantized)
+{
+    const int lhsZero = 128, rhsZero = 3;
+    const double scale = 0.25;
+
+    array a = (randu(50, 1000) * 256).as(u8);
+    array b = (randu(1000, 20, 2) * 256).as(u8);
+    array gold = scale * matmul(a.as(f64) - lhsZero, b.as(f64) - rhsZero);
+
+    array c = af::matmulQuantized(a, b, lhsZero, rhsZero, scale);
+    ASSERT_EQ(f32, c.type());
+    ASSERT_ARRAYS_NEAR(gold.as(f32), c, 1E-2);
+
+    array cT = af::matmulQuantized(a.T(), b, lhsZero, rhsZero, scale, AF_MAT_TRANS);
+    ASSERT_ARRAYS_NEAR(gold.as(f32), cT, 1E-2);
+}
+
+TEST(IntegerMatrixMultiply, QuantizedLargeSums)
+{
+    // Both sums overflow 32 bit integers: the products of s16 values minus
+    // their zero points overflow on their own, and u8 ones over a long depth
+    array a = af::constant(30000, 4, 5000, s16);
+    array b = af::constant(-30000, 5000, 3, s16);
+    array c = af::matmulQuantized(a, b, -2000, 2000, 1.0);
+    vector<float> h(c.elements());
+    c.host(h.data());
+    for (size_t i = 0; i < h.size(); i++) ASSERT_EQ(-32000.f * 32000.f * 5000.f, h[i]);
+
+    array a8 = af::constant(255, 2, 100000, u8);
+    array b8 = af::constant(255, 100000, 2, u8);
+    array c8 = af::matmulQuantized(a8, b8, 0, 0, 1.0);
+    c8.host(h.data());
+    for (int i = 0; i < 4; i++) ASSERT_FLOAT_EQ((float)(65025LL * 100000), h[i]);
+}
+
+TEST(IntegerMatrixMultiply, QuantizedInvalidArgs)
+{
+    array a = (randu(10, 10) * 256).as(u8);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_matmul_quantized(&out, a.get(), a.get(), AF_MAT_NONE,
+                                              AF_MAT_NONE, 256, 0, 1.0));
+    array f = randu(10, 10);
+    ASSERT_EQ(AF_ERR_TYPE, af_matmul_quantized(&out, f.get(), f.get(), AF_MAT_NONE,
+                                               AF_MAT_NONE, 0, 0, 1.0));
+}
+
+template<typename T>
+class FusedMatrixMultiply : public ::testing::Test
+{
+};
+
+typedef ::testing::Types<float, double> FusedTestTypes;
+TYPED_TEST_CASE(FusedMatrixMultiply, FusedTestTypes);
+
+static array activate(const array &in, const af_activation act)
+{
+    switch (act) {
+    case AF_ACTIVATION_RELU:    return af::max(in, 0.0);
+    case AF_ACTIVATION_SIGMOID: return af::sigmoid(in);
+    case AF_ACTIVATION_TANH:    return af::tanh(in);
+    default:                    return in;
+    }
+}
+
+static const af_activation activations[] = {AF_ACTIVATION_NONE, AF_ACTIVATION_RELU,
+                                            AF_ACTIVATION_SIGMOID, AF_ACTIVATION_TANH};
+
+TYPED_TEST(FusedMatrixMultiply, Bias)
+{
+    if (noDoubleTests<TypeParam>()) return;
+    const af::dtype type = (af::dtype)dtype_traits<TypeParam>::af_type;
+    const double alpha = 0.5;
+
+    // The output spans several cache panels
+    array a = randu(700, 60, type) - 0.5;
+    array b = randu(60, 2000, type) - 0.5;
+    array rowBias = randu(700, type);
+    array colBias = randu(1, 2000, type);
+    array prod = alpha * matmul(a, b);
+
+    for (int i = 0; i < 4; i++) {
+        af_activation act = activations[i];
+        ASSERT_ARRAYS_NEAR(activate(prod + af::tile(rowBias, 1, 2000), act),
+                           af::matmulFused(a, b, rowBias, act, alpha), 1E-4);
+        ASSERT_ARRAYS_NEAR(activate(prod + af::tile(colBias, 700), act),
+                           af::matmulFused(a, b, colBias, act, alpha), 1E-4);
+        ASSERT_ARRAYS_NEAR(activate(prod, act),
+                           af::matmulFused(a, b, array(), act, alpha), 1E-4);
+    }
+}
+
+TYPED_TEST(FusedMatrixMultiply, Accumulate)
+{
+    if (noDoubleTests<TypeParam>()) return;
+    const af::dtype type = (af::dtype)dtype_traits<TypeParam>::af_type;
+
+    array a = randu(40, 30, 3, type);
+    array b = randu(50, 30, type);
+    array c = randu(40, 50, 3, type);
+    array bias = randu(1, 50, type);
+
+    array gold = af::tanh(2 * matmulNT(a, b) - c + af::tile(bias, 40, 1, 3));
+    array out = af::matmulFused(a, b, c, -1.0, bias, AF_ACTIVATION_TANH, 2.0,
+                                AF_MAT_NONE, AF_MAT_TRANS);
+    ASSERT_ARRAYS_NEAR(gold, out, 1E-4);
+}
+
+TYPED_TEST(FusedMatrixMultiply, BiasView)
+{
+    if (noDoubleTests<TypeParam>()) return;
+    const af::dtype type = (af::dtype)dtype_traits<TypeParam>::af_type;
+
+    array a = randu(30, 20, type);
+    array b = randu(20, 40, type);
+    array w = randu(50, 60, type);
+
+    // Neither bias is stored contiguously
+    array colBias = w(3, af::seq(5, 44));
+    array rowBias = w(af::seq(0, 59, 2), 7);
+    array prod = matmul(a, b);
+
+    ASSERT_ARRAYS_NEAR(prod + af::tile(colBias, 30),
+                       af::matmulFused(a, b, colBias), 1E-4);
+    ASSERT_ARRAYS_NEAR(prod + af::tile(rowBias, 1, 40),
+                       af::matmulFused(a, b, rowBias), 1E-4);
+}
+
+TEST(FusedMatrixMultiply, InvalidArgs)
+{
+    array a = randu(10, 20);
+    array b = randu(20, 30);
+    af_array out = 0;
+    array bias = randu(20);
+    ASSERT_EQ(AF_ERR_SIZE, af_matmul_fused(&out, a.get(), b.get(), AF_MAT_NONE, AF_MAT_NONE,
+                                           1.0, 0, 0.0, bias.get(), AF_ACTIVATION_NONE));
+    array c = randu(10, 20);
+    ASSERT_EQ(AF_ERR_SIZE, af_matmul_fused(&out, a.get(), b.get(), AF_MAT_NONE, AF_MAT_NONE,
+                                           1.0, c.get(), 1.0, 0, AF_ACTIVATION_NONE));
+    array ai = randu(10, 20, s32);
+    array bi = randu(20, 30, s32);
+    ASSERT_EQ(AF_ERR_TYPE, af_matmul_fused(&out, ai.get(), bi.get(), AF_MAT_NONE, AF_MAT_NONE,
+                                           1.0, 0, 0.0, 0, AF_ACTIVATION_NONE));
+}
@@ -69,6 +69,38 @@ void choleskyTester(const int n, double eps, bool is_upper)
     ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(imag(out2 - out))), eps);
 }
 
+// Factorizes a batch of matrices along dimension 2 at once
+template<typename T>
+void choleskyBatchedTester(const int n, const int batch, double eps, bool is_upper)
+{
+    if (noDoubleTests<T>()) return;
+    if (noLAPACKTests()) return;
+
+    dtype ty = (dtype)dtype_traits<T>::af_type;
+
+    array a = cpu_randu<T>(dim4(n, n, batch));
+    array b = 10 * n * identity(dim4(n, n, batch), ty);
+    array in = matmul(a.H(), a) + b;
+
+    array out;
+    ASSERT_EQ(0, cholesky(out, in, is_upper));
+    ASSERT_EQ(in.dims(), out.dims());
+
+    array re = is_upper ? matmul(out.H(), out) : matmul(out, out.H());
+
+    ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(real(in - re))), eps);
+    ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(imag(in - re))), eps);
+
+    array in2 = in.copy();
+    ASSERT_EQ(0, choleskyInPlace(in2, is_upper));
+
+    array out2 = is_upper ? upper(in2) : lower(in2);
+
+    ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(real(out2 - out))), eps);
+    ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(imag(out2 - out))), eps);
+}
+
+
 template<typename T>
 class Cholesky : public ::testing::Test
 {
@@ -132,3 +164,27 @@ TYPED_TEST(Cholesky, LowerMultipleOfTwo) {
 TYPED_TEST(Cholesky, LowerMultipleOfTwoLarge) {
     choleskyTester<TypeParam>( 1024, eps<TypeParam>(), false );
 }
+
+#if !defined(AF_CUDA)
+TYPED_TEST(Cholesky, BatchedSmall) {
+    choleskyBatchedTester<TypeParam>(6, 300, eps<TypeParam>(), true);
+    choleskyBatchedTester<TypeParam>(6, 300, eps<TypeParam>(), false);
+}
+
+TYPED_TEST(Cholesky, BatchedLarge) {
+    choleskyBatchedTester<TypeParam>(50, 6, eps<TypeParam>(), true);
+    choleskyBatchedTester<TypeParam>(50, 6, eps<TypeParam>(), false);
+}
+
+TEST(Cholesky, BatchedNotPositiveDefinite) {
+    if (noLAPACKTests()) return;
+
+    // The first matrix that can not be factorized is reported
+    array in = identity(dim4(4, 4, 5), f32);
+    in(2, 2, 3) = -1;
+    in(1, 1, 4) = -1;
+
+    array out;
+    ASSERT_EQ(3, cholesky(out, in, true));
+}
+#endif
@@ -135,3 +135,109 @@ TEST(Covariance, c64)
     array b = constant(cdouble(2.0, -1.0), 10, c64);
     ASSERT_THROW(cov(a, b), exception);
 }
+
+// Covariance or correlation of columns i and j of the N x P column major
+// matrix x, using the rows where both are not NaN when pairwise is set
+static double goldCov(const vector<double> &x, const vector<double> &w,
+                      const dim_t N, const dim_t i, const dim_t j,
+                      const bool sample, const bool corr)
+{
+    double n = 0, si = 0, sj = 0;
+    for (dim_t k = 0; k < N; k++) {
+        double xi = x[k + i * N], xj = x[k + j * N];
+        if (xi != xi || xj != xj) continue;
+        n  += w[k];
+        si += w[k] * xi;
+        sj += w[k] * xj;
+    }
+    double mi = si / n, mj = sj / n;
+    double cij = 0, cii = 0, cjj = 0;
+    for (dim_t k = 0; k < N; k++) {
+        double xi = x[k + i * N], xj = x[k + j * N];
+        if (xi != xi || xj != xj) continue;
+        cij += w[k] * (xi - mi) * (xj - mj);
+        cii += w[k] * (xi - mi) * (xi - mi);
+        cjj += w[k] * (xj - mj) * (xj - mj);
+    }
+    if (corr) return cij / std::sqrt(cii * cjj);
+    return cij / (sample ? n - 1 : n);
+}
+
+static void covMatrixTest(const array &X, const array &weights,
+                          const af::varBias bias, const bool pairwise,
+                          const bool corr, const double tol)
+{
+    const dim_t N = X.dims(0), P = X.dims(1);
+    array out;
+    if (corr) {
+        out = weights.isempty() ? af::corrcoefMatrix(X, pairwise)
+                                : af::corrcoefMatrix(X, weights, pairwise);
+    } else {
+        out = weights.isempty() ? af::covMatrix(X, bias, pairwise)
+                                : af::covMatrix(X, weights, bias, pairwise);
+    }
+    ASSERT_EQ(dim4(P, P), out.dims());
+
+    vector<double> x(X.elements()), w(N, 1), res(out.elements());
+    X.as(f64).host(x.data());
+    if (!weights.isempty()) weights.as(f64).host(w.data());
+    out.as(f64).host(res.data());
+
+    for (dim_t j = 0; j < P; j++) {
+        for (dim_t i = 0; i < P; i++) {
+            double gold = goldCov(x, w, N, i, j, bias == AF_VARIANCE_SAMPLE, corr);
+            ASSERT_NEAR(gold, res[i + j * P], tol * std::max(1.0, std::fabs(gold)))
+                << "at " << i << "," << j;
+        }
+    }
+}
+
+TYPED_TEST(Covariance, MatrixOfColumns)
+{
+    typedef typename covOutType<TypeParam>::type outType;
+    if (noDoubleTests<TypeParam>()) return;
+    if (noDoubleTests<outType>()) return;
+
+    array X = (af::randu(200, 9) * 100).as((af::dtype)af::dtype_traits<TypeParam>::af_type);
+    covMatrixTest(X, array(), AF_VARIANCE_SAMPLE, false, false, 1e-4);
+    covMatrixTest(X, array(), AF_VARIANCE_POPULATION, false, false, 1e-4);
+    covMatrixTest(X, array(), AF_VARIANCE_SAMPLE, false, true, 1e-4);
+}
+
+TEST(Covariance, MatrixWeighted)
+{
+    array X = af::randu(300, 12, f64);
+    array w = af::floor(af::randu(300, f64) * 5);
+    covMatrixTest(X, w, AF_VARIANCE_SAMPLE, false, false, 1e-10);
+    covMatrixTest(X, w, AF_VARIANCE_POPULATION, false, true, 1e-10);
+}
+
+TEST(Covariance, MatrixPairwise)
+{
+    array X = af::randu(500, 10, f64) + 1000;
+    X(af::randu(500, 10) < 0.2) = af::NaN;
+    X(af::seq(0, 99), 3) = af::NaN;
+    array w = af::randu(500, f64);
+    covMatrixTest(X, array(), AF_VARIANCE_SAMPLE, true, false, 1e-8);
+    covMatrixTest(X, array(), AF_VARIANCE_SAMPLE, true, true, 1e-8);
+    covMatrixTest(X, w, AF_VARIANCE_POPULATION, true, false, 1e-8);
+    covMatrixTest(X, w, AF_VARIANCE_POPULATION, true, true, 1e-8);
+}
+
+TEST(Covariance, MatrixPairwiseWithoutNaN)
+{
+    // Pairwise handling gives the same result when every value is valid
+    array X = af::randu(100, 5, f64);
+    array a = af::covMatrix(X, AF_VARIANCE_SAMPLE, false);
+    array b = af::covMatrix(X, AF_VARIANCE_SAMPLE, true);
+    ASSERT_NEAR(0, af::max<double>(af::abs(a - b)), 1e-12);
+}
+
+TEST(Covariance, MatrixInvalidWeights)
+{
+    array X = af::randu(100, 5);
+    array w = af::randu(99);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_cov_matrix(&out, X.get(), w.get(), AF_VARIANCE_SAMPLE, false));
+    ASSERT_EQ(AF_ERR_ARG, af_corrcoef_matrix(&out, X.get(), w.get(), false));
+}
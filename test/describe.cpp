@@ -0,0 +1,189 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <af/array.h>
+#include <af/arith.h>
+#include <af/data.h>
+#include <af/statistics.h>
+#include <testHelpers.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using std::vector;
+using af::array;
+using af::describe;
+using af::dim4;
+using af::dtype;
+using af::dtype_traits;
+using af::randu;
+
+template<typename T>
+class Describe : public ::testing::Test
+{
+};
+
+typedef ::testing::Types<float, double, int, uint, uchar, short, ushort> TestTypes;
+TYPED_TEST_CASE(Describe, TestTypes);
+
+template<typename T>
+array generateInput(const dim4 &dims)
+{
+    return (randu(dims, f32) * 200).as((dtype)dtype_traits<T>::af_type);
+}
+
+// Statistics of the slice of len elements starting at ptr, in the order of
+// their af_stat_type flags
+static void goldStats(double *gold, const double *ptr, const dim_t stride,
+                      const dim_t len, const bool sample)
+{
+    double mn = std::numeric_limits<double>::infinity();
+    double mx = -mn;
+    double sum = 0, count = 0, nans = 0;
+    for (dim_t i = 0; i < len; i++) {
+        double val = ptr[i * stride];
+        if (val != val) { nans++; continue; }
+        mn = std::min(mn, val);
+        mx = std::max(mx, val);
+        sum += val;
+        count++;
+    }
+    double mean = sum / count, m2 = 0;
+    for (dim_t i = 0; i < len; i++) {
+        double val = ptr[i * stride];
+        if (val == val) m2 += (val - mean) * (val - mean);
+    }
+    gold[0] = mn;
+    gold[1] = mx;
+    gold[2] = sum;
+    gold[3] = mean;
+    gold[4] = m2 / (sample ? count - 1 : count);
+    gold[5] = nans;
+}
+
+static void describeTest(const array &in, const int dim, const af_var_bias bias)
+{
+    const dim4 dims = in.dims();
+    array out = describe(in, AF_STAT_ALL, bias, dim);
+
+    dim4 odims = dims;
+    odims[dim] = 6;
+    ASSERT_EQ(odims, out.dims());
+
+    vector<double> hin(in.elements()), hout(out.elements());
+    in.as(f64).host(hin.data());
+    out.as(f64).host(hout.data());
+
+    dim4 istrides(1, dims[0], dims[0] * dims[1], dims[0] * dims[1] * dims[2]);
+    dim4 ostrides(1, odims[0], odims[0] * odims[1], odims[0] * odims[1] * odims[2]);
+
+    for (dim_t l = 0; l < dims[3]; l++) {
+    for (dim_t k = 0; k < dims[2]; k++) {
+    for (dim_t j = 0; j < dims[1]; j++) {
+    for (dim_t i = 0; i < dims[0]; i++) {
+        dim_t idx[4] = {i, j, k, l};
+        if (idx[dim] != 0) continue;
+        dim_t ioff = i * istrides[0] + j * istrides[1] + k * istrides[2] + l * istrides[3];
+        dim_t ooff = i * ostrides[0] + j * ostrides[1] + k * ostrides[2] + l * ostrides[3];
+
+        double gold[6];
+        goldStats(gold, hin.data() + ioff, istrides[dim], dims[dim],
+                  bias == AF_VARIANCE_SAMPLE);
+        for (int s = 0; s < 6; s++) {
+            double val = hout[ooff + s * ostrides[dim]];
+            ASSERT_NEAR(gold[s], val, 1e-4 * std::max(1.0, std::fabs(gold[s])))
+                << "at slice " << i << "," << j << "," << k << "," << l
+                << " statistic " << s;
+        }
+    }
+    }
+    }
+    }
+}
+
+template<typename T>
+static void describeTest(const dim4 &dims, const int dim)
+{
+    if (noDoubleTests<T>()) return;
+    describeTest(generateInput<T>(dims), dim, AF_VARIANCE_SAMPLE);
+}
+
+TYPED_TEST(Describe, Vector)
+{
+    describeTest<TypeParam>(dim4(1001), 0);
+}
+
+TYPED_TEST(Describe, Dim0)
+{
+    describeTest<TypeParam>(dim4(100, 7, 3), 0);
+}
+
+TYPED_TEST(Describe, Dim1)
+{
+    describeTest<TypeParam>(dim4(7, 100, 3), 1);
+}
+
+TYPED_TEST(Describe, Dim2)
+{
+    describeTest<TypeParam>(dim4(5, 3, 64, 2), 2);
+}
+
+TYPED_TEST(Describe, Dim3)
+{
+    describeTest<TypeParam>(dim4(5, 3, 2, 64), 3);
+}
+
+TEST(Describe, NaN)
+{
+    array in = randu(500, 40, f64);
+    in(randu(500, 40) < 0.1) = af::NaN;
+    describeTest(in, 0, AF_VARIANCE_POPULATION);
+    describeTest(in, 1, AF_VARIANCE_POPULATION);
+}
+
+TEST(Describe, LargeOffset)
+{
+    // The variance of values far from zero needs a stable update
+    array in = 1e6 + randu(1 << 20, f64);
+    describeTest(in, 0, AF_VARIANCE_SAMPLE);
+}
+
+TEST(Describe, Selection)
+{
+    array in = randu(100, 20);
+    array out = describe(in, AF_STAT_VAR | AF_STAT_MIN, AF_VARIANCE_SAMPLE);
+
+    ASSERT_EQ(dim4(2, 20), out.dims());
+    ASSERT_NEAR(0, af::max<float>(af::abs(out.row(0) - af::min(in))), 1e-6);
+    ASSERT_NEAR(0, af::max<float>(af::abs(out.row(1) - af::var(in))), 1e-5);
+}
+
+TEST(Describe, All)
+{
+    array in = randu(300, 200);
+    double out[6];
+    describe(out, in, AF_STAT_ALL, AF_VARIANCE_SAMPLE);
+
+    ASSERT_NEAR(af::min<float>(in), out[0], 1e-6);
+    ASSERT_NEAR(af::max<float>(in), out[1], 1e-6);
+    ASSERT_NEAR(af::sum<float>(in), out[2], 1e-1);
+    ASSERT_NEAR(af::mean<float>(in), out[3], 1e-5);
+    ASSERT_NEAR(af::var<float>(in), out[4], 1e-5);
+    ASSERT_EQ(0, out[5]);
+}
+
+TEST(Describe, InvalidStats)
+{
+    array in = randu(100);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_describe(&out, in.get(), 0, AF_VARIANCE_POPULATION, 0));
+    ASSERT_EQ(AF_ERR_ARG, af_describe(&out, in.get(), 64, AF_VARIANCE_POPULATION, 0));
+}
@@ -183,6 +183,64 @@ INSTANTIATEC(1000   , dot_c_1000);
 INSTANTIATEC(10     , dot_c_10);
 INSTANTIATEC(25600  , dot_c_25600);
 
+TYPED_TEST(DotC, Batched)
+{
+    if (noDoubleTests<TypeParam>()) return;
+
+    af::dtype ty = (af::dtype)dtype_traits<TypeParam>::af_type;
+    array a = af::randu(1000, 12, 3, ty);
+    array b = af::randu(1000, 12, 3, ty);
+
+    array out  = dot(a, b, AF_MAT_CONJ, AF_MAT_NONE);
+    array gold = af::sum(af::conjg(a) * b);
+    ASSERT_EQ(dim4(1, 12, 3), out.dims());
+    ASSERT_ARRAYS_NEAR(gold, out, 1e-2);
+}
+
+TYPED_TEST(DotF, Broadcast)
+{
+    if (noDoubleTests<TypeParam>()) return;
+
+    af::dtype ty = (af::dtype)dtype_traits<TypeParam>::af_type;
+    array query = af::randu(128, ty);
+    array docs  = af::randu(128, 5000, ty);
+
+    array out  = dot(query, docs);
+    array gold = af::matmul(query, docs, AF_MAT_TRANS, AF_MAT_NONE);
+    ASSERT_EQ(dim4(1, 5000), out.dims());
+    ASSERT_ARRAYS_NEAR(gold, out, 1e-3);
+
+    out = dot(docs, query);
+    ASSERT_ARRAYS_NEAR(gold, out, 1e-3);
+}
+
+TEST(DotF, LongVector)
+{
+    // Sums of this many single precision terms drift far from the exact
+    // value when added one after the other
+    const int n = 1 << 24;
+    array a = af::constant(1.25, n);
+    array b = af::constant(0.1, n);
+
+    const double gold = n * 1.25 * (double)0.1f;
+    ASSERT_NEAR(gold, dot<float>(a, b), gold * 1e-5);
+}
+
+TEST(DotF, InvalidBatch)
+{
+    array a = af::randu(100, 4);
+    array b = af::randu(100, 3);
+    af_array out = 0;
+    double rval, ival;
+    ASSERT_EQ(AF_ERR_SIZE, af_dot(&out, a.get(), b.get(), AF_MAT_NONE, AF_MAT_NONE));
+    ASSERT_EQ(AF_ERR_BATCH, af_dot_all(&rval, &ival, a.get(), a.get(), AF_MAT_NONE, AF_MAT_NONE));
+
+    // Row vectors are rejected rather than treated as single element columns
+    array r = af::randu(1, 100);
+    ASSERT_EQ(AF_ERR_BATCH, af_dot(&out, r.get(), r.get(), AF_MAT_NONE, AF_MAT_NONE));
+    ASSERT_EQ(AF_ERR_BATCH, af_dot_all(&rval, &ival, r.get(), r.get(), AF_MAT_NONE, AF_MAT_NONE));
+}
+
 ///////////////////////////////////// CPP ////////////////////////////////
 //
 TEST(DotF, CPP)
@@ -292,3 +292,74 @@ TEST(histogram, LargeBins)
         ASSERT_EQ(hH[i], 0u);
     }
 }
+
+TEST(histogram, LargeParallel)
+{
+    const int nbins = 37;
+    const int num = 1 << 22;
+    array A = randu(num) * 10.0 - 5.0;
+    array H = histogram(A, nbins, -4.0, 4.0);
+
+    vector<float> hA(num);
+    A.host(hA.data());
+
+    vector<unsigned> hH(nbins);
+    H.host(hH.data());
+
+    const double step = (float)(8.0 / (float)nbins);
+    vector<unsigned> gold(nbins, 0);
+    for (int i = 0; i < num; i++) {
+        int bin = (int)((hA[i] - (-4.0)) / step);
+        bin = std::max(bin, 0);
+        bin = std::min(bin, nbins - 1);
+        gold[bin]++;
+    }
+
+    for (int i = 0; i < nbins; i++) {
+        ASSERT_EQ(gold[i], hH[i]) << "at bin " << i;
+    }
+}
+
+TEST(histogram, Joint2D)
+{
+    const unsigned xbins = 12;
+    const unsigned ybins = 7;
+    const int num = 10000;
+    array x = randu(100, 100) * 20.0;
+    array y = randu(num) * 3.0 - 1.0;
+    array H = histogram2d(x, y, xbins, ybins, 2.0, 18.0, -0.5, 1.5);
+
+    ASSERT_EQ(u32, H.type());
+    ASSERT_EQ(dim4(xbins, ybins), H.dims());
+
+    vector<float> hx(num), hy(num);
+    x.host(hx.data());
+    y.host(hy.data());
+
+    vector<unsigned> hH(xbins * ybins);
+    H.host(hH.data());
+
+    const double xstep = (float)(16.0 / (float)xbins);
+    const double ystep = (float)(2.0 / (float)ybins);
+    vector<unsigned> gold(xbins * ybins, 0);
+    for (int i = 0; i < num; i++) {
+        int xb = (int)std::floor((hx[i] - 2.0) / xstep);
+        int yb = (int)std::floor((hy[i] + 0.5) / ystep);
+        xb = std::min(std::max(xb, 0), (int)xbins - 1);
+        yb = std::min(std::max(yb, 0), (int)ybins - 1);
+        gold[xb + xbins * yb]++;
+    }
+
+    for (unsigned i = 0; i < xbins * ybins; i++) {
+        ASSERT_EQ(gold[i], hH[i]) << "at bin " << i;
+    }
+}
+
+TEST(histogram, Joint2DSizeMismatch)
+{
+    af_array out = 0;
+    array x = randu(10);
+    array y = randu(11);
+    ASSERT_EQ(AF_ERR_ARG, af_histogram2d(&out, x.get(), y.get(), 4, 4,
+                                         0.0, 1.0, 0.0, 1.0));
+}
@@ -54,6 +54,26 @@ void inverseTester(const int m, const int n, double eps)
 }
 
 
+// Inverts a batch of matrices along dimension 2 at once
+template<typename T>
+void inverseBatchedTester(const int n, const int batch, double eps)
+{
+    if (noDoubleTests<T>()) return;
+    if (noLAPACKTests()) return;
+
+    dtype ty = (dtype)dtype_traits<T>::af_type;
+    // Keep the many small matrices well conditioned
+    array A = cpu_randu<T>(dim4(n, n, batch)) + n * identity(dim4(n, n, batch), ty);
+
+    array IA = inverse(A);
+    array I  = matmul(A, IA);
+    array I2 = identity(dim4(n, n, batch), ty);
+
+    ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(real(I - I2))), eps);
+    ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(imag(I - I2))), eps);
+}
+
+
 template<typename T>
 class Inverse : public ::testing::Test
 {
@@ -93,3 +113,13 @@ TYPED_TEST(Inverse, Square) {
 TYPED_TEST(Inverse, SquareMultiplePowerOfTwo) {
     inverseTester<TypeParam>(2048, 2048, eps<TypeParam>());
 }
+
+#if !defined(AF_CUDA)
+TYPED_TEST(Inverse, BatchedSmall) {
+    inverseBatchedTester<TypeParam>(5, 500, eps<TypeParam>());
+}
+
+TYPED_TEST(Inverse, BatchedLarge) {
+    inverseBatchedTester<TypeParam>(40, 8, eps<TypeParam>());
+}
+#endif
@@ -444,3 +444,83 @@ TEST(IndexedReduce, MaxCplxPreferSmallerIdxIfEqual)
 
     ASSERT_EQ(h_max_idx[0], gold_max_idx);
 }
+
+TEST(IndexedReduce, LargeTiesAlongDim1)
+{
+    const int nrows = 1000;
+    const int ncols = 300;
+    array a = (randu(nrows, ncols) * 4).as(s32);
+
+    array min_val, min_idx, max_val, max_idx;
+    min(min_val, min_idx, a, 1);
+    max(max_val, max_idx, a, 1);
+
+    vector<int> ha(nrows * ncols);
+    a.host(&ha[0]);
+
+    vector<int> h_min_val(nrows), h_max_val(nrows);
+    vector<unsigned> h_min_idx(nrows), h_max_idx(nrows);
+    min_val.host(&h_min_val[0]);
+    min_idx.host(&h_min_idx[0]);
+    max_val.host(&h_max_val[0]);
+    max_idx.host(&h_max_idx[0]);
+
+    for (int r = 0; r < nrows; r++) {
+        unsigned gold_min_idx = 0, gold_max_idx = 0;
+        for (int c = 1; c < ncols; c++) {
+            if (ha[c * nrows + r] <= ha[gold_min_idx * nrows + r]) gold_min_idx = c;
+            if (ha[c * nrows + r] >  ha[gold_max_idx * nrows + r]) gold_max_idx = c;
+        }
+        ASSERT_EQ(gold_min_idx, h_min_idx[r]) << "at row " << r;
+        ASSERT_EQ(gold_max_idx, h_max_idx[r]) << "at row " << r;
+        ASSERT_EQ(ha[gold_min_idx * nrows + r], h_min_val[r]);
+        ASSERT_EQ(ha[gold_max_idx * nrows + r], h_max_val[r]);
+    }
+}
+
+TEST(IndexedReduce, LargeTiesAll)
+{
+    const int num = 1 << 21;
+    array a = (randu(num) * 1000).as(s32);
+
+    int min_val, max_val;
+    unsigned min_idx, max_idx;
+    min<int>(&min_val, &min_idx, a);
+    max<int>(&max_val, &max_idx, a);
+
+    vector<int> ha(num);
+    a.host(&ha[0]);
+
+    unsigned gold_min_idx = 0, gold_max_idx = 0;
+    for (int i = 1; i < num; i++) {
+        if (ha[i] <= ha[gold_min_idx]) gold_min_idx = i;
+        if (ha[i] >  ha[gold_max_idx]) gold_max_idx = i;
+    }
+
+    ASSERT_EQ(gold_min_idx, min_idx);
+    ASSERT_EQ(gold_max_idx, max_idx);
+    ASSERT_EQ(ha[gold_min_idx], min_val);
+    ASSERT_EQ(ha[gold_max_idx], max_val);
+}
+
+TEST(IndexedReduce, LargeNaN)
+{
+    const int num = 1 << 20;
+    array a = randu(num);
+    a(seq(0, num / 2)) = af::NaN;
+
+    float max_val;
+    unsigned max_idx;
+    max<float>(&max_val, &max_idx, a);
+
+    vector<float> ha(num);
+    a.host(&ha[0]);
+
+    unsigned gold_idx = num / 2 + 1;
+    for (int i = gold_idx; i < num; i++) {
+        if (ha[i] > ha[gold_idx]) gold_idx = i;
+    }
+
+    ASSERT_EQ(gold_idx, max_idx);
+    ASSERT_EQ(ha[gold_idx], max_val);
+}
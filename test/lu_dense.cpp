@@ -175,6 +175,39 @@ void luTester(const int m, const int n, double eps)
 
 }
 
+// Factorizes a batch of matrices along dimension 2 at once
+template<typename T>
+void luBatchedTester(const int m, const int n, const int batch, double eps)
+{
+    if (noDoubleTests<T>()) return;
+    if (noLAPACKTests()) return;
+
+    array a_orig = cpu_randu<T>(dim4(m, n, batch));
+
+    array l, u, pivot;
+    lu(l, u, pivot, a_orig);
+    ASSERT_EQ(dim4(m, 1, batch), pivot.dims());
+
+    array a_recon = matmul(l, u);
+
+    array out = a_orig.copy();
+    array pivot2;
+    luInPlace(pivot2, out, false);
+
+    ASSERT_EQ(count<uint>(pivot == pivot2), pivot.elements());
+
+    // Every matrix is permuted by its own pivot
+    for (int i = 0; i < batch; i++) {
+        array a_slice = a_orig(span, span, i);
+        array p_slice = pivot(span, 0, i);
+        array a_perm  = a_slice(p_slice, span);
+        array diff    = a_recon(span, span, i) - a_perm;
+
+        ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(real(diff))), eps);
+        ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(imag(diff))), eps);
+    }
+}
+
 template<typename T>
 double eps();
 
@@ -230,3 +263,14 @@ TYPED_TEST(LU, RectangularLarge1) {
 TYPED_TEST(LU, RectangularMultipleOfTwoLarge1) {
     luTester<TypeParam>(512, 1024, eps<TypeParam>());
 }
+
+#if !defined(AF_CUDA)
+TYPED_TEST(LU, BatchedSmall) {
+    luBatchedTester<TypeParam>(8, 8, 40, eps<TypeParam>());
+}
+
+TYPED_TEST(LU, BatchedRectangular) {
+    luBatchedTester<TypeParam>(40, 30, 6, eps<TypeParam>());
+    luBatchedTester<TypeParam>(30, 40, 6, eps<TypeParam>());
+}
+#endif
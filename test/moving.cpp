@@ -0,0 +1,211 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <af/array.h>
+#include <af/arith.h>
+#include <af/data.h>
+#include <af/statistics.h>
+#include <testHelpers.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using std::vector;
+using af::array;
+using af::dim4;
+using af::dtype;
+using af::dtype_traits;
+using af::randu;
+
+template<typename T>
+class Moving : public ::testing::Test
+{
+};
+
+typedef ::testing::Types<float, double, int, uint, uchar, short, ushort> TestTypes;
+TYPED_TEST_CASE(Moving, TestTypes);
+
+template<typename T>
+array generateInput(const dim4 &dims)
+{
+    return (randu(dims, f32) * 200).as((dtype)dtype_traits<T>::af_type);
+}
+
+// Statistic stat of the window of len elements starting at ptr
+static double goldWindow(const double *ptr, const dim_t stride, const dim_t len,
+                         const af_stat_type stat, const bool sample)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double mn = std::numeric_limits<double>::infinity();
+    double mx = -mn;
+    double sum = 0;
+    dim_t valid = 0;
+    for (dim_t i = 0; i < len; i++) {
+        double val = ptr[i * stride];
+        sum += val;
+        if (val != val) continue;
+        mn = std::min(mn, val);
+        mx = std::max(mx, val);
+        valid++;
+    }
+
+    switch (stat) {
+    case AF_STAT_MIN:  return valid ? mn : nan;
+    case AF_STAT_MAX:  return valid ? mx : nan;
+    case AF_STAT_SUM:  return sum;
+    case AF_STAT_MEAN: return sum / len;
+    default: break;
+    }
+
+    double mean = sum / len, m2 = 0;
+    for (dim_t i = 0; i < len; i++) {
+        double val = ptr[i * stride];
+        m2 += (val - mean) * (val - mean);
+    }
+    const dim_t denom = sample ? len - 1 : len;
+    return denom > 0 ? m2 / denom : nan;
+}
+
+static array moving(const array &in, const af_stat_type stat, const dim_t window,
+                    const dim_t stride, const af_var_bias bias, const int dim)
+{
+    switch (stat) {
+    case AF_STAT_MIN:  return af::movingMin (in, window, stride, dim);
+    case AF_STAT_MAX:  return af::movingMax (in, window, stride, dim);
+    case AF_STAT_SUM:  return af::movingSum (in, window, stride, dim);
+    case AF_STAT_MEAN: return af::movingMean(in, window, stride, dim);
+    default:           return af::movingVar (in, window, stride, bias, dim);
+    }
+}
+
+static void movingTest(const array &in, const af_stat_type stat, const dim_t window,
+                       const dim_t stride, const int dim,
+                       const af_var_bias bias = AF_VARIANCE_POPULATION)
+{
+    const dim4 dims = in.dims();
+    array out = moving(in, stat, window, stride, bias, dim);
+
+    dim4 odims = dims;
+    odims[dim] = (dims[dim] - window) / stride + 1;
+    ASSERT_EQ(odims, out.dims());
+
+    vector<double> hin(in.elements()), hout(out.elements());
+    in.as(f64).host(hin.data());
+    out.as(f64).host(hout.data());
+
+    dim4 istrides(1, dims[0], dims[0] * dims[1], dims[0] * dims[1] * dims[2]);
+    dim4 ostrides(1, odims[0], odims[0] * odims[1], odims[0] * odims[1] * odims[2]);
+
+    for (dim_t l = 0; l < odims[3]; l++) {
+    for (dim_t k = 0; k < odims[2]; k++) {
+    for (dim_t j = 0; j < odims[1]; j++) {
+    for (dim_t i = 0; i < odims[0]; i++) {
+        dim_t idx[4] = {i, j, k, l};
+        dim_t ioff = i * istrides[0] + j * istrides[1] + k * istrides[2] + l * istrides[3];
+        dim_t ooff = i * ostrides[0] + j * ostrides[1] + k * ostrides[2] + l * ostrides[3];
+        ioff += idx[dim] * (stride - 1) * istrides[dim];
+
+        double gold = goldWindow(hin.data() + ioff, istrides[dim], window, stat,
+                                 bias == AF_VARIANCE_SAMPLE);
+        double val  = hout[ooff];
+        if (gold != gold) {
+            ASSERT_TRUE(val != val)
+                << "at " << i << "," << j << "," << k << "," << l;
+        } else {
+            ASSERT_NEAR(gold, val, 1e-4 * std::max(1.0, std::fabs(gold)))
+                << "at " << i << "," << j << "," << k << "," << l;
+        }
+    }
+    }
+    }
+    }
+}
+
+static const af_stat_type stats[] = {AF_STAT_SUM, AF_STAT_MEAN, AF_STAT_MIN,
+                                     AF_STAT_MAX, AF_STAT_VAR};
+
+template<typename T>
+static void movingTest(const dim4 &dims, const dim_t window, const dim_t stride,
+                       const int dim)
+{
+    if (noDoubleTests<T>()) return;
+    array in = generateInput<T>(dims);
+    for (int s = 0; s < 5; s++) {
+        movingTest(in, stats[s], window, stride, dim);
+    }
+}
+
+TYPED_TEST(Moving, Vector)
+{
+    movingTest<TypeParam>(dim4(1001), 17, 1, 0);
+}
+
+TYPED_TEST(Moving, Dim0)
+{
+    movingTest<TypeParam>(dim4(100, 7, 3), 10, 1, 0);
+}
+
+TYPED_TEST(Moving, Dim1)
+{
+    movingTest<TypeParam>(dim4(7, 100, 3), 10, 1, 1);
+}
+
+TYPED_TEST(Moving, Dim2Stride)
+{
+    movingTest<TypeParam>(dim4(5, 3, 64, 2), 8, 3, 2);
+}
+
+TYPED_TEST(Moving, Dim3Stride)
+{
+    movingTest<TypeParam>(dim4(5, 3, 2, 64), 8, 3, 3);
+}
+
+TYPED_TEST(Moving, DisjointWindows)
+{
+    movingTest<TypeParam>(dim4(300, 4), 7, 11, 0);
+}
+
+TYPED_TEST(Moving, FullWindow)
+{
+    movingTest<TypeParam>(dim4(50, 4), 50, 1, 0);
+}
+
+TEST(Moving, Long)
+{
+    // A single long series is split between threads
+    array in = 1e4 + randu(1 << 20, f64);
+    for (int s = 0; s < 5; s++) {
+        movingTest(in, stats[s], 1000, 1, 0);
+    }
+    movingTest(in, AF_STAT_VAR, 333, 7, 0, AF_VARIANCE_SAMPLE);
+}
+
+TEST(Moving, NaN)
+{
+    array in = randu(500, 40, f64);
+    in(randu(500, 40) < 0.05) = af::NaN;
+    in(af::seq(100, 120), af::span) = af::NaN;
+    for (int s = 0; s < 5; s++) {
+        movingTest(in, stats[s], 10, 2, 0);
+    }
+}
+
+TEST(Moving, InvalidArgs)
+{
+    array in = randu(100, 10);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_moving_sum(&out, in.get(), 0, 1, 0));
+    ASSERT_EQ(AF_ERR_ARG, af_moving_sum(&out, in.get(), 101, 1, 0));
+    ASSERT_EQ(AF_ERR_ARG, af_moving_sum(&out, in.get(), 10, 0, 0));
+    ASSERT_EQ(AF_ERR_ARG, af_moving_sum(&out, in.get(), 10, 1, 4));
+    ASSERT_EQ(AF_ERR_ARG, af_moving_var(&out, in.get(), 11, 1,
+                                        AF_VARIANCE_POPULATION, 1));
+}
@@ -138,6 +138,39 @@ void qrTester(const int m, const int n, double eps)
     }
 }
 
+// Factorizes a batch of matrices along dimension 2 at once
+template<typename T>
+void qrBatchedTester(const int m, const int n, const int batch, double eps)
+{
+    if (noDoubleTests<T>()) return;
+    if (noLAPACKTests()) return;
+
+    array in = cpu_randu<T>(dim4(m, n, batch));
+
+    array q, r, tau;
+    qr(q, r, tau, in);
+    ASSERT_EQ(dim4(m, m, batch), q.dims());
+    ASSERT_EQ(dim4(m, n, batch), r.dims());
+
+    array qq = matmul(q, q.H());
+    array ii = identity(qq.dims(), qq.type());
+
+    ASSERT_NEAR(0, max<double>(abs(real(qq - ii))), eps);
+    ASSERT_NEAR(0, max<double>(abs(imag(qq - ii))), eps);
+
+    array re = matmul(q, r);
+
+    ASSERT_NEAR(0, max<double>(abs(real(re - in))), eps);
+    ASSERT_NEAR(0, max<double>(abs(imag(re - in))), eps);
+
+    array out = in.copy();
+    array tau2;
+    qrInPlace(tau2, out);
+
+    ASSERT_NEAR(0, max<double>(abs(real(tau - tau2))), eps);
+    ASSERT_NEAR(0, max<double>(abs(imag(tau - tau2))), eps);
+}
+
 template<typename T>
 double eps();
 
@@ -184,3 +217,10 @@ TYPED_TEST(QR, RectangularLarge1) {
 TYPED_TEST(QR, RectangularMultipleOfTwoLarge1) {
     qrTester<TypeParam>(512, 1024, eps<TypeParam>());
 }
+
+#if !defined(AF_CUDA)
+TYPED_TEST(QR, BatchedRectangular) {
+    qrBatchedTester<TypeParam>(12, 8, 50, eps<TypeParam>());
+    qrBatchedTester<TypeParam>(8, 12, 50, eps<TypeParam>());
+}
+#endif
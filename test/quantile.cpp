@@ -0,0 +1,147 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <af/array.h>
+#include <af/arith.h>
+#include <af/data.h>
+#include <af/statistics.h>
+#include <testHelpers.hpp>
+
+#include <cmath>
+#include <vector>
+
+using std::vector;
+using af::array;
+using af::dim4;
+using af::dtype;
+using af::dtype_traits;
+using af::median;
+using af::quantile;
+using af::randu;
+using af::sort;
+
+template<typename T>
+class Quantile : public ::testing::Test
+{
+};
+
+typedef ::testing::Types<float, double, int, uint, uchar, short, ushort> TestTypes;
+TYPED_TEST_CASE(Quantile, TestTypes);
+
+template<typename T>
+array generateInput(const dim4 &dims)
+{
+    return (randu(dims, f32) * 200).as((dtype)dtype_traits<T>::af_type);
+}
+
+template<typename T>
+void quantileTest(const dim4 &dims, const int dim)
+{
+    if (noDoubleTests<T>()) return;
+    typedef typename af::dtype_traits<T>::base_type base;
+    typedef typename cond_type<std::is_same<base, double>::value,
+                               double, float>::type To;
+
+    const double probs[] = {0.0, 0.1, 0.25, 0.5, 0.75, 0.99, 1.0};
+    const int nprobs = sizeof(probs) / sizeof(probs[0]);
+
+    array in = generateInput<T>(dims);
+    array p(nprobs, probs);
+
+    array out = quantile(in, p, dim);
+
+    dim4 odims = dims;
+    odims[dim] = nprobs;
+    ASSERT_EQ(odims, out.dims());
+
+    // Reference computed from the sorted input
+    array sorted = sort(in, dim).as((dtype)dtype_traits<To>::af_type);
+    vector<To> hsorted(sorted.elements());
+    sorted.host(hsorted.data());
+    vector<To> hout(out.elements());
+    out.as((dtype)dtype_traits<To>::af_type).host(hout.data());
+
+    dim4 istrides(1, dims[0], dims[0] * dims[1], dims[0] * dims[1] * dims[2]);
+    dim4 ostrides(1, odims[0], odims[0] * odims[1], odims[0] * odims[1] * odims[2]);
+
+    const dim_t len = dims[dim];
+    for (dim_t l = 0; l < dims[3]; l++) {
+    for (dim_t k = 0; k < dims[2]; k++) {
+    for (dim_t j = 0; j < dims[1]; j++) {
+    for (dim_t i = 0; i < dims[0]; i++) {
+        dim_t idx[4] = {i, j, k, l};
+        if (idx[dim] != 0) continue;
+        dim_t ioff = i * istrides[0] + j * istrides[1] + k * istrides[2] + l * istrides[3];
+        dim_t ooff = i * ostrides[0] + j * ostrides[1] + k * ostrides[2] + l * ostrides[3];
+        for (int q = 0; q < nprobs; q++) {
+            double h  = (len - 1) * probs[q];
+            dim_t lo  = (dim_t)std::floor(h);
+            dim_t hi  = std::min(lo + 1, len - 1);
+            To vlo    = hsorted[ioff + lo * istrides[dim]];
+            To vhi    = hsorted[ioff + hi * istrides[dim]];
+            To gold   = vlo + (To)(h - lo) * (vhi - vlo);
+            ASSERT_NEAR(gold, hout[ooff + q * ostrides[dim]], 1e-3)
+                << "at slice " << i << "," << j << "," << k << "," << l
+                << " probability " << probs[q];
+        }
+    }
+    }
+    }
+    }
+}
+
+TYPED_TEST(Quantile, Vector)
+{
+    quantileTest<TypeParam>(dim4(1001), 0);
+}
+
+TYPED_TEST(Quantile, Dim0)
+{
+    quantileTest<TypeParam>(dim4(100, 7, 3), 0);
+}
+
+TYPED_TEST(Quantile, Dim1)
+{
+    quantileTest<TypeParam>(dim4(7, 100, 3), 1);
+}
+
+TYPED_TEST(Quantile, Dim2)
+{
+    quantileTest<TypeParam>(dim4(5, 3, 64, 2), 2);
+}
+
+TYPED_TEST(Quantile, Dim3)
+{
+    quantileTest<TypeParam>(dim4(5, 3, 2, 64), 3);
+}
+
+TEST(Quantile, MatchesMedian)
+{
+    array in = randu(1000, 10);
+    array p  = af::constant(0.5, 1);
+    ASSERT_NEAR(0, af::max<float>(af::abs(quantile(in, p) - median(in))), 1e-6);
+}
+
+TEST(Quantile, InvalidProbability)
+{
+    array in = randu(100);
+    const float probs[] = {0.5f, 1.5f};
+    array p(2, probs);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_quantile(&out, in.get(), p.get(), 0));
+}
+
+TEST(Quantile, IntegerProbabilities)
+{
+    array in = randu(100);
+    array p  = af::constant(0, 1, s32);
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_quantile(&out, in.get(), p.get(), 0));
+}
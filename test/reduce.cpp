@@ -731,3 +731,39 @@ TEST(Reduce, AllSmallIndexed)
     array b = a(seq(len/2), span);
     ASSERT_EQ(max<float>(b), len/2-1);
 }
+
+TEST(AnyAll, NaNExpression)
+{
+    const int num = 1 << 20;
+    array A = randu(num);
+    ASSERT_FALSE(anyTrue<bool>(isNaN(A)));
+    ASSERT_TRUE(allTrue<bool>(A >= 0));
+
+    array B = A.copy();
+    B(0) = NaN;
+    ASSERT_TRUE(anyTrue<bool>(isNaN(B)));
+    ASSERT_FALSE(allTrue<bool>(!isNaN(B)));
+
+    array C = A.copy();
+    C(num - 1) = NaN;
+    ASSERT_TRUE(anyTrue<bool>(isNaN(C)));
+    ASSERT_FALSE(allTrue<bool>(!isNaN(C)));
+    ASSERT_EQ(1u, count<unsigned>(isNaN(C)));
+}
+
+TEST(AnyAll, IndexedExpression)
+{
+    const int nrows = 1000;
+    const int ncols = 2000;
+    array A = constant(0, nrows, ncols);
+    A(nrows - 1, span) = 1;
+    A(seq(10, 20), 1000) = 2;
+
+    array B = A(seq(nrows - 1), span);
+    ASSERT_TRUE(anyTrue<bool>(B != 0));
+    ASSERT_FALSE(allTrue<bool>(B != 0));
+    ASSERT_EQ(11u, count<unsigned>(B));
+    ASSERT_EQ(11u, count<unsigned>(B + 0));
+    ASSERT_EQ(ncols + 11u, count<unsigned>(A));
+    ASSERT_FALSE(anyTrue<bool>(B(span, seq(1001, ncols - 1)) > 0));
+}
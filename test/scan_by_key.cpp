@@ -207,3 +207,31 @@ TEST(ScanByKey,Test_Scan_By_key_Simple_1)
     scanByKeyTest<int, int, AF_BINARY_ADD, false>(dims, scanDim, nodeLengths,
             keyStart, keyEnd, dataStart, dataEnd, 1e-5);
 }
+
+TEST(ScanByKey,Test_Scan_By_key_Long_Row_Inclusive)
+{
+    dim4 dims(1024*1024, 1, 1, 1);
+    int scanDim = 0;
+    int nodel[] = {37, 70000};
+    vector<int> nodeLengths(nodel, nodel+sizeof(nodel)/sizeof(int));
+    int keyStart = 0;
+    int keyEnd = 15;
+    int dataStart = -15;
+    int dataEnd = 15;
+    scanByKeyTest<int, int, AF_BINARY_ADD, true>(dims, scanDim, nodeLengths,
+            keyStart, keyEnd, dataStart, dataEnd, 1e-5);
+}
+
+TEST(ScanByKey,Test_Scan_By_key_Long_Row_Exclusive)
+{
+    dim4 dims(1024*1024, 1, 1, 1);
+    int scanDim = 0;
+    int nodel[] = {70000};
+    vector<int> nodeLengths(nodel, nodel+sizeof(nodel)/sizeof(int));
+    int keyStart = 0;
+    int keyEnd = 15;
+    int dataStart = -15;
+    int dataEnd = 15;
+    scanByKeyTest<int, int, AF_BINARY_MAX, false>(dims, scanDim, nodeLengths,
+            keyStart, keyEnd, dataStart, dataEnd, 1e-5);
+}
@@ -12,6 +12,7 @@
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
 #include <af/algorithm.h>
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <string>
@@ -313,3 +314,74 @@ TEST(Set, SNIPPET_setIntersectSimple) {
     dim4 gold_dim(1, 1, 1, 1);
     ASSERT_VEC_ARRAY_EQ(intersect_gold, gold_dim, setA_B);
 }
+
+TEST(Set, SNIPPET_isIn) {
+
+    //! [ex_set_isin]
+
+    // input data
+    int h_ids[6]     = {4, 8, 15, 16, 23, 42};
+    int h_allowed[3] = {42, 4, 16};
+    af::array ids(6, h_ids);
+    af::array allowed(3, h_allowed);
+
+    af::array mask = af::isIn(ids, allowed);
+    // mask == { 1, 0, 0, 1, 0, 1 };
+
+    af::array kept = ids(mask);
+    // kept == { 4, 16, 42 };
+
+    //! [ex_set_isin]
+
+    vector<char> mask_gold = { 1, 0, 0, 1, 0, 1 };
+    ASSERT_VEC_ARRAY_EQ(mask_gold, dim4(6), mask);
+
+    vector<int> kept_gold = { 4, 16, 42 };
+    ASSERT_VEC_ARRAY_EQ(kept_gold, dim4(3), kept);
+}
+
+TEST(Set, IsInLarge) {
+    const int num = 1 << 20;
+    af::array in  = (af::randu(num) * 1e6).as(s32);
+    af::array set = (af::randu(5000) * 1e6).as(s32);
+    af::array mask = af::isIn(in, set);
+
+    ASSERT_EQ(b8, mask.type());
+
+    vector<int> hin(num), hset(5000);
+    vector<char> hmask(num);
+    in.host(hin.data());
+    set.host(hset.data());
+    mask.host(hmask.data());
+
+    std::sort(hset.begin(), hset.end());
+    for (int i = 0; i < num; i++) {
+        bool gold = std::binary_search(hset.begin(), hset.end(), hin[i]);
+        ASSERT_EQ(gold, (bool)hmask[i]) << "at: " << i;
+    }
+}
+
+TEST(Set, IsInMatrix) {
+    float h_in[6] = {1.5f, -0.f, 2.f, 3.f, 1.5f, 7.f};
+    float h_set[2] = {0.f, 1.5f};
+    af::array in(3, 2, h_in);
+    af::array set(2, h_set);
+
+    af::array mask = af::isIn(in, set);
+
+    vector<char> gold = { 1, 1, 0, 0, 1, 0 };
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(3, 2), mask);
+}
+
+TEST(Set, UniqueUnsortedLarge) {
+    const int num = 1 << 20;
+    af::array in = (af::randu(num) * 1000.0 - 500.0).as(s64);
+    af::array out = af::setUnique(in);
+
+    vector<long long> hin(num);
+    in.host(hin.data());
+    std::sort(hin.begin(), hin.end());
+    hin.erase(std::unique(hin.begin(), hin.end()), hin.end());
+
+    ASSERT_VEC_ARRAY_EQ(hin, dim4(hin.size()), out);
+}
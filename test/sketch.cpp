@@ -0,0 +1,212 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <af/array.h>
+#include <af/algorithm.h>
+#include <af/arith.h>
+#include <af/data.h>
+#include <af/statistics.h>
+#include <testHelpers.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using std::vector;
+using af::array;
+using af::distinctSketch;
+using af::dim4;
+using af::dtype;
+using af::dtype_traits;
+using af::quantileSketch;
+using af::randu;
+
+template<typename T>
+class QuantileSketch : public ::testing::Test
+{
+};
+
+typedef ::testing::Types<float, double, int, uint, intl, short, ushort> TestTypes;
+TYPED_TEST_CASE(QuantileSketch, TestTypes);
+
+static const double probs[] = {0, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 1};
+static const unsigned nprobs = sizeof(probs) / sizeof(probs[0]);
+
+// Checks that the normalized rank of every quantile of the sketch is within
+// tol of the requested one
+static void checkRanks(const quantileSketch &sketch, vector<double> values,
+                       const double tol)
+{
+    std::sort(values.begin(), values.end());
+    const double n = values.size();
+    ASSERT_EQ(values.size(), sketch.count());
+
+    double out[nprobs];
+    sketch.quantiles(out, probs, nprobs);
+    ASSERT_EQ(values.front(), out[0]);
+    ASSERT_EQ(values.back(), out[nprobs - 1]);
+
+    for (unsigned i = 0; i < nprobs; i++) {
+        double lo = (std::lower_bound(values.begin(), values.end(), out[i]) - values.begin()) / n;
+        double hi = (std::upper_bound(values.begin(), values.end(), out[i]) - values.begin()) / n;
+        ASSERT_LE(lo - tol, probs[i]) << "for probability " << probs[i];
+        ASSERT_GE(hi + tol, probs[i]) << "for probability " << probs[i];
+    }
+}
+
+template<typename T>
+static array generateInput(const dim4 &dims)
+{
+    return (randu(dims, f32) * 30000).as((dtype)dtype_traits<T>::af_type);
+}
+
+TYPED_TEST(QuantileSketch, Small)
+{
+    if (noDoubleTests<TypeParam>()) return;
+    array in = generateInput<TypeParam>(dim4(100));
+    quantileSketch sketch;
+    sketch.update(in);
+
+    // Fewer values than the capacity of the sketch are kept exactly
+    vector<double> values(in.elements());
+    in.as(f64).host(values.data());
+    checkRanks(sketch, values, 1e-9);
+}
+
+TYPED_TEST(QuantileSketch, Chunks)
+{
+    if (noDoubleTests<TypeParam>()) return;
+    array in = generateInput<TypeParam>(dim4(1 << 16, 16));
+    quantileSketch sketch;
+    for (int i = 0; i < 16; i++) sketch.update(in.col(i));
+
+    vector<double> values(in.elements());
+    in.as(f64).host(values.data());
+    checkRanks(sketch, values, 0.02);
+}
+
+TEST(QuantileSketch, Merge)
+{
+    array a = randu(1 << 20, f64);
+    array b = randu(1 << 18, f64) * 2 + 1;
+    quantileSketch sa(400), sb(400);
+    sa.update(a);
+    sb.update(b);
+    sa.merge(sb);
+
+    vector<double> values(a.elements() + b.elements());
+    a.host(values.data());
+    b.host(values.data() + a.elements());
+    checkRanks(sa, values, 0.01);
+}
+
+TEST(QuantileSketch, Copy)
+{
+    quantileSketch a;
+    a.update(randu(1000));
+    quantileSketch b(a);
+    b.update(randu(1000));
+    ASSERT_EQ(1000u, a.count());
+    ASSERT_EQ(2000u, b.count());
+    a = b;
+    ASSERT_EQ(2000u, a.count());
+}
+
+TEST(QuantileSketch, NaN)
+{
+    array in = randu(10000, f64);
+    in(randu(10000) < 0.1) = af::NaN;
+    quantileSketch sketch;
+    sketch.update(in);
+
+    array valid = in(!af::isNaN(in));
+    vector<double> values(valid.elements());
+    valid.host(values.data());
+    checkRanks(sketch, values, 0.02);
+}
+
+TEST(QuantileSketch, Empty)
+{
+    quantileSketch sketch;
+    ASSERT_EQ(0u, sketch.count());
+    ASSERT_TRUE(std::isnan(sketch.quantile(0.5)));
+}
+
+TEST(QuantileSketch, InvalidArgs)
+{
+    af_quantile_sketch sketch = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_create_quantile_sketch(&sketch, 1));
+    ASSERT_EQ(AF_SUCCESS, af_create_quantile_sketch(&sketch, 200));
+
+    double prob = 1.5, out;
+    ASSERT_EQ(AF_ERR_ARG, af_quantile_sketch_get_quantiles(&out, sketch, &prob, 1));
+
+    array in = randu(10, c32);
+    ASSERT_EQ(AF_ERR_TYPE, af_quantile_sketch_update(sketch, in.get()));
+    ASSERT_EQ(AF_SUCCESS, af_release_quantile_sketch(sketch));
+    ASSERT_EQ(AF_ERR_ARG, af_quantile_sketch_update(0, in.get()));
+}
+
+template<typename T>
+class DistinctSketch : public ::testing::Test
+{
+};
+
+TYPED_TEST_CASE(DistinctSketch, TestTypes);
+
+TYPED_TEST(DistinctSketch, Count)
+{
+    if (noDoubleTests<TypeParam>()) return;
+    array in = generateInput<TypeParam>(dim4(1 << 16, 4));
+    const double gold = af::setUnique(af::flat(in)).elements();
+
+    distinctSketch sketch;
+    sketch.update(in);
+    // Five standard errors
+    ASSERT_NEAR(gold, sketch.estimate(), 0.04 * gold);
+}
+
+TEST(DistinctSketch, Small)
+{
+    distinctSketch sketch;
+    sketch.update(af::range(dim4(100, 3), 0, s32));
+    ASSERT_NEAR(100, sketch.estimate(), 1);
+}
+
+TEST(DistinctSketch, Merge)
+{
+    // Values inserted in different sketches and types are counted once
+    distinctSketch a, b;
+    a.update(af::range(dim4(200000), 0, s32));
+    b.update(af::range(dim4(200000), 0, f64) + 100000);
+    a.merge(b);
+    ASSERT_NEAR(300000, a.estimate(), 0.04 * 300000);
+}
+
+TEST(DistinctSketch, NaN)
+{
+    array in = af::range(dim4(1000), 0, f32);
+    in(af::seq(0, 99)) = af::NaN;
+    distinctSketch sketch;
+    sketch.update(in);
+    ASSERT_NEAR(900, sketch.estimate(), 36);
+}
+
+TEST(DistinctSketch, InvalidArgs)
+{
+    af_distinct_sketch a = 0, b = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_create_distinct_sketch(&a, 3));
+    ASSERT_EQ(AF_ERR_ARG, af_create_distinct_sketch(&a, 19));
+    ASSERT_EQ(AF_SUCCESS, af_create_distinct_sketch(&a, 10));
+    ASSERT_EQ(AF_SUCCESS, af_create_distinct_sketch(&b, 12));
+    ASSERT_EQ(AF_ERR_ARG, af_distinct_sketch_merge(a, b));
+    ASSERT_EQ(AF_SUCCESS, af_release_distinct_sketch(a));
+    ASSERT_EQ(AF_SUCCESS, af_release_distinct_sketch(b));
+}
@@ -60,6 +60,36 @@ void solveTester(const int m, const int n, const int k, double eps, int targetDe
     ASSERT_NEAR(0, af::sum<typename af::dtype_traits<T>::base_type>(af::abs(imag(B0 - B1))) / (m * k), eps);
 }
 
+// Solves a batch of systems along dimension 2 at once
+template<typename T>
+void solveBatchedTester(const int m, const int n, const int k, const int batch, double eps)
+{
+    if (noDoubleTests<T>()) return;
+    if (noLAPACKTests()) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    af::array A  = cpu_randu<T>(af::dim4(m, n, batch));
+    af::array X0 = cpu_randu<T>(af::dim4(n, k, batch));
+    // Keep the many small square systems well conditioned
+    if (m == n) A += n * af::identity(af::dim4(n, n, batch), ty);
+    af::array B0 = af::matmul(A, X0);
+
+    af::array X1 = af::solve(A, B0);
+    ASSERT_EQ(af::dim4(n, k, batch), X1.dims());
+
+    af::array B1 = af::matmul(A, X1);
+
+    ASSERT_NEAR(0, af::sum<typename af::dtype_traits<T>::base_type>(af::abs(real(B0 - B1))) / (m * k * batch), eps);
+    ASSERT_NEAR(0, af::sum<typename af::dtype_traits<T>::base_type>(af::abs(imag(B0 - B1))) / (m * k * batch), eps);
+
+    // Every system of the batch is solved as it would be on its own
+    af::array X2 = af::solve(A(af::span, af::span, batch - 1), B0(af::span, af::span, batch - 1));
+    af::array B2 = af::matmul(A(af::span, af::span, batch - 1), X2);
+    af::array B3 = B1(af::span, af::span, batch - 1);
+    ASSERT_NEAR(0, af::sum<typename af::dtype_traits<T>::base_type>(af::abs(real(B2 - B3))) / (m * k), eps);
+    ASSERT_NEAR(0, af::sum<typename af::dtype_traits<T>::base_type>(af::abs(imag(B2 - B3))) / (m * k), eps);
+}
+
 template<typename T>
 void solveLUTester(const int n, const int k, double eps, int targetDevice=-1)
 {
@@ -144,6 +144,86 @@ TYPED_TEST(Solve, TriangleLowerMultipleOfTwoLarge) {
     solveTriangleTester<TypeParam>(2048, 512, false, eps<TypeParam>());
 }
 
+#if !defined(AF_CUDA)
+TYPED_TEST(Solve, BatchedSmall) {
+    solveBatchedTester<TypeParam>(6, 6, 2, 1000, eps<TypeParam>());
+}
+
+TYPED_TEST(Solve, BatchedSquare) {
+    solveBatchedTester<TypeParam>(64, 64, 8, 12, eps<TypeParam>());
+}
+
+TYPED_TEST(Solve, BatchedLeastSquares) {
+    solveBatchedTester<TypeParam>(40, 30, 4, 10, eps<TypeParam>());
+    solveBatchedTester<TypeParam>(30, 40, 4, 10, eps<TypeParam>());
+}
+#endif
+
+// Solves with AF_MAT_MIXED_PRECISION a system with singular values spread
+// evenly, on a log scale, between 1 and 1/cond. The relative residual has to
+// match a double precision solve even when the single precision factorization
+// is too inaccurate to refine.
+template<typename T>
+static void solveMixedTester(const int n, const int k, const double cond)
+{
+    if (noDoubleTests<T>()) return;
+    if (noLAPACKTests()) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    af::array q, r;
+    af::array tau;
+    af::qr(q, r, tau, af::randu(n, n, ty));
+
+    af::array s = af::pow(cond, -af::range(n, 1, 1, 1, 0, f64) / (n - 1)).as(ty);
+    af::array A = af::matmul(q * af::tile(s.T(), n), q, AF_MAT_NONE, AF_MAT_CTRANS);
+    af::array B = af::randu(n, k, ty);
+
+    af::array X = af::solve(A, B, AF_MAT_MIXED_PRECISION);
+    af::array R = af::matmul(A, X) - B;
+    double res = af::norm(R) / (af::norm(A) * af::norm(X));
+    ASSERT_LT(res, 1e-13);
+}
+
+TEST(Solve, MixedPrecision) {
+    solveMixedTester<double>(300, 20, 10);
+    solveMixedTester<cdouble>(300, 20, 10);
+}
+
+TEST(Solve, MixedPrecisionIllConditioned) {
+    solveMixedTester<double>(300, 20, 1e10);
+    solveMixedTester<cdouble>(300, 20, 1e10);
+}
+
+#if defined(AF_CPU)
+TEST(Solve, MixedPrecisionSingular) {
+    if (noDoubleTests<double>()) return;
+    if (noLAPACKTests()) return;
+
+    // A zero column makes the system exactly singular
+    af::array A = af::randu(200, 200, f64);
+    A(af::span, 17) = 0;
+    af::array B = af::randu(200, 3, f64);
+
+    af::array X = af::solve(A, B, AF_MAT_MIXED_PRECISION);
+    ASSERT_TRUE(af::allTrue<bool>(af::isNaN(X)));
+}
+#endif
+
+TEST(Solve, Singular) {
+    if (noLAPACKTests()) return;
+
+    // Orders solved by the small system kernels and by gesv on the CPU
+    const int orders[] = {4, 40};
+    for (int n : orders) {
+        af::array A = af::randu(n, n);
+        A(af::span, 1) = 0;
+        af::array B = af::randu(n, 3);
+
+        af::array X = af::solve(A, B);
+        ASSERT_TRUE(af::allTrue<bool>(af::isNaN(X))) << "for order " << n;
+    }
+}
+
 #if !defined(AF_OPENCL)
 int nextTargetDeviceId()
 {
@@ -14,7 +14,9 @@
 #include <af/traits.hpp>
 #include <vector>
 #include <iostream>
+#include <algorithm>
 #include <complex>
+#include <functional>
 #include <string>
 #include <testHelpers.hpp>
 
@@ -221,3 +223,52 @@ TEST(Sort, CPPDim2)
     // Delete
     delete[] sxData;
 }
+
+TEST(Sort, LargeColumns)
+{
+    const int nrows = 100000;
+    const int ncols = 3;
+    array A = af::randu(nrows, ncols) * 2000.0 - 1000.0;
+    array B = A.as(s64) * 1000000;
+
+    array sA = sort(A, 0, true);
+    array sB = sort(B, 0, true);
+    array dA = sort(A, 0, false);
+
+    vector<float> hA(nrows * ncols), hsA(nrows * ncols), hdA(nrows * ncols);
+    vector<long long> hB(nrows * ncols), hsB(nrows * ncols);
+    A.host(hA.data());
+    B.host(hB.data());
+    sA.host(hsA.data());
+    sB.host(hsB.data());
+    dA.host(hdA.data());
+
+    for (int c = 0; c < ncols; c++) {
+        std::sort(hA.begin() + c * nrows, hA.begin() + (c + 1) * nrows);
+        std::sort(hB.begin() + c * nrows, hB.begin() + (c + 1) * nrows);
+    }
+
+    for (int i = 0; i < nrows * ncols; i++) {
+        ASSERT_EQ(hA[i], hsA[i]) << "at: " << i;
+        ASSERT_EQ(hB[i], hsB[i]) << "at: " << i;
+        int c = i / nrows;
+        int r = i % nrows;
+        ASSERT_EQ(hA[c * nrows + nrows - 1 - r], hdA[i]) << "at: " << i;
+    }
+}
+
+TEST(Sort, LargeColumnDescending)
+{
+    const int num = 300000;
+    array A = af::randu(num) * 100.0 - 50.0;
+    array B = sort(A, 0, false);
+
+    vector<float> hA(num), hB(num);
+    A.host(hA.data());
+    B.host(hB.data());
+    std::sort(hA.begin(), hA.end(), std::greater<float>());
+
+    for (int i = 0; i < num; i++) {
+        ASSERT_EQ(hA[i], hB[i]) << "at: " << i;
+    }
+}
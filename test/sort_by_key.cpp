@@ -197,3 +197,59 @@ TEST(SortByKey, CPPDim2)
     ASSERT_VEC_ARRAY_EQ(tests[resultIdx0], idims, out_keys);
     ASSERT_VEC_ARRAY_EQ(tests[resultIdx1], idims, out_vals);
 }
+
+TEST(SortByKey, LargeColumnStable)
+{
+    const int num = 100000;
+    array keys = (af::randu(num) * 1000.0).as(s32);
+    array vals = af::range(dim4(num), 0, f64);
+
+    array okeys, ovals;
+    sort(okeys, ovals, keys, vals, 0, true);
+
+    vector<int> hkeys(num), hokeys(num);
+    vector<double> hovals(num);
+    keys.host(hkeys.data());
+    okeys.host(hokeys.data());
+    ovals.host(hovals.data());
+
+    for (int i = 0; i < num; i++) {
+        int idx = (int)hovals[i];
+        ASSERT_EQ(hkeys[idx], hokeys[i]) << "at: " << i;
+        if (i == 0) continue;
+        ASSERT_LE(hokeys[i - 1], hokeys[i]) << "at: " << i;
+        if (hokeys[i - 1] == hokeys[i]) ASSERT_LT(hovals[i - 1], hovals[i]) << "at: " << i;
+    }
+}
+
+TEST(SortByKey, ManyColumnsDescending)
+{
+    const int nrows = 500;
+    const int ncols = 64;
+    array keys = (af::randu(nrows, ncols) * 20.0).as(s32);
+    array vals = af::complex(af::range(dim4(nrows, ncols), 0, f64),
+                             af::range(dim4(nrows, ncols), 1, f64));
+
+    array okeys, ovals;
+    sort(okeys, ovals, keys, vals, 0, false);
+
+    vector<int> hkeys(nrows * ncols), hokeys(nrows * ncols);
+    vector<cdouble> hovals(nrows * ncols);
+    keys.host(hkeys.data());
+    okeys.host(hokeys.data());
+    ovals.host(hovals.data());
+
+    for (int c = 0; c < ncols; c++) {
+        for (int r = 0; r < nrows; r++) {
+            int i = c * nrows + r;
+            int row = (int)hovals[i].real;
+            ASSERT_EQ(c, (int)hovals[i].imag) << "at: " << i;
+            ASSERT_EQ(hkeys[c * nrows + row], hokeys[i]) << "at: " << i;
+            if (r == 0) continue;
+            ASSERT_GE(hokeys[i - 1], hokeys[i]) << "at: " << i;
+            if (hokeys[i - 1] == hokeys[i]) {
+                ASSERT_LT(hovals[i - 1].real, hovals[i].real) << "at: " << i;
+            }
+        }
+    }
+}
@@ -196,3 +196,48 @@ TEST(SortIndex, CPPDim2)
     vector<unsigned> ixTest(tests[resultIdx1].begin(), tests[resultIdx1].end());
     ASSERT_VEC_ARRAY_EQ(ixTest, idims, outIndices);
 }
+
+TEST(SortIndex, LargeColumnStable)
+{
+    const int num = 100000;
+    array A = floor(af::randu(num) * 100.0 - 50.0);
+
+    array sA, idx;
+    sort(sA, idx, A, 0, true);
+
+    vector<float> hA(num), hsA(num);
+    vector<unsigned> hidx(num);
+    A.host(hA.data());
+    sA.host(hsA.data());
+    idx.host(hidx.data());
+
+    for (int i = 0; i < num; i++) {
+        ASSERT_EQ(hA[hidx[i]], hsA[i]) << "at: " << i;
+        if (i == 0) continue;
+        ASSERT_LE(hsA[i - 1], hsA[i]) << "at: " << i;
+        // Equal keys keep their original order
+        if (hsA[i - 1] == hsA[i]) ASSERT_LT(hidx[i - 1], hidx[i]) << "at: " << i;
+    }
+}
+
+TEST(SortIndex, LargeColumnDescendingStable)
+{
+    const int num = 300000;
+    array A = floor(af::randu(num) * 1000.0);
+
+    array sA, idx;
+    sort(sA, idx, A, 0, false);
+
+    vector<float> hA(num), hsA(num);
+    vector<unsigned> hidx(num);
+    A.host(hA.data());
+    sA.host(hsA.data());
+    idx.host(hidx.data());
+
+    for (int i = 0; i < num; i++) {
+        ASSERT_EQ(hA[hidx[i]], hsA[i]) << "at: " << i;
+        if (i == 0) continue;
+        ASSERT_GE(hsA[i - 1], hsA[i]) << "at: " << i;
+        if (hsA[i - 1] == hsA[i]) ASSERT_LT(hidx[i - 1], hidx[i]) << "at: " << i;
+    }
+}
@@ -40,6 +40,14 @@ using af::span;
     {                                                       \
         sparseTransposeTester<T>(625, 1331, 1, 2, eps);     \
     }                                                       \
+    TEST(Sparse, T##LongMatVec)                             \
+    {                                                       \
+        sparseTester<T>(3000, 2500, 1, 2, eps);             \
+    }                                                       \
+    TEST(Sparse, Transpose_##T##LongMatVec)                 \
+    {                                                       \
+        sparseTransposeTester<T>(3000, 2500, 1, 2, eps);    \
+    }                                                       \
     TEST(Sparse, Transpose_##T##Square)                     \
     {                                                       \
         sparseTransposeTester<T>(1000, 1000, 100, 5, eps);  \
@@ -113,6 +121,41 @@ CAST_TESTS(cdouble, cdouble )
 
 
 
+#if defined(AF_CPU)
+#define SPARSE_SPARSE_TESTS(T, eps)                         \
+    TEST(Sparse, SparseSparse_##T##Square)                  \
+    {                                                       \
+        sparseSparseTester<T>(500, 500, 500, 5, eps);       \
+    }                                                       \
+    TEST(Sparse, SparseSparse_##T##Rect)                    \
+    {                                                       \
+        sparseSparseTester<T>(300, 700, 200, 2, eps);       \
+    }                                                       \
+    TEST(Sparse, SparseSparse_##T##VerySparse)              \
+    {                                                       \
+        sparseSparseTester<T>(1000, 800, 1200, 100, eps);   \
+    }                                                       \
+
+SPARSE_SPARSE_TESTS(float, 1E-3)
+SPARSE_SPARSE_TESTS(double, 1E-5)
+SPARSE_SPARSE_TESTS(cfloat, 1E-3)
+SPARSE_SPARSE_TESTS(cdouble, 1E-5)
+
+#undef SPARSE_SPARSE_TESTS
+
+TEST(Sparse, SparseSparse_InvalidArgs)
+{
+    array sA = af::sparse(makeSparse<float>(randu(10, 10), 2), AF_STORAGE_CSR);
+    array sB = af::sparse(makeSparse<float>(randu(20, 10), 2), AF_STORAGE_CSR);
+    array sC = af::sparse(makeSparse<float>(randu(10, 10), 2), AF_STORAGE_COO);
+
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_SIZE, af_matmul(&out, sA.get(), sB.get(), AF_MAT_NONE, AF_MAT_NONE));
+    ASSERT_EQ(AF_ERR_ARG, af_matmul(&out, sA.get(), sC.get(), AF_MAT_NONE, AF_MAT_NONE));
+    ASSERT_EQ(AF_ERR_NOT_SUPPORTED, af_matmul(&out, sA.get(), sA.get(), AF_MAT_TRANS, AF_MAT_NONE));
+}
+#endif
+
 TEST(Sparse, ISSUE_1745)
 {
   using af::where;
@@ -102,6 +102,35 @@ void sparseTester(const int m, const int n, const int k, int factor, double eps,
     ASSERT_NEAR(0, calc_norm(imag(dRes1), imag(sRes1)), eps);
 }
 
+template<typename T> static
+void sparseSparseTester(const int m, const int n, const int k, int factor, double eps)
+{
+    if (noDoubleTests<T>()) return;
+
+    af::array A = makeSparse<T>(cpu_randu<T>(af::dim4(m, n)), factor);
+    af::array B = makeSparse<T>(cpu_randu<T>(af::dim4(n, k)), factor);
+
+    af::array dRes = matmul(A, B);
+
+    af::array sRes = matmul(af::sparse(A, AF_STORAGE_CSR), af::sparse(B, AF_STORAGE_CSR));
+    ASSERT_TRUE(sRes.issparse());
+    ASSERT_EQ(AF_STORAGE_CSR, af::sparseGetStorage(sRes));
+
+    af::array sDense = af::dense(sRes);
+    ASSERT_NEAR(0, calc_norm(real(dRes), real(sDense)), eps);
+    ASSERT_NEAR(0, calc_norm(imag(dRes), imag(sDense)), eps);
+
+    // Columns are sorted within every row
+    vector<int> rowIdx(m + 1), colIdx(af::sparseGetNNZ(sRes));
+    af::sparseGetRowIdx(sRes).host(rowIdx.data());
+    if (!colIdx.empty()) af::sparseGetColIdx(sRes).host(colIdx.data());
+    for (int r = 0; r < m; r++) {
+        for (int j = rowIdx[r] + 1; j < rowIdx[r + 1]; j++) {
+            ASSERT_LT(colIdx[j - 1], colIdx[j]) << "in row " << r;
+        }
+    }
+}
+
 template<typename T> static
 void sparseTransposeTester(const int m, const int n, const int k, int factor, double eps,
                            int targetDevice=-1)
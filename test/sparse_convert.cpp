@@ -128,6 +128,7 @@ void sparseConvertTester(const int m, const int n, int factor)
     CONVERT_TESTS_TYPES(T, STYPE, DTYPE, 3,  512, 1024,  2)                     \
     CONVERT_TESTS_TYPES(T, STYPE, DTYPE, 4, 2048, 1024, 10)                     \
     CONVERT_TESTS_TYPES(T, STYPE, DTYPE, 5,  237, 411,   5)                     \
+    CONVERT_TESTS_TYPES(T, STYPE, DTYPE, 6, 3000, 2000,  2)                     \
 
 CONVERT_TESTS(float  , AF_STORAGE_CSR, AF_STORAGE_COO)
 CONVERT_TESTS(double , AF_STORAGE_CSR, AF_STORAGE_COO)
@@ -183,6 +183,18 @@ TYPED_TEST(TopK, MIN4D0)
   topkTest<TypeParam>(2, dims, 5, 0, AF_TOPK_MIN);
 }
 
+TYPED_TEST(TopK, Max1D0_LargeK)
+{
+    dim_t dims[4] = {1000000, 1, 1, 1};
+    topkTest<TypeParam>(1, dims, 100, 0, AF_TOPK_MAX);
+}
+
+TYPED_TEST(TopK, MIN2D0_LargeK)
+{
+    dim_t dims[4] = {500000, 3, 1, 1};
+    topkTest<TypeParam>(2, dims, 256, 0, AF_TOPK_MIN);
+}
+
 TEST(TopK, ValidationCheck_DimN)
 {
     dim_t dims[4] = {10, 10, 1, 1};
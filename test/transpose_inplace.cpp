@@ -38,7 +38,7 @@ typedef ::testing::Types<float, cfloat, double, cdouble, int, uint, char, uchar,
 TYPED_TEST_CASE(Transpose, TestTypes);
 
 template<typename T>
-void transposeip_test(dim4 dims)
+void transposeip_test(dim4 dims, bool conjugate = false)
 {
     if (noDoubleTests<T>())
         return;
@@ -48,8 +48,8 @@ void transposeip_test(dim4 dims)
 
     ASSERT_SUCCESS(af_randu(&inArray, dims.ndims(), dims.get(), (af_dtype) dtype_traits<T>::af_type));
 
-    ASSERT_SUCCESS(af_transpose(&outArray, inArray, false));
-    ASSERT_SUCCESS(af_transpose_inplace(inArray, false));
+    ASSERT_SUCCESS(af_transpose(&outArray, inArray, conjugate));
+    ASSERT_SUCCESS(af_transpose_inplace(inArray, conjugate));
 
     ASSERT_ARRAYS_EQ(inArray, outArray);
 
@@ -71,6 +71,38 @@ INIT_TEST(1000, 1, 1);
 INIT_TEST(100, 2, 1);
 INIT_TEST(25, 2, 2);
 
+#define INIT_RECT_TEST(D1, D2, D3, D4)                                              \
+    TYPED_TEST(Transpose, TranposeIP_##D1##x##D2##x##D3##x##D4)                     \
+    {                                                                               \
+        transposeip_test<TypeParam>(dim4(D1, D2, D3, D4));                          \
+    }
+
+INIT_RECT_TEST(10, 3, 1, 1);
+INIT_RECT_TEST(1, 100, 1, 1);
+INIT_RECT_TEST(100, 1, 1, 1);
+INIT_RECT_TEST(300, 64, 1, 1);
+INIT_RECT_TEST(33, 1000, 1, 1);
+INIT_RECT_TEST(17, 40, 3, 2);
+INIT_RECT_TEST(1500, 777, 2, 1);
+
+TYPED_TEST(Transpose, TranposeIP_Conjugate)
+{
+    transposeip_test<TypeParam>(dim4(100, 100, 2, 1), true);
+    transposeip_test<TypeParam>(dim4(70, 45, 2, 1), true);
+    transposeip_test<TypeParam>(dim4(1500, 777, 1, 1), true);
+}
+
+TEST(Transpose, TranposeIP_RectangularView)
+{
+    // A sub-array is not contiguous and is replaced by a transposed copy
+    array in = af::randu(100, 80);
+    array view = in(af::seq(10, 59), af::seq(20));
+    array gold = transpose(view);
+    transposeInPlace(view);
+    ASSERT_EQ(dim4(20, 50), view.dims());
+    ASSERT_ARRAYS_EQ(gold, view);
+}
+
 ////////////////////////////////////// CPP //////////////////////////////////
 //
 void transposeInPlaceCPPTest()
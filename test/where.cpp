@@ -132,3 +132,69 @@ TEST(Where, ISSUE_1259)
     array indices = where(a > 2);
     ASSERT_EQ(indices.elements(), 0);
 }
+
+TEST(Where, LargeEvaluated)
+{
+    const int nrows = 1000;
+    const int ncols = 1200;
+    array A = randu(nrows, ncols) > 0.9;
+    A.eval();
+    array B = A(af::seq(10, nrows - 11), af::span);
+
+    array idxA = where(A);
+    array idxB = where(B);
+
+    vector<char> hA(nrows * ncols);
+    A.host(hA.data());
+
+    vector<uint> goldA, goldB;
+    const int brows = nrows - 20;
+    for (int c = 0; c < ncols; c++) {
+        for (int r = 0; r < nrows; r++) {
+            if (!hA[c * nrows + r]) continue;
+            goldA.push_back(c * nrows + r);
+            if (r >= 10 && r < nrows - 10) goldB.push_back(c * brows + r - 10);
+        }
+    }
+
+    ASSERT_VEC_ARRAY_EQ(goldA, dim4(goldA.size()), idxA);
+    ASSERT_VEC_ARRAY_EQ(goldB, dim4(goldB.size()), idxB);
+}
+
+TEST(Where, IndexedExpression)
+{
+    const int nrows = 300;
+    const int ncols = 400;
+    array A = randu(nrows, ncols);
+    array idx = where(A(af::seq(5, nrows - 1), af::span) > 0.75f);
+
+    vector<float> hA(nrows * ncols);
+    A.host(hA.data());
+
+    vector<uint> gold;
+    const int brows = nrows - 5;
+    for (int c = 0; c < ncols; c++) {
+        for (int r = 5; r < nrows; r++) {
+            if (hA[c * nrows + r] > 0.75f) gold.push_back(c * brows + r - 5);
+        }
+    }
+
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(gold.size()), idx);
+}
+
+TEST(Where, LargeExpression)
+{
+    const int num = 1 << 20;
+    array A = randu(num);
+    array idx = where(A > 0.5f);
+
+    vector<float> hA(num);
+    A.host(hA.data());
+
+    vector<uint> gold;
+    for (int i = 0; i < num; i++) {
+        if (hA[i] > 0.5f) gold.push_back(i);
+    }
+
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(gold.size()), idx);
+}